@@ -0,0 +1,82 @@
+"""Compare ternary (1.58-bit) GEMV on CPU: the table lookup kernel against
+fp32 and int8 weights and against ternary weights decoded for the int8
+dot-product kernels.
+"""
+import argparse
+
+import tilelang
+import tilelang.language as T
+from tilelang.carver.template.kernel_utils import bench_cpu
+from tilelang.quantize import ternary_decoder
+
+
+def gemv(M, N, K, block_N, block_K, in_dtype, accum_dtype):
+
+    @T.prim_func
+    def main(
+            A: T.Tensor((M, K), in_dtype),
+            B: T.Tensor((N, K), in_dtype),
+            C: T.Tensor((M, N), accum_dtype),
+    ):
+        with T.Kernel(T.ceildiv(N, block_N), is_cpu=True, parallel=True) as bx:
+            A_local = T.alloc_local((M, block_K), in_dtype)
+            B_local = T.alloc_local((block_N, block_K), in_dtype)
+            C_local = T.alloc_local((M, block_N), accum_dtype)
+            T.clear(C_local)
+            for ko in T.Pipelined(T.ceildiv(K, block_K), num_stages=0):
+                T.copy(A[0, ko * block_K], A_local)
+                T.copy(B[bx * block_N, ko * block_K], B_local)
+                T.gemm(A_local, B_local, C_local, transpose_B=True)
+            T.copy(C_local, C[0, bx * block_N])
+
+    return main
+
+
+def ternary_gemv(M, N, K, block_N, block_K, lut):
+    decoder = ternary_decoder(lut=lut)
+    B_shape = (N // 32, K // 2, 16) if lut else (N, K // 4)
+
+    def weight_tile(B, bx, ko):
+        if lut:
+            return B[bx * block_N // 32, ko * block_K // 2, 0]
+        return B[bx * block_N, ko * block_K // 4]
+
+    @T.prim_func
+    def main(
+            A: T.Tensor((M, K), "int8"),
+            B: T.Tensor(B_shape, "int8"),
+            C: T.Tensor((M, N), "int32"),
+    ):
+        with T.Kernel(T.ceildiv(N, block_N), is_cpu=True, parallel=True) as bx:
+            A_local = T.alloc_local((M, block_K), "int8")
+            C_local = T.alloc_local((M, block_N), "int32")
+            T.clear(C_local)
+            for ko in T.Pipelined(T.ceildiv(K, block_K), num_stages=0):
+                T.copy(A[0, ko * block_K], A_local)
+                T.gemm_dequant(A_local, weight_tile(B, bx, ko), C_local, decoder)
+            T.copy(C_local, C[0, bx * block_N])
+
+    return main
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="CPU ternary GEMV benchmark")
+    parser.add_argument("--m", type=int, default=1)
+    parser.add_argument("--n", type=int, default=4096)
+    parser.add_argument("--k", type=int, default=4096)
+    parser.add_argument("--block", type=int, nargs=2, default=[256, 1024])
+    args = parser.parse_args()
+
+    tilelang.disable_cache()
+    M, N, K = args.m, args.n, args.k
+    block_N, block_K = args.block
+
+    def run(label, func):
+        kernel = tilelang.compile(func, target="c", execution_backend="ctypes")
+        latency = bench_cpu(kernel)
+        print(f"{label:>16}: {latency:8.3f} ms  {2 * M * N * K / latency * 1e-9:8.2f} TOPS")
+
+    run("float32", gemv(M, N, K, block_N, block_K, "float32", "float32"))
+    run("int8", gemv(M, N, K, block_N, block_K, "int8", "int32"))
+    run("ternary decode", ternary_gemv(M, N, K, block_N, block_K, lut=False))
+    run("ternary lut", ternary_gemv(M, N, K, block_N, block_K, lut=True))
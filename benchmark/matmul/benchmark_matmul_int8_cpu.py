@@ -0,0 +1,62 @@
+"""Compare the int8 dot-product CPU gemm micro-kernels against the fp32 path.
+
+Each int8 variant is selected through TL_CPU_INT8_KERNEL, variants the host
+cannot run fall back to the portable kernel.
+"""
+import argparse
+import os
+
+import tilelang
+import tilelang.language as T
+from tilelang.carver.template.kernel_utils import bench_cpu
+
+
+def cpu_matmul(M, N, K, block_M, block_N, block_K, in_dtype, accum_dtype):
+
+    @T.prim_func
+    def main(
+            A: T.Tensor((M, K), in_dtype),
+            B: T.Tensor((N, K), in_dtype),
+            C: T.Tensor((M, N), accum_dtype),
+    ):
+        with T.Kernel(
+                T.ceildiv(N, block_N), T.ceildiv(M, block_M), is_cpu=True,
+                parallel=True) as (bx, by):
+            A_local = T.alloc_local((block_M, block_K), in_dtype)
+            B_local = T.alloc_local((block_N, block_K), in_dtype)
+            C_local = T.alloc_local((block_M, block_N), accum_dtype)
+            T.clear(C_local)
+            for ko in T.Pipelined(T.ceildiv(K, block_K), num_stages=0):
+                T.copy(A[by * block_M, ko * block_K], A_local)
+                T.copy(B[bx * block_N, ko * block_K], B_local)
+                T.gemm(A_local, B_local, C_local, transpose_B=True)
+            T.copy(C_local, C[by * block_M, bx * block_N])
+
+    return main
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="CPU int8 gemm benchmark")
+    parser.add_argument("--m", type=int, default=1024)
+    parser.add_argument("--n", type=int, default=1024)
+    parser.add_argument("--k", type=int, default=1024)
+    parser.add_argument("--block", type=int, nargs=3, default=[64, 64, 256])
+    args = parser.parse_args()
+
+    tilelang.disable_cache()
+    M, N, K = args.m, args.n, args.k
+    ops = 2 * M * N * K
+
+    def run(label, in_dtype, accum_dtype):
+        kernel = tilelang.compile(
+            cpu_matmul(M, N, K, *args.block, in_dtype, accum_dtype),
+            target="c",
+            execution_backend="ctypes")
+        latency = bench_cpu(kernel)
+        print(f"{label:>12}: {latency:8.3f} ms  {ops / latency * 1e-9:8.2f} TOPS")
+
+    run("float32", "float32", "float32")
+    for choice in ["portable", "avxvnni", "avx512vnni", "sdot"]:
+        os.environ["TL_CPU_INT8_KERNEL"] = choice
+        run(f"int8 {choice}", "int8", "int32")
+    del os.environ["TL_CPU_INT8_KERNEL"]
@@ -0,0 +1,100 @@
+import argparse
+import time
+
+import torch
+from tvm.target import Target
+
+import tilelang
+import tilelang.language as T
+from tilelang.carver.arch import CPU
+from tilelang.carver.template.kernel_utils import measure_stream_bandwidth
+from tilelang.quantize import general_compress, ternary_decoder, uint_decoder
+
+
+def dequant_gemv(M, N, K, block_N, block_K, decoder, in_dtype, accum_dtype):
+    per_byte = decoder.elems_per_byte
+    group_size = decoder.group_size if decoder.group_size > 0 else K
+
+    def gemm_tile(A_local, B, Scale, C_local, bx, ko):
+        return T.gemm_dequant(
+            A_local,
+            B[bx * block_N, ko * block_K // per_byte],
+            C_local,
+            decoder,
+            scale=Scale[bx * block_N, ko * block_K // group_size]
+            if decoder.with_scaling else None)
+
+    @T.prim_func
+    def main(
+            A: T.Tensor((M, K), in_dtype),
+            B: T.Tensor((N, K // per_byte), "int8"),
+            Scale: T.Tensor((N, K // group_size), accum_dtype),
+            C: T.Tensor((M, N), accum_dtype),
+    ):
+        with T.Kernel(T.ceildiv(N, block_N), is_cpu=True, parallel=True) as bx:
+            A_local = T.alloc_local((M, block_K), in_dtype)
+            C_local = T.alloc_local((M, block_N), accum_dtype)
+            T.clear(C_local)
+            for ko in T.Pipelined(T.ceildiv(K, block_K), num_stages=0):
+                T.copy(A[0, ko * block_K], A_local)
+                gemm_tile(A_local, B, Scale, C_local, bx, ko)
+            T.copy(C_local, C[0, bx * block_N])
+
+    return main
+
+
+def run(label, M, N, K, decoder, in_dtype, bandwidth, rep=20):
+    accum_dtype = "int32" if in_dtype == "int8" else "float32"
+    kernel = tilelang.compile(
+        dequant_gemv(M, N, K, 64, 512, decoder, in_dtype, accum_dtype),
+        target="c",
+        execution_backend="ctypes")
+
+    group_size = decoder.group_size if decoder.group_size > 0 else K
+    q = torch.randint(0, 3 if decoder.kind == "ternary" else 1 << decoder.num_bits, (N, K),
+                      dtype=torch.int8)
+    b = general_compress(q, source_bits=decoder.num_bits)
+    w = decoder.unpack(b)
+    if in_dtype == "int8":
+        a = torch.randint(-128, 128, (M, K), dtype=torch.int8)
+        scale = torch.ones(N, K // group_size, dtype=torch.int32)
+        c = torch.zeros(M, N, dtype=torch.int32)
+        kernel(a, b, scale, c)
+        torch.testing.assert_close(c, (a.double() @ w.double().T).to(torch.int32))
+    else:
+        a = torch.randn(M, K)
+        scale = torch.rand(N, K // group_size)
+        c = torch.zeros(M, N)
+        kernel(a, b, scale, c)
+        w = w * scale.repeat_interleave(group_size, dim=1)
+        torch.testing.assert_close(c, a @ w.T, rtol=1e-3, atol=1e-2)
+
+    start = time.perf_counter()
+    for _ in range(rep):
+        kernel(a, b, scale, c)
+    latency = (time.perf_counter() - start) / rep
+    # The compressed weights dominate the traffic of a GEMV.
+    nbytes = b.numel() + a.numel() * a.element_size() + c.numel() * c.element_size()
+    achieved = nbytes / latency * 1e-9
+    print(f"{label:>24}: {latency * 1e3:8.3f} ms  {achieved:7.1f} GB/s "
+          f"({achieved / bandwidth:.0%} of STREAM)")
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--m", type=int, default=1)
+    parser.add_argument("--n", type=int, default=4096)
+    parser.add_argument("--k", type=int, default=4096)
+    args, _ = parser.parse_known_args()
+    M, N, K = args.m, args.n, args.k
+
+    tilelang.disable_cache()
+    bandwidth = measure_stream_bandwidth(CPU(Target("llvm")))
+    print(f"STREAM copy bandwidth: {bandwidth:.1f} GB/s")
+    run("float32 x uint4 (g128)", M, N, K, uint_decoder(4, with_scaling=True, group_size=128),
+        "float32", bandwidth)
+    run("int8 x ternary (bitnet)", M, N, K, ternary_decoder(), "int8", bandwidth)
+
+
+if __name__ == "__main__":
+    main()
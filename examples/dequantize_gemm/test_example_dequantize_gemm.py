@@ -2,6 +2,7 @@ import tilelang.testing
 
 import example_dequant_gemv_fp16xint4
 import example_dequant_gemm_fp4_hopper
+import example_dequant_gemv_cpu
 
 
 @tilelang.testing.requires_cuda
@@ -15,5 +16,9 @@ def test_example_dequant_gemm_fp4_hopper():
     example_dequant_gemm_fp4_hopper.main()
 
 
+def test_example_dequant_gemv_cpu():
+    example_dequant_gemv_cpu.main()
+
+
 if __name__ == "__main__":
     tilelang.testing.main()
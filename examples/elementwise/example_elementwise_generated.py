@@ -0,0 +1,51 @@
+import argparse
+
+import torch
+from tvm import tir
+from tvm.target import Target
+
+from tilelang import carver
+from tilelang.carver.arch import CPU, auto_infer_current_arch
+from tilelang.carver.template.kernel_utils import measure_stream_bandwidth
+
+
+def bias_relu(x, bias):
+    return tir.max(x + bias, tir.const(0, x.dtype))
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--m", type=int, default=4096)
+    parser.add_argument("--n", type=int, default=4096)
+    parser.add_argument("--cpu", action="store_true", default=False)
+    args, _ = parser.parse_known_args()
+    M, N = args.m, args.n
+
+    arch = CPU(Target("llvm")) if args.cpu else auto_infer_current_arch()
+    device = "cpu" if args.cpu else "cuda"
+    template = carver.ElementwiseTemplate(
+        shape=[M, N],
+        dtype="float32",
+        compute=bias_relu,
+        input_shapes=[[M, N], [N]],
+    ).with_arch(arch)
+
+    results = template.recommend_kernels(topk=8)
+    best = results[0]
+    print(f"vector width {template.vector_width()}, best config {best.hint}")
+
+    x = torch.randn(M, N, device=device)
+    bias = torch.randn(N, device=device)
+    out = torch.empty(M, N, device=device)
+    best.kernel(x, bias, out)
+    torch.testing.assert_close(out, torch.relu(x + bias))
+
+    bandwidth = measure_stream_bandwidth(arch)
+    roofline = template.roofline_latency(bandwidth)
+    print(f"STREAM copy bandwidth: {bandwidth:.1f} GB/s")
+    print(f"Latency: {best.latency:.4f} ms, roofline: {roofline:.4f} ms "
+          f"({roofline / best.latency:.0%} of peak)")
+
+
+if __name__ == "__main__":
+    main()
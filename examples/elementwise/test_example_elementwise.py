@@ -1,10 +1,15 @@
 import tilelang.testing
 import example_elementwise_add
+import example_elementwise_generated
 
 
 def test_example_elementwise_add():
     example_elementwise_add.main()
 
 
+def test_example_elementwise_generated():
+    example_elementwise_generated.main()
+
+
 if __name__ == "__main__":
     tilelang.testing.main()
@@ -29,18 +29,21 @@ static Var CreateEnvThread(String name, String thread_tag, DataType dtype) {
   return var;
 }
 
-static ForFrame MakeIterVarFrame(std::string name, PrimExpr dom) {
+static ForFrame
+MakeIterVarFrame(std::string name, PrimExpr dom,
+                 Map<String, ObjectRef> annotations = Map<String, ObjectRef>()) {
   using namespace tvm::tir;
   Var var = Var(name, dom->dtype);
   // Create a frame that represents a loop over the given domain.
   ObjectPtr<ForFrameNode> n = make_object<ForFrameNode>();
   n->vars.push_back(var);
   n->doms.push_back(Range(0, dom));
-  n->f_make_for_loop = [](Array<Var> vars, Array<Range> doms,
-                          Stmt body) -> Stmt {
+  n->f_make_for_loop = [annotations](Array<Var> vars, Array<Range> doms,
+                                     Stmt body) -> Stmt {
     ICHECK_EQ(vars.size(), 1);
     ICHECK_EQ(doms.size(), 1);
-    return For(vars[0], doms[0]->min, doms[0]->extent, ForKind::kSerial, body);
+    return For(vars[0], doms[0]->min, doms[0]->extent, ForKind::kSerial, body,
+               /*thread_binding=*/NullOpt, /*annotations=*/annotations);
   };
   return ForFrame(n);
 }
@@ -105,8 +108,97 @@ ForFrame PipelinedFor(PrimExpr start, PrimExpr stop, int num_stages,
   return ForFrame(n);
 }
 
+/*!
+ * \brief Decompose a linear tile id into the coordinates of \p domain.
+ *
+ * "row" walks the last dimension fastest and "column" the first one.
+ * "swizzle" walks the last dimension in panels of \p group_size tiles so that
+ * consecutive tiles share operand panels in L2, the trailing panel is clamped
+ * when the last dimension is not a multiple of \p group_size.
+ */
+static Array<PrimExpr> DecomposeTileIndex(PrimExpr tile,
+                                          const Array<PrimExpr> &domain,
+                                          const std::string &order,
+                                          PrimExpr group_size) {
+  using namespace tvm::tir;
+  int ndim = domain.size();
+  Array<PrimExpr> coords(ndim, PrimExpr());
+  if (order == "row") {
+    PrimExpr rem = tile;
+    for (int i = ndim - 1; i >= 1; --i) {
+      coords.Set(i, truncmod(rem, domain[i]));
+      rem = truncdiv(rem, domain[i]);
+    }
+    coords.Set(0, rem);
+  } else if (order == "column") {
+    PrimExpr rem = tile;
+    for (int i = 0; i < ndim - 1; ++i) {
+      coords.Set(i, truncmod(rem, domain[i]));
+      rem = truncdiv(rem, domain[i]);
+    }
+    coords.Set(ndim - 1, rem);
+  } else if (order == "swizzle") {
+    PrimExpr last = domain[ndim - 1];
+    group_size = cast(last.dtype(), min(group_size, last));
+    PrimExpr outer_size = make_const(last.dtype(), 1);
+    for (int i = 0; i < ndim - 1; ++i) {
+      outer_size *= domain[i];
+    }
+    PrimExpr panel_tiles = group_size * outer_size;
+    PrimExpr panel_begin = truncdiv(tile, panel_tiles) * group_size;
+    PrimExpr panel_width = min(last - panel_begin, group_size);
+    PrimExpr in_panel = truncmod(tile, panel_tiles);
+    coords.Set(ndim - 1, panel_begin + truncmod(in_panel, panel_width));
+    PrimExpr rem = truncdiv(in_panel, panel_width);
+    for (int i = ndim - 2; i >= 1; --i) {
+      coords.Set(i, truncmod(rem, domain[i]));
+      rem = truncdiv(rem, domain[i]);
+    }
+    if (ndim > 1) {
+      coords.Set(0, rem);
+    }
+  } else {
+    LOG(FATAL) << "Unsupported tile order \"" << order
+               << "\", expected one of \"row\", \"column\" or \"swizzle\"";
+  }
+  return coords;
+}
+
+/*!
+ * \brief Fetch the next tile id from a global work counter.
+ *
+ * The extern is implemented per backend in tl_templates so that one thread of
+ * the block performs the atomic and broadcasts the result.
+ */
+static PrimExpr FetchNextTile(PrimExpr counter, DataType dtype) {
+  using namespace tvm::tir;
+  PrimExpr tile = tvm::tir::Call(
+      DataType::Int(32), builtin::call_extern(),
+      {StringImm("tl::persistent_fetch_tile"), std::move(counter)});
+  return cast(dtype, tile);
+}
+
+static Stmt LoopBreakIf(PrimExpr cond) {
+  using namespace tvm::tir;
+  return tvm::tir::IfThenElse(
+      std::move(cond),
+      tvm::tir::Evaluate(
+          tvm::tir::Call(DataType::Handle(), tvm::tl::loop_break(), {})),
+      Stmt());
+}
+
+static Stmt BindCoords(const Array<Var> &vars, const Array<PrimExpr> &values,
+                       Stmt body) {
+  ICHECK_EQ(vars.size(), values.size());
+  for (int i = static_cast<int>(vars.size()) - 1; i >= 0; --i) {
+    body = tvm::tir::LetStmt(vars[i], values[i], body);
+  }
+  return body;
+}
+
 ForFrame PersistentFor(Array<PrimExpr> domain, PrimExpr wave_size,
-                       PrimExpr index, PrimExpr group_size) {
+                       PrimExpr index, PrimExpr group_size, String order,
+                       Optional<PrimExpr> counter) {
   using namespace tvm::tir;
   ICHECK(domain.size() > 0);
   ObjectPtr<ForFrameNode> n = make_object<ForFrameNode>();
@@ -117,53 +209,94 @@ ForFrame PersistentFor(Array<PrimExpr> domain, PrimExpr wave_size,
     domain_size *= domain[i];
   }
 
-  auto waves = ceildiv(domain_size, wave_size);
-  auto loop_var = Var("w", waves.dtype());
-  group_size = min(group_size, domain[domain.size() - 1]);
-  Array<Var> coord_vars;
-
   for (int i = 0; i < domain.size(); ++i) {
     DataType dtype = domain[i].dtype();
     Var coord("v" + std::to_string(i), dtype);
-    coord_vars.push_back(coord);
     n->vars.push_back(coord);
     n->doms.push_back(Range(make_const(dtype, 0), domain[i]));
   }
 
-  Array<PrimExpr> grouped_domain;
-  grouped_domain.push_back(truncdiv(domain[domain.size() - 1], group_size));
-  for (int i = 0; i < domain.size() - 1; ++i) {
-    grouped_domain.push_back(domain[i]);
+  n->f_make_for_loop = [=](Array<Var> vars, Array<Range> doms,
+                           Stmt body) -> Stmt {
+    ICHECK_EQ(vars.size(), doms.size());
+    if (counter.defined()) {
+      // Dynamic schedule: every worker keeps pulling tiles from the shared
+      // counter until the domain is exhausted, at most domain_size times.
+      Var loop_var("w", domain_size.dtype());
+      Var tile("tile_id", domain_size.dtype());
+      Stmt inner = BindCoords(
+          vars, DecomposeTileIndex(tile, domain, order, group_size), body);
+      inner = SeqStmt({LoopBreakIf(domain_size <= tile), inner});
+      inner = tvm::tir::LetStmt(
+          tile, FetchNextTile(counter.value(), tile.dtype()), inner);
+      return For(loop_var, 0, domain_size, ForKind::kSerial, inner);
+    }
+    // Static schedule: worker `index` handles tiles index, index + wave_size,
+    // ... in the requested order.
+    auto waves = ceildiv(domain_size, wave_size);
+    Var loop_var("w", waves.dtype());
+    PrimExpr tile = loop_var * wave_size + index;
+    Stmt inner = BindCoords(
+        vars, DecomposeTileIndex(tile, domain, order, group_size), body);
+    return For(loop_var, 0, waves, ForKind::kSerial,
+               SeqStmt({LoopBreakIf(domain_size <= tile), inner}));
+  };
+
+  return ForFrame(n);
+}
+
+ForFrame StreamKFor(Array<PrimExpr> domain, PrimExpr iters_per_tile,
+                    PrimExpr wave_size, PrimExpr index, PrimExpr group_size,
+                    String order) {
+  using namespace tvm::tir;
+  ICHECK(domain.size() > 0);
+  ObjectPtr<ForFrameNode> n = make_object<ForFrameNode>();
+  PrimExpr domain_size = domain[0];
+  for (int i = 1; i < domain.size(); i++) {
+    domain_size *= domain[i];
+  }
+  DataType dtype = domain_size.dtype();
+  iters_per_tile = cast(dtype, iters_per_tile);
+  wave_size = cast(dtype, wave_size);
+  index = cast(dtype, index);
+
+  for (int i = 0; i < domain.size(); ++i) {
+    Var coord("v" + std::to_string(i), domain[i].dtype());
+    n->vars.push_back(coord);
+    n->doms.push_back(Range(make_const(domain[i].dtype(), 0), domain[i]));
   }
-  grouped_domain.push_back(group_size);
+  // The [k_begin, k_end) slice of the tile's reduction iterations.
+  n->vars.push_back(Var("k_begin", dtype));
+  n->doms.push_back(Range(make_const(dtype, 0), iters_per_tile));
+  n->vars.push_back(Var("k_end", dtype));
+  n->doms.push_back(Range(make_const(dtype, 0), iters_per_tile + 1));
 
   n->f_make_for_loop = [=](Array<Var> vars, Array<Range> doms,
                            Stmt body) -> Stmt {
     ICHECK_EQ(vars.size(), doms.size());
-    Map<String, ObjectRef> anno;
-    Array<PrimExpr> idxs(grouped_domain.size(), PrimExpr());
-    PrimExpr rem = loop_var * wave_size + index;
-
-    for (int i = grouped_domain.size() - 1; i >= 1; --i) {
-      idxs.Set(i, truncmod(rem, grouped_domain[i]));
-      rem = truncdiv(rem, grouped_domain[i]);
-    }
-    idxs.Set(0, rem);
-
-    auto out_if = tvm::tir::IfThenElse(
-        domain_size <= (loop_var * wave_size + index),
-        tvm::tir::Evaluate(
-            tvm::tir::Call(DataType::Handle(), tvm::tl::loop_break(), {})),
-        Stmt());
-
-    Stmt outer = For(loop_var, 0, waves, ForKind::kSerial,
-                     SeqStmt({out_if, body}), NullOpt, anno);
-    for (int i = 0; i < vars.size() - 1; ++i) {
-      outer = tvm::tir::LetStmt(vars[i], idxs[i + 1], outer);
-    }
-    outer = tvm::tir::LetStmt(vars[vars.size() - 1],
-                              idxs[0] * group_size + idxs[vars.size()], outer);
-    return outer;
+    // Every worker owns a contiguous range of the flattened
+    // (tile, k-iteration) space and visits each tile it overlaps once.
+    PrimExpr total_iters = domain_size * iters_per_tile;
+    PrimExpr iters_per_worker = ceildiv(total_iters, wave_size);
+    PrimExpr begin = index * iters_per_worker;
+    PrimExpr end = min(begin + iters_per_worker, total_iters);
+    PrimExpr max_segments = ceildiv(iters_per_worker, iters_per_tile) + 1;
+
+    Var loop_var("s", dtype);
+    Var seg_begin("seg_begin", dtype);
+    PrimExpr first_tile = truncdiv(begin, iters_per_tile);
+    PrimExpr tile = truncdiv(seg_begin, iters_per_tile);
+
+    Array<PrimExpr> values = DecomposeTileIndex(tile, domain, order,
+                                                group_size);
+    values.push_back(truncmod(seg_begin, iters_per_tile));
+    values.push_back(min(end - tile * iters_per_tile, iters_per_tile));
+    Stmt inner = BindCoords(vars, values, body);
+    inner = SeqStmt({LoopBreakIf(end <= seg_begin), inner});
+    inner = tvm::tir::LetStmt(
+        seg_begin, max(begin, (first_tile + loop_var) * iters_per_tile),
+        inner);
+    return For(loop_var, 0, max_segments, ForKind::kSerial, inner);
   };
 
   return ForFrame(n);
@@ -226,10 +359,16 @@ KernelLaunchFrame KernelLaunch(Array<PrimExpr> grid_size,
     ICHECK(grid_size.size() >= 0);
     ICHECK(block_size.size() == 0) << "CPU kernel cannot have block size";
     ICHECK(attrs.defined());
-    // create grid loop var
+    // create grid loop var, the outermost one becomes the worker loop that
+    // LowerTileOp hands over to the host thread pool.
+    bool parallel_grid = attrs.count(attr::kCPUWorkerLoop);
     for (int i = 0; i < grid_size.size(); i++) {
-      n->frames.push_back(
-          MakeIterVarFrame("block_var_" + std::to_string(i), grid_size[i]));
+      Map<String, ObjectRef> annotations;
+      if (parallel_grid && i == 0) {
+        annotations.Set(attr::kCPUWorkerLoop, Integer(1));
+      }
+      n->frames.push_back(MakeIterVarFrame("block_var_" + std::to_string(i),
+                                           grid_size[i], annotations));
     }
   } else {
     // Launch GPU Kernel
@@ -282,6 +421,7 @@ TVM_REGISTER_NODE_TYPE(KernelLaunchFrameNode);
 TVM_REGISTER_GLOBAL("tl.Parallel").set_body_typed(ParallelFor);
 TVM_REGISTER_GLOBAL("tl.Pipelined").set_body_typed(PipelinedFor);
 TVM_REGISTER_GLOBAL("tl.Persistent").set_body_typed(PersistentFor);
+TVM_REGISTER_GLOBAL("tl.StreamK").set_body_typed(StreamKFor);
 TVM_REGISTER_GLOBAL("tl.KernelLaunch").set_body_typed(KernelLaunch);
 
 class WarpSpecializeFrameNode : public TIRFrameNode {
@@ -22,10 +22,23 @@ TVM_REGISTER_PASS_CONFIG_OPTION(kDisableSafeMemoryLegalize, Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION(kDisableWarpSpecialized, Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION(kConfigIndexBitwidth, Integer);
 TVM_REGISTER_PASS_CONFIG_OPTION(kDisableDynamicTailSplit, Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION(kDisableMaskedVectorize, Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION(kDisableLoopNestOptimize, Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION(kDisableRegisterPromotion, Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION(kDisableStrengthReduction, Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION(kDisableSLPVectorize, Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION(kDisableLoopInvariantCodeMotion, Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION(kDisableDeadTileWriteElimination, Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION(kDisableCostBasedUnroll, Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION(kDynamicAlignment, Integer);
 TVM_REGISTER_PASS_CONFIG_OPTION(kEnableAggressiveSharedMemoryMerge, Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION(kDisableFastMath, Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION(kEnablePTXASVerboseOutput, Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION(kDisableStagingForwarding, Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION(kEnableFragmentForwarding, Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION(kSplitK, Integer);
+TVM_REGISTER_PASS_CONFIG_OPTION(kStreamKWorkers, Integer);
+TVM_REGISTER_PASS_CONFIG_OPTION(kRegisterBudget, Integer);
 
 #define TIR_DEFINE_TL_BUILTIN(OpName)                                          \
   const Op &OpName() {                                                         \
@@ -130,5 +143,10 @@ TIR_DEFINE_TL_BUILTIN(loop_break)
     .set_num_inputs(0)
     .set_attr<TCallEffectKind>("TCallEffectKind",
                                Integer(CallEffectKind::kOpaque));
+
+TIR_DEFINE_TL_BUILTIN(subgroup_shuffle_xor)
+    .set_num_inputs(2)
+    .set_attr<TCallEffectKind>("TCallEffectKind",
+                               Integer(CallEffectKind::kOpaque));
 } // namespace tl
 } // namespace tvm
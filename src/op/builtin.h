@@ -15,6 +15,27 @@ namespace tl {
 
 namespace attr {
 static constexpr const char *kPaddingMap = "padding_map";
+/*!
+ * \brief Marks the outermost grid loop of a CPU kernel whose iterations are
+ * dispatched to the host thread pool, see T.Kernel(..., parallel=True).
+ */
+static constexpr const char *kCPUWorkerLoop = "tilelang.cpu_worker_loop";
+/*!
+ * \brief PrimFunc attribute recording the register footprint estimated by
+ * layout inference: peak_registers, register_budget and the decision log.
+ */
+static constexpr const char *kRegisterFootprint = "tl.register_footprint";
+/*!
+ * \brief PrimFunc attribute listing the decision of CostBasedUnroll for every
+ * per-thread loop: its cost estimate and whether it is unrolled.
+ */
+static constexpr const char *kUnrollDecisions = "tl.unroll_decisions";
+/*!
+ * \brief PrimFunc attribute listing the indices of the parameters that
+ * DecomposeKLoop reduces with atomic additions, which the caller has to
+ * zero-initialize.
+ */
+static constexpr const char *kAtomicOutputs = "tl.atomic_outputs";
 } // namespace attr
 
 static constexpr const char *kDebugMergeSharedMemoryAllocations =
@@ -30,6 +51,37 @@ static constexpr const char *kEnableAggressiveSharedMemoryMerge =
 static constexpr const char *kDisableFastMath = "tl.disable_fast_math";
 static constexpr const char *kEnablePTXASVerboseOutput =
     "tl.enable_ptxas_verbose_output";
+static constexpr const char *kDisableStagingForwarding =
+    "tl.disable_staging_forwarding";
+static constexpr const char *kEnableFragmentForwarding =
+    "tl.enable_fragment_forwarding";
+
+/*!
+ * \brief Split the K loop of GEMM kernels into the given number of slices,
+ * one per block, reduced with atomics (see DecomposeKLoop).
+ *
+ * kSplitK = "tl.split_k"
+ *
+ */
+static constexpr const char *kSplitK = "tl.split_k";
+
+/*!
+ * \brief Run GEMM kernels as the given number of stream-K workers, which
+ * share the (tile, k) iteration space evenly (see DecomposeKLoop).
+ *
+ * kStreamKWorkers = "tl.stream_k_workers"
+ *
+ */
+static constexpr const char *kStreamKWorkers = "tl.stream_k_workers";
+
+/*!
+ * \brief Registers per thread layout inference may spend on fragments, the
+ * default is derived from the target and the block size.
+ *
+ * kRegisterBudget = "tl.register_budget"
+ *
+ */
+static constexpr const char *kRegisterBudget = "tl.register_budget";
 
 /*!
  * \brief Whether to disable dynamic tail split
@@ -40,6 +92,87 @@ static constexpr const char *kEnablePTXASVerboseOutput =
 static constexpr const char *kDisableDynamicTailSplit =
     "tl.disable_dynamic_tail_split";
 
+/*!
+ * \brief Whether to scalarize vectorized statements whose guards depend on the
+ * vectorized lane instead of versioning them into a full vector path and a
+ * masked or lane by lane tail (see VectorizeLoop)
+ *
+ * kDisableMaskedVectorize = "tl.disable_masked_vectorize"
+ *
+ */
+static constexpr const char *kDisableMaskedVectorize =
+    "tl.disable_masked_vectorize";
+
+/*!
+ * \brief Whether to keep serial loop nests of CPU kernels in source order
+ * instead of interchanging and register tiling them (see OptimizeCPULoopNest)
+ *
+ * kDisableLoopNestOptimize = "tl.disable_loop_nest_optimize"
+ *
+ */
+static constexpr const char *kDisableLoopNestOptimize =
+    "tl.disable_loop_nest_optimize";
+
+/*!
+ * \brief Whether to keep loop invariant elements of local buffers in memory
+ * instead of promoting them to registers across the loop (see
+ * RegisterPromotion)
+ *
+ * kDisableRegisterPromotion = "tl.disable_register_promotion"
+ *
+ */
+static constexpr const char *kDisableRegisterPromotion =
+    "tl.disable_register_promotion";
+
+/*!
+ * \brief Whether to keep recomputing flattened buffer indices in every loop
+ * iteration instead of hoisting their invariant part (see StrengthReduceIndex)
+ *
+ * kDisableStrengthReduction = "tl.disable_strength_reduction"
+ *
+ */
+static constexpr const char *kDisableStrengthReduction =
+    "tl.disable_strength_reduction";
+
+/*!
+ * \brief Whether to keep unrolled runs of isomorphic scalar statements scalar
+ * instead of packing them into vector statements (see SLPVectorize)
+ *
+ * kDisableSLPVectorize = "tl.disable_slp_vectorize"
+ *
+ */
+static constexpr const char *kDisableSLPVectorize = "tl.disable_slp_vectorize";
+
+/*!
+ * \brief Whether to keep loop invariant loads and predicates inside the loops
+ * instead of hoisting them (see LoopInvariantCodeMotion)
+ *
+ * kDisableLoopInvariantCodeMotion = "tl.disable_loop_invariant_code_motion"
+ *
+ */
+static constexpr const char *kDisableLoopInvariantCodeMotion =
+    "tl.disable_loop_invariant_code_motion";
+
+/*!
+ * \brief Whether to keep fills and copies of tile buffers that are overwritten
+ * before being read (see EliminateDeadTileWrites)
+ *
+ * kDisableDeadTileWriteElimination = "tl.disable_dead_tile_write_elimination"
+ *
+ */
+static constexpr const char *kDisableDeadTileWriteElimination =
+    "tl.disable_dead_tile_write_elimination";
+
+/*!
+ * \brief Whether to leave the per-thread loops of parallel loops to the
+ * unroll pragma instead of unrolling them by cost (see CostBasedUnroll)
+ *
+ * kDisableCostBasedUnroll = "tl.disable_cost_based_unroll"
+ *
+ */
+static constexpr const char *kDisableCostBasedUnroll =
+    "tl.disable_cost_based_unroll";
+
 /*!
  * \brief The size of the vectorized dimension in buffer, designed by user
  *
@@ -229,6 +362,15 @@ const Op &sync_grid();
  */
 const Op &loop_break();
 
+/*!
+ * \brief Exchange a value with the lane whose id differs by lane_mask within
+ * the subgroup (WebGPU subgroupShuffleXor).
+ *
+ * T subgroup_shuffle_xor(T value, int lane_mask)
+ *
+ */
+const Op &subgroup_shuffle_xor();
+
 /*!
  * \brief tvm intrinsic for amd matrix core mfma instructions.
  *
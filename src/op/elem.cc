@@ -182,7 +182,13 @@ Stmt Copy::Lower(const LowerArgs &T, arith::Analyzer *analyzer) const {
   auto par_op = std::make_unique<ParallelOp>(transformed_loop);
 
   if (is_cpu_target) {
-    vectorized_thread_loop = VectorizeLoop(transformed_loop);
+    Optional<For> transposed;
+    if (!T.layout_map.count(src) && !T.layout_map.count(dst)) {
+      transposed = VectorizeTransposedCopy(transformed_loop);
+    }
+    vectorized_thread_loop = transposed.defined()
+                                 ? transposed.value()
+                                 : VectorizeLoop(transformed_loop);
   } else {
     std::vector<InferLevel> levels = {InferLevel::kCommon, InferLevel::kStrict,
                                       InferLevel::kFree};
@@ -219,7 +219,39 @@ std::pair<int, int> Gemm::ComputeWarpPartition(int num_warps, Target target,
   return {m_warp, n_warp};
 }
 
+// A CPU kernel has a single thread, which holds a fragment tile in its natural
+// row-major order.
+static Fragment makeCPUTileFragment(const Buffer &buffer) {
+  Array<PrimExpr> forward_index;
+  for (size_t i = 0; i < buffer->shape.size(); ++i) {
+    forward_index.push_back(InputPlaceholder(i));
+  }
+  return Fragment(buffer->shape, forward_index, make_zero(DataType::Int(32)),
+                  1, NullOpt);
+}
+
+// On CPU the tiles are plain row-major arrays and tl::gemm_cpu takes the row
+// pitch of each operand; int8 operands with an int32 accumulator run on the
+// dot-product micro-kernels (VNNI / SDOT) picked at runtime.
+Stmt Gemm::LowerCPU() const {
+  auto leading_dim = [](const Buffer &buffer) {
+    auto extent = as_const_int(buffer->shape.back());
+    ICHECK(extent) << "CPU gemm requires a constant row pitch for "
+                   << buffer->name << ", but got " << buffer->shape;
+    return *extent;
+  };
+  std::stringstream ss;
+  ss << "tl::gemm_cpu<" << M << ", " << N << ", " << K << ", " << trans_A
+     << ", " << trans_B << ", " << clear_accum << ", " << leading_dim(A)
+     << ", " << leading_dim(B) << ", " << leading_dim(C) << ">";
+  Array<PrimExpr> new_args{StringImm(ss.str()), Aptr, Bptr, Cptr};
+  return Evaluate(Call(DataType::Handle(), builtin::call_extern(), new_args));
+}
+
 Stmt Gemm::Lower(const LowerArgs &T, arith::Analyzer *analyzer) const {
+  if (TargetIsCPU(T.target)) {
+    return LowerCPU();
+  }
   int warp_size = 32;
   if (TargetIsCDNA(T.target)) {
     warp_size = 64;
@@ -270,6 +302,16 @@ LayoutMap Gemm::InferLayout(const LayoutInferArgs &T, InferLevel level) {
   if (completed_)
     return {};
   LayoutMap results;
+  if (TargetIsCPU(T.target)) {
+    for (const Buffer &buffer : {A, B, C}) {
+      if (buffer.scope() == "local.fragment") {
+        results.Set(buffer, makeCPUTileFragment(buffer)->BindThreadRange(
+                                T.thread_bounds));
+      }
+    }
+    completed_ = true;
+    return results;
+  }
   ICHECK(C.scope() == "local.fragment");
   auto thread_range = T.thread_bounds;
   auto block_size = *as_const_int(thread_range->extent);
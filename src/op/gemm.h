@@ -27,6 +27,7 @@ public:
   } policy;
 
 private:
+  Stmt LowerCPU() const;
   std::pair<int, int>
   ComputeWarpPartition(int num_warps, Target target,
                        bool maybe_hopper_wgmma = true) const;
@@ -57,6 +57,9 @@ struct LayoutInferArgs {
   Range thread_bounds;
   LayoutMap layout_map;
   Map<Buffer, Buffer> buffer_remap;
+  // Set by layout inference when the register footprint exceeds the budget,
+  // operators should then avoid replicating the fragments they produce.
+  bool prefer_low_replication{false};
 };
 
 struct CanonializeArgs {
@@ -171,9 +171,13 @@ LayoutMap ParallelOp::InferLayout(const LayoutInferArgs &T, InferLevel level) {
   } else if (level == InferLevel::kFree) {
     if (read_source_buffer.defined()) {
       loop_layout_ = compute_loop_layout_from_buffer(read_source_buffer);
-      // // Loop don't need to be replicated.
-      // if (!is_one(loop_layout_->ReplicateExtent()))
-      //   loop_layout_ = loop_layout_->DeReplicate();
+      // Loop don't need to be replicated. Spreading the replicas over the
+      // iterations keeps the fragments written by the loop from inheriting the
+      // replication, which only pays off under register pressure.
+      if (T.prefer_low_replication && loop_layout_->OutputDim() == 1 &&
+          !is_one(loop_layout_->ReplicateExtent()))
+        loop_layout_ =
+            loop_layout_->DeReplicate()->BindThreadRange(T.thread_bounds);
 
       // For free layout inference
       // If replication exists and buffer has cross-thread shared memory access,
@@ -12,7 +12,9 @@
 #include <tvm/tir/stmt_functor.h>
 
 #include "../layout/utils.h"
+#include "../target/utils.h"
 #include "../transform/loop_partition.h"
+#include "builtin.h"
 #include "tir/transforms/ir_utils.h"
 
 namespace tvm {
@@ -96,6 +98,24 @@ PrimExpr ReduceOp::MakeReduce(const PrimExpr &a, const PrimExpr &b) const {
   }
 }
 
+// Combine two partial results, the counterpart of MakeCodegenReducer for
+// reductions expanded in TIR.
+PrimExpr ReduceOp::MakeCombine(const PrimExpr &a, const PrimExpr &b) const {
+  switch (type) {
+  case ReduceType::kSum:
+  case ReduceType::kAbsSum:
+    return a + b;
+  case ReduceType::kMax:
+  case ReduceType::kAbsMax:
+    return Max(a, b);
+  case ReduceType::kMin:
+    return Min(a, b);
+  default:
+    ICHECK(0);
+    return PrimExpr(0);
+  }
+}
+
 std::string ReduceOp::MakeCodegenReducer() const {
   switch (type) {
   case ReduceType::kSum:
@@ -222,6 +242,56 @@ Stmt ReduceOp::Lower(const LowerArgs &T, arith::Analyzer *analyzer) const {
         continue;
 
       int reducing_threads = (*extent) * (*scale);
+
+      // WGSL has no templates. Where the device has subgroups, whose lanes
+      // the target declares to be runs of thread_warp_size consecutive
+      // invocations, butterfly-reduce with subgroup shuffles when the
+      // reducing threads fit in one subgroup.
+      auto warp_size = T.target->GetAttr<Integer>("thread_warp_size");
+      auto offset = as_const_int(T.thread_bounds->min);
+      if (TargetHasSubgroups(T.target) && warp_size.defined() &&
+          reducing_threads <= warp_size.value()->value && offset &&
+          *offset % reducing_threads == 0) {
+        PrimExpr acc = BufferLoad(clear_buffer, dst_indices);
+        for (int lane_mask = reducing_threads / 2; lane_mask >= *scale;
+             lane_mask /= 2) {
+          PrimExpr other = Call(clear_buffer->dtype, subgroup_shuffle_xor(),
+                                {acc, IntImm(DataType::Int(32), lane_mask)});
+          stmts.push_back(BufferStore(clear_buffer, MakeCombine(acc, other),
+                                      dst_indices));
+        }
+        continue;
+      }
+      // Otherwise butterfly-reduce through workgroup memory.
+      if (TargetIsWebGPU(T.target)) {
+        int num_threads = *as_const_int(T.thread_bounds->extent);
+        Var data = GetVarFromAccessPtr(
+            T.AddWorkspace(num_threads, clear_buffer->dtype));
+        Buffer workspace(data, clear_buffer->dtype, {num_threads}, {},
+                         PrimExpr(), "workspace", 0, 0, BufferType::kDefault);
+        PrimExpr tid = T.thread_var - T.thread_bounds->min;
+        PrimExpr acc = BufferLoad(clear_buffer, dst_indices);
+        Stmt sync =
+            Evaluate(Call(DataType::Int(32), builtin::tvm_storage_sync(),
+                          {StringImm("shared")}));
+        stmts.push_back(BufferStore(workspace, acc, {tid}));
+        stmts.push_back(sync);
+        for (int lane_mask = reducing_threads / 2; lane_mask >= *scale;
+             lane_mask /= 2) {
+          PrimExpr partner =
+              bitwise_xor(tid, make_const(tid.dtype(), lane_mask));
+          PrimExpr other = BufferLoad(workspace, {partner});
+          stmts.push_back(BufferStore(clear_buffer, MakeCombine(acc, other),
+                                      dst_indices));
+          stmts.push_back(sync);
+          if (lane_mask / 2 >= *scale) {
+            stmts.push_back(BufferStore(workspace, acc, {tid}));
+            stmts.push_back(sync);
+          }
+        }
+        continue;
+      }
+
       std::stringstream ss;
 
       bool has_arch = T.target->attrs.count("arch") > 0;
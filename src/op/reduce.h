@@ -35,6 +35,7 @@ private:
 
   PrimExpr MakeInitValue() const;
   PrimExpr MakeReduce(const PrimExpr &a, const PrimExpr &b) const;
+  PrimExpr MakeCombine(const PrimExpr &a, const PrimExpr &b) const;
   std::string MakeCodegenReducer() const;
 };
 
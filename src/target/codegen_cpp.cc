@@ -33,6 +33,7 @@
 #include <utility>
 #include <vector>
 
+#include "../op/builtin.h"
 #include "support/str_escape.h"
 #include "target/build_common.h"
 #include "target/func_registry_generator.h"
@@ -54,6 +55,9 @@ void CodeGenTileLangCPP::Init(bool output_ssa, bool emit_asserts,
   decl_stream << "// tilelang target: " << target_str << "\n";
   decl_stream << "#include <tl_templates/cpp/common.h>\n";
   decl_stream << "#include <tl_templates/cpp/gemm.h>\n";
+  decl_stream << "#include <tl_templates/cpp/gemm_dequant.h>\n";
+  decl_stream << "#include <tl_templates/cpp/parallel.h>\n";
+  decl_stream << "#include <tl_templates/cpp/transpose.h>\n";
   decl_stream << "\n";
   CodeGenC::Init(output_ssa);
 }
@@ -170,17 +174,19 @@ void CodeGenTileLangCPP::PrintType(DataType t, std::ostream &os) { // NOLINT(*)
 
 void CodeGenTileLangCPP::VisitExpr_(const BroadcastNode *op,
                                     std::ostream &os) { // NOLINT(*)
+  // Vector types are GCC vector extensions (see tl_templates/cpp/common.h),
+  // built from a brace enclosed list of their lanes.
   std::string v = PrintExpr(op->value);
   int lanes = op->dtype.lanes();
   os << "((";
   PrintType(op->dtype, os);
-  os << ")(";
+  os << "){";
   for (int i = 0; i < lanes; ++i) {
     if (i != 0)
       os << ", ";
     os << v;
   }
-  os << "))";
+  os << "})";
 }
 
 void CodeGenTileLangCPP::PrintGetFuncFromBackend(
@@ -455,6 +461,30 @@ void CodeGenTileLangCPP::VisitStmt_(const AllocateNode *op) {
   this->PrintStmt(op->body);
 }
 
+void CodeGenTileLangCPP::VisitStmt_(const ForNode *op) {
+  // Worker loops of a parallel CPU grid are dispatched to the host thread
+  // pool, every other loop is emitted as a plain for loop.
+  if (op->kind != ForKind::kParallel ||
+      !op->annotations.count(tl::attr::kCPUWorkerLoop)) {
+    CodeGenC::VisitStmt_(op);
+    return;
+  }
+  ICHECK(is_zero(op->min));
+  std::string extent = PrintExpr(op->extent);
+  PrintIndent();
+  std::string vid = AllocVarID(op->loop_var.get());
+  stream << "tl::cpu::parallel_for(";
+  PrintType(op->loop_var.dtype(), stream);
+  stream << "(" << extent << "), [&](";
+  PrintType(op->loop_var.dtype(), stream);
+  stream << ' ' << vid << ") {\n";
+  int for_scope = BeginScope();
+  PrintStmt(op->body);
+  this->EndScope(for_scope);
+  PrintIndent();
+  stream << "});\n";
+}
+
 void CodeGenTileLangCPP::VisitExpr_(const MinNode *op,
                                     std::ostream &os) { // NOLINT(*)
   PrintTernaryCondExpr(op, "<", os);
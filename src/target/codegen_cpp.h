@@ -72,6 +72,7 @@ public:
 
   void VisitStmt_(const AssertStmtNode *op) final; // NOLINT(*)
   void VisitStmt_(const AllocateNode *op) final;   // NOLINT(*)
+  void VisitStmt_(const ForNode *op) final;        // NOLINT(*)
 
   void GenerateForwardFunctionDeclarations(String global_symbol,
                                            const Array<Type> &arg_types,
@@ -79,6 +79,55 @@ private:
   std::vector<std::pair<std::string, std::string>> _rules;
 };
 
+// fp16 vectors are stored as uint vectors holding pairs of lanes (see
+// PrintType), which the packed intrinsics below operate on in place. bf16
+// has no packed arithmetic in HIP and stays lane by lane.
+static std::string PackedPairType(DataType type) {
+  if (type.is_float16()) {
+    return "half2";
+  } else if (type.is_float() && type.bits() == 32) {
+    return "float2";
+  }
+  return "";
+}
+
+// The packed intrinsic computing a binary op on a pair of fp16 lanes.
+static std::string PackedBinaryIntrinsic(const std::string &op,
+                                         DataType type) {
+  if (!type.is_float16() || type.lanes() % 2 != 0) {
+    return "";
+  }
+  if (op == "+") {
+    return "__hadd2";
+  } else if (op == "-") {
+    return "__hsub2";
+  } else if (op == "*") {
+    return "__hmul2";
+  } else if (op == "/") {
+    return "__h2div";
+  }
+  return "";
+}
+
+// The packed conversion of a pair of lanes between float and fp16.
+static std::string PackedConversion(DataType from, DataType target) {
+  if (from.lanes() % 2 != 0) {
+    return "";
+  }
+  if (from.is_float() && from.bits() == 32 && target.is_float16()) {
+    return "__float22half2_rn";
+  } else if (from.is_float16() && target.is_float() && target.bits() == 32) {
+    return "__half22float2";
+  }
+  return "";
+}
+
+// Pair p of the lanes of vector vec, as an lvalue of the packed pair type.
+static std::string PackedPair(const std::string &vec, DataType type, int p) {
+  return "((" + PackedPairType(type) + "*)(&(" + vec + ")))[" +
+         std::to_string(p) + "]";
+}
+
 CodeGenTileLangHIP::CodeGenTileLangHIP() { restrict_keyword_ = "__restrict__"; }
 
 void CodeGenTileLangHIP::PrintFuncPrefix(std::ostream &os) {
@@ -430,7 +479,35 @@ void CodeGenTileLangHIP::PrintVecBinaryOp(const std::string &op, DataType t,
   this->PrintType(t, stream);
   stream << ' ' << sret << ";\n";
   int ssa_scope = BeginScope();
-  {
+  std::string packed = PackedBinaryIntrinsic(op, t);
+  if (!packed.empty()) {
+    // One packed instruction per pair of lanes, fusing a * b + c into fma.
+    const MulNode *mul = nullptr;
+    PrimExpr addend;
+    if (op == "+") {
+      if ((mul = lhs.as<MulNode>())) {
+        addend = rhs;
+      } else if ((mul = rhs.as<MulNode>())) {
+        addend = lhs;
+      }
+    }
+    std::vector<std::string> args;
+    if (mul != nullptr) {
+      packed = "__hfma2";
+      args = {SSAGetID(PrintExpr(mul->a), t), SSAGetID(PrintExpr(mul->b), t),
+              SSAGetID(PrintExpr(addend), t)};
+    } else {
+      args = {SSAGetID(PrintExpr(lhs), t), SSAGetID(PrintExpr(rhs), t)};
+    }
+    for (int p = 0; p < t.lanes() / 2; ++p) {
+      this->PrintIndent();
+      stream << PackedPair(sret, t, p) << " = " << packed << "(";
+      for (size_t k = 0; k < args.size(); ++k) {
+        stream << (k == 0 ? "" : ", ") << PackedPair(args[k], t, p);
+      }
+      stream << ");\n";
+    }
+  } else {
     // Unpack into individual ops.
     std::string vlhs = SSAGetID(PrintExpr(lhs), lhs.dtype());
     std::string vrhs = SSAGetID(PrintExpr(rhs), rhs.dtype());
@@ -616,7 +693,16 @@ void CodeGenTileLangHIP::VisitExpr_(const CastNode *op, std::ostream &os) {
   this->PrintIndent();
   this->PrintType(target_ty, stream);
   stream << ' ' << sret << ";\n";
-  {
+  std::string packed = PackedConversion(from_ty, target_ty);
+  if (!packed.empty()) {
+    // Convert pairs of lanes between float and fp16 at once.
+    std::string src = SSAGetID(PrintExpr(op->value), from_ty);
+    for (int p = 0; p < from_ty.lanes() / 2; ++p) {
+      this->PrintIndent();
+      stream << PackedPair(sret, target_ty, p) << " = " << packed << "("
+             << PackedPair(src, from_ty, p) << ");\n";
+    }
+  } else {
     std::string src = SSAGetID(PrintExpr(op->value), from_ty);
     for (int i = 0, lanes = from_ty.lanes(); i < lanes; ++i) {
       std::ostringstream val;
@@ -24,6 +24,7 @@
 
 #include <tvm/arith/analyzer.h>
 #include <tvm/tir/builtin.h>
+#include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
 #include <algorithm>
@@ -33,6 +34,7 @@
 #include <utility>
 #include <vector>
 
+#include "../op/builtin.h"
 #include "arith/pattern_match.h"
 #include "runtime/meta_data.h"
 #include "runtime/thread_storage_scope.h"
@@ -101,10 +103,120 @@ private:
   WebGPUWorkGroupInfo info_;
 };
 
+/*!
+ * \brief Decide the WGSL element type of storage and workgroup arrays.
+ *
+ * - A storage buffer whose accesses are all aligned vectors of the same width
+ *   is bound as array<vecN<T>>, so VectorizeLoop results become single vector
+ *   loads/stores instead of per-lane accesses.
+ * - The byte pool produced by MergeSharedMemoryAllocations is declared with
+ *   the element type it is accessed with (u32 plus bitcasts when several
+ *   32-bit types share the pool).
+ */
+class WebGPUStorageTypePlanner : public StmtExprVisitor {
+public:
+  static std::unordered_map<const VarNode *, DataType>
+  Plan(const PrimFunc &f) {
+    WebGPUStorageTypePlanner planner;
+    for (const Var &param : f->params) {
+      if (param.dtype().is_handle())
+        planner.params_.insert(param.get());
+    }
+    planner(f->body);
+    return planner.Finalize();
+  }
+
+private:
+  struct AccessInfo {
+    std::unordered_set<DataType> element_types;
+    int vector_lanes{0};
+    bool vectorizable{true};
+  };
+
+  void VisitExpr_(const VarNode *op) final {
+    // Handles used as plain values (address_of, packed calls...) keep their
+    // declared element type.
+    if (params_.count(op))
+      access_[op].vectorizable = false;
+  }
+
+  void VisitExpr_(const BufferLoadNode *op) final {
+    RecordAccess(op->buffer, op->indices, op->dtype);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const BufferStoreNode *op) final {
+    RecordAccess(op->buffer, op->indices, op->value.dtype());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const AllocateNode *op) final {
+    auto scope = runtime::StorageScope::Create(GetPtrStorageScope(op->buffer_var));
+    if (scope.rank == runtime::StorageRank::kShared &&
+        op->dtype == DataType::UInt(8)) {
+      pools_.insert(op->buffer_var.get());
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void RecordAccess(const Buffer &buffer, const Array<PrimExpr> &indices,
+                    DataType value_dtype) {
+    AccessInfo &info = access_[buffer->data.get()];
+    info.element_types.insert(value_dtype.element_of());
+    int lanes = value_dtype.lanes();
+    arith::PVar<PrimExpr> base;
+    if (indices.size() != 1 || lanes == 1 || (lanes != 2 && lanes != 4) ||
+        buffer->dtype.lanes() != 1 || value_dtype == DataType::Bool() ||
+        (info.vector_lanes != 0 && info.vector_lanes != lanes) ||
+        !arith::ramp(base, 1, lanes).Match(indices[0]) ||
+        !analyzer_.CanProveEqual(floormod(base.Eval(), lanes), 0)) {
+      info.vectorizable = false;
+      return;
+    }
+    info.vector_lanes = lanes;
+  }
+
+  std::unordered_map<const VarNode *, DataType> Finalize() {
+    std::unordered_map<const VarNode *, DataType> storage_types;
+    for (const auto &kv : access_) {
+      const AccessInfo &info = kv.second;
+      if (params_.count(kv.first) && info.vectorizable &&
+          info.element_types.size() == 1) {
+        DataType element = *info.element_types.begin();
+        if (element.bits() == 32 || (element.is_float() && element.bits() == 16))
+          storage_types[kv.first] = element.with_lanes(info.vector_lanes);
+      } else if (pools_.count(kv.first) && !info.element_types.empty()) {
+        DataType element = *info.element_types.begin();
+        if (info.element_types.size() > 1) {
+          for (DataType t : info.element_types) {
+            ICHECK_EQ(t.bits(), 32)
+                << "WebGPU: cannot share a workgroup array between element "
+                   "types of different widths";
+          }
+          element = DataType::UInt(32);
+        }
+        storage_types[kv.first] = element;
+      }
+    }
+    return storage_types;
+  }
+
+  std::unordered_set<const VarNode *> params_;
+  std::unordered_set<const VarNode *> pools_;
+  std::unordered_map<const VarNode *, AccessInfo> access_;
+  arith::Analyzer analyzer_;
+};
+
 std::string CodeGenTileLangWebGPU::Finish() {
   // Using f16 requires enable directive
   if (enable_fp16_) {
-    header_stream << "enable f16;\n\n";
+    header_stream << "enable f16;\n";
+  }
+  if (enable_subgroups_) {
+    header_stream << "enable subgroups;\n";
+  }
+  if (enable_fp16_ || enable_subgroups_) {
+    header_stream << "\n";
   }
   // WebGPU WGSL doesn't support #include.
   // We must explicitly include all the templates here.
@@ -152,6 +264,7 @@ CodeGenTileLangWebGPU::AddFunction(const PrimFunc &f, bool skip_readonly_decl) {
   func_info.name = global_symbol.value();
 
   WebGPUWorkGroupInfo info = WebGPUWorkgroupInfoCollector::Collect(f->body);
+  storage_types_ = WebGPUStorageTypePlanner::Plan(f);
 
   std::vector<Var> pod_args;
   int num_buffer = 0;
@@ -183,6 +296,10 @@ CodeGenTileLangWebGPU::AddFunction(const PrimFunc &f, bool skip_readonly_decl) {
         value_storage_type =
             boolean_storage_type_.with_lanes(value_storage_type.lanes());
       }
+      auto it = storage_types_.find(arg.get());
+      if (it != storage_types_.end()) {
+        value_storage_type = it->second;
+      }
       std::string vid = AllocVarID(arg.get());
       std::string access_mode;
       if (num_buffer != 0) {
@@ -403,6 +520,13 @@ void CodeGenTileLangWebGPU::VisitExpr_(const CallNode *op,
     // WebGPU requires shift bits to be u32.
     this->PrintExpr(EnforceU32(op->args[1]), os);
     os << ')';
+  } else if (op->op.same_as(tl::subgroup_shuffle_xor())) {
+    enable_subgroups_ = true;
+    os << "subgroupShuffleXor(";
+    this->PrintExpr(op->args[0], os);
+    os << ", ";
+    this->PrintExpr(EnforceU32(op->args[1]), os);
+    os << ')';
   } else if (op->op.same_as(builtin::if_then_else())) {
     // conditional that skips eval if cond evals to false
     std::string result = name_supply_->FreshName("condval");
@@ -480,6 +604,32 @@ void CodeGenTileLangWebGPU::VisitExpr_(const FloatImmNode *op,
   os << temp.str();
 }
 
+bool CodeGenTileLangWebGPU::IsVectorStorage(const Var &buffer_var) const {
+  auto it = storage_types_.find(buffer_var.get());
+  return it != storage_types_.end() && it->second.lanes() > 1;
+}
+
+std::string
+CodeGenTileLangWebGPU::PrintVectorStorageIndex(const PrimExpr &index,
+                                               int lanes) {
+  arith::PVar<PrimExpr> base;
+  ICHECK(arith::ramp(base, 1, lanes).Match(index))
+      << "WebGPU: expect an aligned ramp to access vector storage, but get "
+      << index;
+  // The planner proved base % lanes == 0, so the division is exact.
+  arith::Analyzer analyzer;
+  PrimExpr vec_index = analyzer.Simplify(floordiv(base.Eval(), lanes));
+  bool has_floor_div = false;
+  PostOrderVisit(vec_index, [&](const ObjectRef &obj) {
+    has_floor_div |= obj->IsInstance<FloorDivNode>() ||
+                     obj->IsInstance<FloorModNode>();
+  });
+  if (has_floor_div) {
+    vec_index = truncdiv(base.Eval(), lanes);
+  }
+  return PrintExpr(vec_index);
+}
+
 void CodeGenTileLangWebGPU::VisitExpr_(const BufferLoadNode *op,
                                        std::ostream &os) { // NOLINT(*)
   // NOTE: direct impl of load/store for correctness
@@ -497,6 +647,22 @@ void CodeGenTileLangWebGPU::VisitExpr_(const BufferLoadNode *op,
   int lanes = op->dtype.lanes();
   std::string buffer_vid = GetVarID(buffer_var.get());
 
+  if (IsVectorStorage(buffer_var)) {
+    // Aligned vector load from a vecN storage binding.
+    os << buffer_vid << "[" << PrintVectorStorageIndex(index, lanes) << "]";
+    return;
+  }
+  // Elements of a shared workgroup pool may be stored as u32.
+  std::string cast_begin, cast_end;
+  auto storage_it = storage_types_.find(buffer_var.get());
+  if (storage_it != storage_types_.end() &&
+      storage_it->second != value_dtype.element_of()) {
+    std::ostringstream type_os;
+    PrintType(value_dtype.element_of(), type_os);
+    cast_begin = "bitcast<" + type_os.str() + ">(";
+    cast_end = ")";
+  }
+
   if (value_dtype.lanes() == element_dtype.lanes()) {
     // Direct buffer loading
     // Special handle bool loading
@@ -507,7 +673,8 @@ void CodeGenTileLangWebGPU::VisitExpr_(const BufferLoadNode *op,
       ICHECK(value_dtype == element_dtype);
     }
     ICHECK_EQ(index.dtype().lanes(), 1);
-    os << buffer_vid << "[" << this->PrintExpr(index) << "]";
+    os << cast_begin << buffer_vid << "[" << this->PrintExpr(index) << "]"
+       << cast_end;
     // Special handle bool loading
     if (value_dtype == DataType::Bool()) {
       os << ")";
@@ -527,7 +694,8 @@ void CodeGenTileLangWebGPU::VisitExpr_(const BufferLoadNode *op,
       for (int i = 0; i < lanes; ++i) {
         if (i != 0)
           os << ", ";
-        os << buffer_vid << "[" << base_vid << " + " << i << "]";
+        os << cast_begin << buffer_vid << "[" << base_vid << " + " << i << "]"
+           << cast_end;
       }
       os << ")";
     } else {
@@ -538,7 +706,8 @@ void CodeGenTileLangWebGPU::VisitExpr_(const BufferLoadNode *op,
       for (int i = 0; i < lanes; ++i) {
         if (i != 0)
           os << ", ";
-        os << buffer_vid << "[" << index_vid << "[" << i << "]]";
+        os << cast_begin << buffer_vid << "[" << index_vid << "[" << i << "]]"
+           << cast_end;
       }
       os << ")";
     }
@@ -570,11 +739,31 @@ void CodeGenTileLangWebGPU::VisitStmt_(const BufferStoreNode *op) {
 
   std::string buffer_vid = GetVarID(buffer_var.get());
 
+  if (IsVectorStorage(buffer_var)) {
+    // Aligned vector store into a vecN storage binding.
+    std::string index_vid =
+        PrintVectorStorageIndex(index, value_dtype.lanes());
+    std::string value_vid = PrintExpr(op->value);
+    this->PrintIndent();
+    stream << buffer_vid << "[" << index_vid << "] = " << value_vid << ";\n";
+    return;
+  }
+  // Elements of a shared workgroup pool may be stored as u32.
+  std::string cast_begin, cast_end;
+  auto storage_it = storage_types_.find(buffer_var.get());
+  if (storage_it != storage_types_.end() &&
+      storage_it->second != value_dtype.element_of()) {
+    std::ostringstream type_os;
+    PrintType(storage_it->second, type_os);
+    cast_begin = "bitcast<" + type_os.str() + ">(";
+    cast_end = ")";
+  }
+
   if (value_dtype.lanes() == element_dtype.lanes()) {
     // must execute print expr first
     // so we won't have recursive append to stream
     std::string index_vid = PrintExpr(index);
-    std::string value_vid = PrintExpr(op->value);
+    std::string value_vid = cast_begin + PrintExpr(op->value) + cast_end;
     // now print the assignment line.
     this->PrintIndent();
     stream << buffer_vid << "[" << index_vid << "] = ";
@@ -606,7 +795,8 @@ void CodeGenTileLangWebGPU::VisitStmt_(const BufferStoreNode *op) {
       for (int i = 0; i < value_dtype.lanes(); ++i) {
         this->PrintIndent();
         stream << buffer_vid << "[" << base_vid << " + " << i
-               << "] = " << value_vid << "[" << i << "];\n";
+               << "] = " << cast_begin << value_vid << "[" << i << "]"
+               << cast_end << ";\n";
       }
     } else {
       // buf[index[0]] = value[0]
@@ -615,7 +805,8 @@ void CodeGenTileLangWebGPU::VisitStmt_(const BufferStoreNode *op) {
       for (int i = 0; i < value_dtype.lanes(); ++i) {
         this->PrintIndent();
         stream << buffer_vid << "[" << index_vid << "[" << i
-               << "]] = " << value_vid << "[" << i << "];\n";
+               << "]] = " << cast_begin << value_vid << "[" << i << "]"
+               << cast_end << ";\n";
       }
     }
   }
@@ -631,8 +822,15 @@ void CodeGenTileLangWebGPU::VisitStmt_(const AllocateNode *op) {
       runtime::StorageScope::Create(GetPtrStorageScope(op->buffer_var));
 
   if (storage_scope.rank == runtime::StorageRank::kShared) {
+    DataType dtype = op->dtype;
+    auto it = storage_types_.find(op->buffer_var.get());
+    if (it != storage_types_.end()) {
+      // Merged byte pool, declare it with the element type it is used as.
+      constant_size = constant_size * dtype.bytes() / it->second.bytes();
+      dtype = it->second;
+    }
     this->decl_stream << "var<workgroup> " << vid << " : array<";
-    PrintType(op->dtype, this->decl_stream);
+    PrintType(dtype, this->decl_stream);
     this->decl_stream << ", " << constant_size << ">;\n";
   } else if (storage_scope.rank == runtime::StorageRank::kLocal) {
     // TODO(Charlie): These code would cause non-uniformity as it introduces
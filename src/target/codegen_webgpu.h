@@ -30,6 +30,7 @@
 #include <tvm/target/codegen.h>
 
 #include <string>
+#include <unordered_map>
 
 #include "target/source/codegen_c.h"
 
@@ -84,6 +85,14 @@ private:
    * \brief Enforce value to be U32.
    */
   static PrimExpr EnforceU32(PrimExpr value);
+  /*!
+   * \brief Whether the buffer is bound as an array of vectors.
+   */
+  bool IsVectorStorage(const Var &buffer_var) const;
+  /*!
+   * \brief Print the element index of an aligned ramp into vector storage.
+   */
+  std::string PrintVectorStorageIndex(const PrimExpr &index, int lanes);
   /*!
    * \brief Storage type of bool values.
    */
@@ -91,6 +100,10 @@ private:
 
   // whether enable fp16
   bool enable_fp16_{false};
+  // whether enable subgroup operations
+  bool enable_subgroups_{false};
+  // storage element type of buffers that differs from the declared one
+  std::unordered_map<const VarNode *, DataType> storage_types_;
 
   /*! \brief the header stream for function label and enable directive if any,
    * goes before any other declaration */
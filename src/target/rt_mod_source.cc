@@ -0,0 +1,94 @@
+/*!
+ * \file rt_mod_source.cc
+ * \brief Source-only builds of CUDA and HIP kernels for cross-compilation.
+ *
+ * target.build.tilelang_cuda_without_compile and its HIP counterpart wrap the
+ * generated source into a CUDA or ROCm runtime module, so they exist only in
+ * builds with USE_CUDA or USE_ROCM. The builds registered here return a
+ * device source module instead, which needs neither a driver nor a device,
+ * so that hosts without a GPU toolkit can generate kernels for GPU targets.
+ */
+
+#include "codegen_cuda.h"
+#include "codegen_hip.h"
+#include "target/source/source_module.h"
+
+namespace tvm {
+namespace codegen {
+
+static std::unordered_map<std::string, runtime::FunctionInfo>
+ExtractFuncInfo(const IRModule &mod) {
+  std::unordered_map<std::string, runtime::FunctionInfo> fmap;
+
+  for (auto kv : mod->functions) {
+    ICHECK(kv.second->IsInstance<tir::PrimFuncNode>())
+        << "Can only lower IR Module with PrimFuncs";
+    auto f = Downcast<tir::PrimFunc>(kv.second);
+
+    runtime::FunctionInfo info;
+    for (size_t i = 0; i < f->params.size(); ++i) {
+      info.arg_types.push_back(f->params[i].dtype());
+    }
+    if (auto opt = f->GetAttr<Array<String>>(tir::attr::kKernelLaunchParams)) {
+      for (const auto &tag : opt.value()) {
+        info.launch_param_tags.push_back(tag);
+      }
+    }
+    auto global_symbol = f->GetAttr<String>(tvm::attr::kGlobalSymbol);
+    fmap[static_cast<std::string>(global_symbol.value())] = info;
+  }
+  return fmap;
+}
+
+runtime::Module BuildTileLangCUDASource(IRModule mod, Target target) {
+  using tvm::runtime::Registry;
+  bool output_ssa = false;
+  CodeGenTileLangCUDA cg;
+  cg.Init(output_ssa);
+
+  for (auto kv : mod->functions) {
+    ICHECK(kv.second->IsInstance<PrimFuncNode>())
+        << "CodeGenTileLangCUDA: Can only take PrimFunc";
+    auto gvar = Downcast<GlobalVar>(kv.first);
+    auto f = Downcast<PrimFunc>(kv.second);
+    auto calling_conv = f->GetAttr<Integer>(tvm::attr::kCallingConv);
+    ICHECK(calling_conv == CallingConv::kDeviceKernelLaunch);
+    cg.AddFunction(gvar, f);
+  }
+
+  std::string code = cg.Finish();
+  if (const auto *f = Registry::Get("tilelang_callback_cuda_postproc")) {
+    code = (*f)(code, target).operator std::string();
+  }
+  return DeviceSourceModuleCreate(code, "cu", ExtractFuncInfo(mod), "cuda");
+}
+
+runtime::Module BuildTileLangHIPSource(IRModule mod, Target target) {
+  using tvm::runtime::Registry;
+  bool output_ssa = false;
+  CodeGenTileLangHIP cg;
+  cg.Init(output_ssa);
+
+  for (auto kv : mod->functions) {
+    ICHECK(kv.second->IsInstance<PrimFuncNode>())
+        << "CodeGenTileLangHIP: Can only take PrimFunc";
+    auto f = Downcast<PrimFunc>(kv.second);
+    auto calling_conv = f->GetAttr<Integer>(tvm::attr::kCallingConv);
+    ICHECK(calling_conv == CallingConv::kDeviceKernelLaunch);
+    cg.AddFunction(f);
+  }
+
+  std::string code = cg.Finish();
+  if (const auto *f = Registry::Get("tilelang_callback_hip_postproc")) {
+    code = (*f)(code, target).operator std::string();
+  }
+  return DeviceSourceModuleCreate(code, "hip", ExtractFuncInfo(mod), "hip");
+}
+
+TVM_REGISTER_GLOBAL("target.build.tilelang_cuda_source")
+    .set_body_typed(BuildTileLangCUDASource);
+TVM_REGISTER_GLOBAL("target.build.tilelang_hip_source")
+    .set_body_typed(BuildTileLangHIPSource);
+
+} // namespace codegen
+} // namespace tvm
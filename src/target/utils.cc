@@ -14,6 +14,12 @@ bool TargetIsCuda(Target target) {
 bool TargetIsRocm(Target target) {
   return target->GetTargetDeviceType() == kDLROCM;
 }
+bool TargetIsWebGPU(Target target) {
+  return target->GetTargetDeviceType() == kDLWebGPU;
+}
+bool TargetIsCPU(Target target) {
+  return target->GetTargetDeviceType() == kDLCPU;
+}
 
 int GetArchInt(Target target) {
   auto s = target->GetAttr<String>("arch");
@@ -97,5 +103,11 @@ bool TargetHasStmatrix(Target target) {
   return arch >= 90;
 }
 
+bool TargetHasSubgroups(Target target) {
+  if (!TargetIsWebGPU(target))
+    return false;
+  return target->GetAttr<Bool>("supports_subgroups", Bool(false)).value();
+}
+
 } // namespace tl
 } // namespace tvm
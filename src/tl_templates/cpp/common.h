@@ -3,6 +3,73 @@
 #include "half.hpp"
 #include <math.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 using half_float::half;
-// Not Implemented
\ No newline at end of file
+
+// Vector types as printed by the C codegen (float4, int8_t16, ...) for packed
+// loads, stores and arithmetic. They are GCC vector extensions aligned like
+// their elements, so packed accesses need no more alignment than scalar ones.
+#define TL_CPU_VECTOR_TYPE(T, N)                                               \
+  typedef T T##N __attribute__((vector_size(sizeof(T) * N), aligned(alignof(T))));
+#define TL_CPU_VECTOR_TYPES(T)                                                 \
+  TL_CPU_VECTOR_TYPE(T, 2)                                                     \
+  TL_CPU_VECTOR_TYPE(T, 4)                                                     \
+  TL_CPU_VECTOR_TYPE(T, 8)                                                     \
+  TL_CPU_VECTOR_TYPE(T, 16)
+
+TL_CPU_VECTOR_TYPES(float)
+TL_CPU_VECTOR_TYPES(double)
+TL_CPU_VECTOR_TYPES(int8_t)
+TL_CPU_VECTOR_TYPES(uint8_t)
+TL_CPU_VECTOR_TYPES(int16_t)
+TL_CPU_VECTOR_TYPES(uint16_t)
+TL_CPU_VECTOR_TYPES(int32_t)
+TL_CPU_VECTOR_TYPES(uint32_t)
+TL_CPU_VECTOR_TYPES(int64_t)
+TL_CPU_VECTOR_TYPES(uint64_t)
+
+#undef TL_CPU_VECTOR_TYPES
+#undef TL_CPU_VECTOR_TYPE
+
+// AtomicAdd for floating point and integer types through a compare and swap
+// loop, as __atomic_fetch_add only supports integers.
+template <typename T1, typename T2> inline void AtomicAdd(T1 *address, T2 val) {
+  T1 expected;
+  __atomic_load(address, &expected, __ATOMIC_RELAXED);
+  T1 desired;
+  do {
+    desired = static_cast<T1>(expected + static_cast<T1>(val));
+  } while (!__atomic_compare_exchange(address, &expected, &desired,
+                                      /*weak=*/true, __ATOMIC_RELAXED,
+                                      __ATOMIC_RELAXED));
+}
+
+namespace tl {
+namespace cpu {
+
+// Dot product of four 8-bit integers widened to 32 bits, the portable
+// primitive behind DP4A and the int8 gemm fallback.
+template <typename A_type, typename B_type>
+inline int32_t dot4(const A_type *a, const B_type *b) {
+  return static_cast<int32_t>(a[0]) * static_cast<int32_t>(b[0]) +
+         static_cast<int32_t>(a[1]) * static_cast<int32_t>(b[1]) +
+         static_cast<int32_t>(a[2]) * static_cast<int32_t>(b[2]) +
+         static_cast<int32_t>(a[3]) * static_cast<int32_t>(b[3]);
+}
+
+} // namespace cpu
+
+// Pull the next tile id of a dynamic persistent schedule. Every CPU worker is
+// a single thread, so no broadcast is needed.
+inline int32_t persistent_fetch_tile(int32_t *counter) {
+  return __atomic_fetch_add(counter, 1, __ATOMIC_RELAXED);
+}
+
+} // namespace tl
+
+// DP4A: c += dot(a[0:4], b[0:4]), as __dp4a on CUDA.
+template <typename InDatatype, typename OutDatatype>
+inline void DP4A(InDatatype *a, InDatatype *b, OutDatatype *c) {
+  *c += tl::cpu::dot4(a, b);
+}
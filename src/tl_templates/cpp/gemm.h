@@ -1,3 +1,40 @@
 #pragma once
 
-// Not Implemented
+#include "common.h"
+#include "gemm_int8.h"
+
+namespace tl {
+
+// C[M, N] (+)= op(A)[M, K] * op(B)[K, N] on row-major tiles whose rows are
+// lda / ldb / ldc elements apart. int8 x int8 -> int32 runs on the dot-product
+// micro-kernels of gemm_int8.h, other types accumulate in the type of C.
+template <int M, int N, int K, bool trans_A, bool trans_B, bool clear_accum,
+          int lda, int ldb, int ldc, typename A_type, typename B_type,
+          typename C_type>
+inline void gemm_cpu(A_type *pA, B_type *pB, C_type *pC) {
+  if constexpr (cpu::is_int8_gemm_v<A_type, B_type, C_type>) {
+    cpu::gemm_int8<M, N, K, trans_A, trans_B, clear_accum, lda, ldb, ldc>(
+        pA, pB, pC);
+  } else {
+    if (clear_accum) {
+      for (int i = 0; i < M; ++i) {
+        for (int j = 0; j < N; ++j) {
+          pC[i * ldc + j] = static_cast<C_type>(0);
+        }
+      }
+    }
+    for (int i = 0; i < M; ++i) {
+      C_type *c = pC + i * ldc;
+      for (int k = 0; k < K; ++k) {
+        C_type a = static_cast<C_type>(trans_A ? pA[k * lda + i]
+                                               : pA[i * lda + k]);
+        for (int j = 0; j < N; ++j) {
+          c[j] += a * static_cast<C_type>(trans_B ? pB[j * ldb + k]
+                                                  : pB[k * ldb + j]);
+        }
+      }
+    }
+  }
+}
+
+} // namespace tl
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "common.h"
+#include "gemm.h"
+#include "gemv_lut.h"
+
+namespace tl {
+namespace cpu {
+
+// Weight-only quantised gemm, C[M, N] (+)= op(A)[M, K] * W[N, K]^T.
+//
+// W is stored compressed as by tilelang.quantize.general_compress: every
+// byte of a row holds 8 / bits consecutive k, the lowest k in the lowest
+// bits. A decoder turns one such field into its value v, optional scales and
+// zeros of shape [N, K / group_size] then give w = (v - zero) * scale.
+//
+// The weights are decoded while the B panel is packed, so a compressed tile
+// is read once and never materialised in a separate float buffer: into the
+// [K][N] float panel of the generic loop, or straight into the [K / 4][N][4]
+// byte panel of the int8 dot-product kernels for int8 activations. Ternary
+// weights in the layout of gemv_lut.h are instead looked up in tables of
+// activation sums.
+namespace decode {
+
+template <int bits> struct UInt {
+  static constexpr int kBits = bits;
+  static constexpr bool kIntegral = true;
+  static int32_t apply(uint32_t q) { return static_cast<int32_t>(q); }
+};
+
+// Two's complement fields, sign extended.
+template <int bits> struct Int {
+  static constexpr int kBits = bits;
+  static constexpr bool kIntegral = true;
+  static int32_t apply(uint32_t q) {
+    return static_cast<int32_t>(q << (32 - bits)) >> (32 - bits);
+  }
+};
+
+// Unsigned fields biased by 2^(bits - 1).
+template <int bits> struct Offset {
+  static constexpr int kBits = bits;
+  static constexpr bool kIntegral = true;
+  static int32_t apply(uint32_t q) {
+    return static_cast<int32_t>(q) - (1 << (bits - 1));
+  }
+};
+
+// BitNet 1.58 weights, {-1, 0, 1} stored as 2-bit {0, 1, 2}.
+struct Ternary {
+  static constexpr int kBits = 2;
+  static constexpr bool kIntegral = true;
+  static int32_t apply(uint32_t q) { return static_cast<int32_t>(q) - 1; }
+};
+
+// s1e3 without mantissa: 0 for a zero exponent, else +-2^(e - 7).
+struct FP4 {
+  static constexpr int kBits = 4;
+  static constexpr bool kIntegral = false;
+  static float apply(uint32_t q) {
+    static constexpr float kTable[16] = {
+        0.0f,      1.0f / 64,  1.0f / 32,  1.0f / 16, 1.0f / 8,  1.0f / 4,
+        1.0f / 2,  1.0f,       0.0f,       -1.0f / 64, -1.0f / 32, -1.0f / 16,
+        -1.0f / 8, -1.0f / 4,  -1.0f / 2,  -1.0f};
+    return kTable[q & 15];
+  }
+};
+
+} // namespace decode
+
+template <typename Decoder, int ldb, typename B_type>
+inline uint32_t load_field(const B_type *pB, int j, int k) {
+  static_assert(sizeof(B_type) == 1, "compressed weights are stored in bytes");
+  constexpr int per_byte = 8 / Decoder::kBits;
+  const uint32_t byte = static_cast<uint8_t>(pB[j * ldb + k / per_byte]);
+  return (byte >> ((k % per_byte) * Decoder::kBits)) &
+         ((1u << Decoder::kBits) - 1);
+}
+
+template <int M, int N, int K, bool trans_A, bool clear_accum, int lda,
+          int ldb, int ldc, typename Decoder, int group_size, int lds,
+          bool has_scale, bool has_zeros, typename A_type, typename B_type,
+          typename S_type, typename C_type>
+inline void gemm_dequant(const A_type *pA, const B_type *pB,
+                         const S_type *pScale, const S_type *pZeros,
+                         C_type *pC) {
+  static_assert(8 % Decoder::kBits == 0, "fields may not straddle bytes");
+  if constexpr (std::is_same_v<Decoder, decode::TernaryLUT>) {
+    static_assert(!trans_A && !has_scale && !has_zeros,
+                  "table lookup GEMV takes plain int8 activations");
+    gemv_lut<M, N, K, clear_accum, lda, ldb, ldc>(
+        pA, reinterpret_cast<const int8_t *>(pB), pC);
+  } else if constexpr (is_byte_int_v<A_type> && std::is_same_v<C_type, int32_t>) {
+    static_assert(Decoder::kIntegral && !has_scale && !has_zeros,
+                  "int8 activations take unscaled integer weights");
+    // Only 8-bit unsigned fields leave the signed byte range.
+    constexpr int32_t cb = std::is_same_v<Decoder, decode::UInt<8>> ? 128 : 0;
+    gemm_int8_packed<M, N, K, trans_A, clear_accum, lda, ldc>(
+        pA, cb, [&](int k, int j) {
+          return Decoder::apply(load_field<Decoder, ldb>(pB, j, k));
+        },
+        pC);
+  } else {
+    static thread_local std::vector<C_type> b_pack;
+    b_pack.resize(K * N);
+    for (int j = 0; j < N; ++j) {
+      for (int k = 0; k < K; ++k) {
+        C_type w = static_cast<C_type>(
+            Decoder::apply(load_field<Decoder, ldb>(pB, j, k)));
+        if constexpr (has_scale || has_zeros) {
+          const int s = j * lds + k / group_size;
+          if constexpr (has_zeros) {
+            w -= static_cast<C_type>(pZeros[s]);
+          }
+          if constexpr (has_scale) {
+            w *= static_cast<C_type>(pScale[s]);
+          }
+        }
+        b_pack[k * N + j] = w;
+      }
+    }
+    gemm_cpu<M, N, K, trans_A, false, clear_accum, lda, N, ldc>(
+        pA, b_pack.data(), pC);
+  }
+}
+
+} // namespace cpu
+
+// Entry points of T.gemm_dequant: the weights alone, with scales, or with
+// scales and zeros. Scale and zero pointers address the group of the first
+// row and k of the tile, group_size and the k tile must divide one another.
+template <int M, int N, int K, bool trans_A, bool clear_accum, int lda,
+          int ldb, int ldc, typename Decoder, int group_size, int lds,
+          typename A_type, typename B_type, typename C_type>
+inline void gemm_cpu_dequant(A_type *pA, B_type *pB, C_type *pC) {
+  cpu::gemm_dequant<M, N, K, trans_A, clear_accum, lda, ldb, ldc, Decoder,
+                    group_size, lds, false, false>(
+      pA, pB, static_cast<const float *>(nullptr),
+      static_cast<const float *>(nullptr), pC);
+}
+
+template <int M, int N, int K, bool trans_A, bool clear_accum, int lda,
+          int ldb, int ldc, typename Decoder, int group_size, int lds,
+          typename A_type, typename B_type, typename S_type, typename C_type>
+inline void gemm_cpu_dequant(A_type *pA, B_type *pB, S_type *pScale,
+                             C_type *pC) {
+  cpu::gemm_dequant<M, N, K, trans_A, clear_accum, lda, ldb, ldc, Decoder,
+                    group_size, lds, true, false>(
+      pA, pB, pScale, static_cast<const S_type *>(nullptr), pC);
+}
+
+template <int M, int N, int K, bool trans_A, bool clear_accum, int lda,
+          int ldb, int ldc, typename Decoder, int group_size, int lds,
+          typename A_type, typename B_type, typename S_type, typename C_type>
+inline void gemm_cpu_dequant(A_type *pA, B_type *pB, S_type *pScale,
+                             S_type *pZeros, C_type *pC) {
+  cpu::gemm_dequant<M, N, K, trans_A, clear_accum, lda, ldb, ldc, Decoder,
+                    group_size, lds, true, true>(pA, pB, pScale, pZeros, pC);
+}
+
+} // namespace tl
@@ -0,0 +1,340 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define TL_CPU_HAS_AVX512_VNNI 1
+#if defined(__clang__) || __GNUC__ >= 11
+#define TL_CPU_HAS_AVX_VNNI 1
+#endif
+#endif
+
+#if defined(__aarch64__) && defined(__linux__) && defined(__GNUC__)
+#include <arm_neon.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#define TL_CPU_HAS_SDOT 1
+#endif
+
+namespace tl {
+namespace cpu {
+
+// int8 x int8 -> int32 tile gemm.
+//
+// Both operands are packed into 8-bit values p with a = pa + ca and
+// b = pb + cb, so that
+//
+//   sum_k a * b = sum_k pa * pb + cb * rowsum(pa) + ca * colsum(pb) + ca*cb*K.
+//
+// A is packed row by row in groups of four k, B as [K / 4][N][4] so that
+// four consecutive bytes hold the four k of one column. The dot-product
+// instructions then multiply a broadcast group of A with 16 (VNNI) or 4
+// (SDOT) columns at once. VNNI multiplies unsigned by signed bytes, so A is
+// packed as unsigned for it and as signed for the other kernels.
+
+enum class Int8Kernel { kPortable, kAVXVNNI, kAVX512VNNI, kSDOT };
+
+inline bool int8_kernel_supported(Int8Kernel kernel) {
+  switch (kernel) {
+  case Int8Kernel::kPortable:
+    return true;
+#if defined(TL_CPU_HAS_AVX512_VNNI)
+  case Int8Kernel::kAVX512VNNI:
+    return __builtin_cpu_supports("avx512vnni") &&
+           __builtin_cpu_supports("avx512bw");
+#endif
+#if defined(TL_CPU_HAS_AVX_VNNI)
+  case Int8Kernel::kAVXVNNI:
+    return __builtin_cpu_supports("avxvnni");
+#endif
+#if defined(TL_CPU_HAS_SDOT)
+  case Int8Kernel::kSDOT:
+    return (getauxval(AT_HWCAP) & HWCAP_ASIMDDP) != 0;
+#endif
+  default:
+    return false;
+  }
+}
+
+// The widest kernel the host supports, TL_CPU_INT8_KERNEL (portable, avxvnni,
+// avx512vnni or sdot) selects another supported one.
+inline Int8Kernel int8_kernel() {
+  static const Int8Kernel value = [] {
+    if (const char *env = std::getenv("TL_CPU_INT8_KERNEL")) {
+      const std::pair<const char *, Int8Kernel> names[] = {
+          {"portable", Int8Kernel::kPortable},
+          {"avxvnni", Int8Kernel::kAVXVNNI},
+          {"avx512vnni", Int8Kernel::kAVX512VNNI},
+          {"sdot", Int8Kernel::kSDOT}};
+      for (const auto &[name, kernel] : names) {
+        if (std::strcmp(env, name) == 0 && int8_kernel_supported(kernel)) {
+          return kernel;
+        }
+      }
+    }
+    for (Int8Kernel kernel : {Int8Kernel::kAVX512VNNI, Int8Kernel::kAVXVNNI,
+                              Int8Kernel::kSDOT}) {
+      if (int8_kernel_supported(kernel)) {
+        return kernel;
+      }
+    }
+    return Int8Kernel::kPortable;
+  }();
+  return value;
+}
+
+inline const char *int8_kernel_name() {
+  switch (int8_kernel()) {
+  case Int8Kernel::kAVXVNNI:
+    return "avxvnni";
+  case Int8Kernel::kAVX512VNNI:
+    return "avx512vnni";
+  case Int8Kernel::kSDOT:
+    return "sdot";
+  default:
+    return "portable";
+  }
+}
+
+inline int32_t load_group(const int8_t *p) {
+  int32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+// out[M][Np] = sum_q dot4(A[i][q], B[q][j]) for packed operands.
+inline void dot_tiles_portable(const int8_t *A, const int8_t *B, int32_t *out,
+                               int M, int Np, int Kq) {
+  for (int i = 0; i < M; ++i) {
+    int32_t *row = out + i * Np;
+    std::memset(row, 0, sizeof(int32_t) * Np);
+    for (int q = 0; q < Kq; ++q) {
+      const int8_t *a = A + (i * Kq + q) * 4;
+      const int8_t *b = B + q * Np * 4;
+      for (int j = 0; j < Np; ++j) {
+        row[j] += dot4(a, b + j * 4);
+      }
+    }
+  }
+}
+
+#if defined(TL_CPU_HAS_AVX512_VNNI)
+__attribute__((target("avx512f,avx512bw,avx512vnni"))) inline void
+dot_tiles_avx512vnni(const int8_t *A, const int8_t *B, int32_t *out, int M,
+                     int Np, int Kq) {
+  int i = 0;
+  // Four rows share every load of B.
+  for (; i + 4 <= M; i += 4) {
+    for (int j = 0; j < Np; j += 16) {
+      __m512i acc0 = _mm512_setzero_si512(), acc1 = _mm512_setzero_si512();
+      __m512i acc2 = _mm512_setzero_si512(), acc3 = _mm512_setzero_si512();
+      for (int q = 0; q < Kq; ++q) {
+        __m512i b = _mm512_loadu_si512(B + (q * Np + j) * 4);
+        acc0 = _mm512_dpbusd_epi32(
+            acc0, _mm512_set1_epi32(load_group(A + ((i + 0) * Kq + q) * 4)),
+            b);
+        acc1 = _mm512_dpbusd_epi32(
+            acc1, _mm512_set1_epi32(load_group(A + ((i + 1) * Kq + q) * 4)),
+            b);
+        acc2 = _mm512_dpbusd_epi32(
+            acc2, _mm512_set1_epi32(load_group(A + ((i + 2) * Kq + q) * 4)),
+            b);
+        acc3 = _mm512_dpbusd_epi32(
+            acc3, _mm512_set1_epi32(load_group(A + ((i + 3) * Kq + q) * 4)),
+            b);
+      }
+      _mm512_storeu_si512(out + (i + 0) * Np + j, acc0);
+      _mm512_storeu_si512(out + (i + 1) * Np + j, acc1);
+      _mm512_storeu_si512(out + (i + 2) * Np + j, acc2);
+      _mm512_storeu_si512(out + (i + 3) * Np + j, acc3);
+    }
+  }
+  for (; i < M; ++i) {
+    for (int j = 0; j < Np; j += 16) {
+      __m512i acc = _mm512_setzero_si512();
+      for (int q = 0; q < Kq; ++q) {
+        acc = _mm512_dpbusd_epi32(
+            acc, _mm512_set1_epi32(load_group(A + (i * Kq + q) * 4)),
+            _mm512_loadu_si512(B + (q * Np + j) * 4));
+      }
+      _mm512_storeu_si512(out + i * Np + j, acc);
+    }
+  }
+}
+#endif
+
+#if defined(TL_CPU_HAS_AVX_VNNI)
+__attribute__((target("avx2,avxvnni"))) inline void
+dot_tiles_avxvnni(const int8_t *A, const int8_t *B, int32_t *out, int M,
+                  int Np, int Kq) {
+  int i = 0;
+  for (; i + 4 <= M; i += 4) {
+    for (int j = 0; j < Np; j += 8) {
+      __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+      __m256i acc2 = _mm256_setzero_si256(), acc3 = _mm256_setzero_si256();
+      for (int q = 0; q < Kq; ++q) {
+        __m256i b = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(B + (q * Np + j) * 4));
+        acc0 = _mm256_dpbusd_avx_epi32(
+            acc0, _mm256_set1_epi32(load_group(A + ((i + 0) * Kq + q) * 4)),
+            b);
+        acc1 = _mm256_dpbusd_avx_epi32(
+            acc1, _mm256_set1_epi32(load_group(A + ((i + 1) * Kq + q) * 4)),
+            b);
+        acc2 = _mm256_dpbusd_avx_epi32(
+            acc2, _mm256_set1_epi32(load_group(A + ((i + 2) * Kq + q) * 4)),
+            b);
+        acc3 = _mm256_dpbusd_avx_epi32(
+            acc3, _mm256_set1_epi32(load_group(A + ((i + 3) * Kq + q) * 4)),
+            b);
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + (i + 0) * Np + j),
+                          acc0);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + (i + 1) * Np + j),
+                          acc1);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + (i + 2) * Np + j),
+                          acc2);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + (i + 3) * Np + j),
+                          acc3);
+    }
+  }
+  for (; i < M; ++i) {
+    for (int j = 0; j < Np; j += 8) {
+      __m256i acc = _mm256_setzero_si256();
+      for (int q = 0; q < Kq; ++q) {
+        acc = _mm256_dpbusd_avx_epi32(
+            acc, _mm256_set1_epi32(load_group(A + (i * Kq + q) * 4)),
+            _mm256_loadu_si256(
+                reinterpret_cast<const __m256i *>(B + (q * Np + j) * 4)));
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i * Np + j), acc);
+    }
+  }
+}
+#endif
+
+#if defined(TL_CPU_HAS_SDOT)
+__attribute__((target("arch=armv8.2-a+dotprod"))) inline void
+dot_tiles_sdot(const int8_t *A, const int8_t *B, int32_t *out, int M, int Np,
+               int Kq) {
+  for (int i = 0; i < M; ++i) {
+    for (int j = 0; j < Np; j += 16) {
+      int32x4_t acc0 = vdupq_n_s32(0), acc1 = vdupq_n_s32(0);
+      int32x4_t acc2 = vdupq_n_s32(0), acc3 = vdupq_n_s32(0);
+      for (int q = 0; q < Kq; ++q) {
+        int8x16_t a = vreinterpretq_s8_s32(
+            vdupq_n_s32(load_group(A + (i * Kq + q) * 4)));
+        const int8_t *b = B + (q * Np + j) * 4;
+        acc0 = vdotq_s32(acc0, vld1q_s8(b), a);
+        acc1 = vdotq_s32(acc1, vld1q_s8(b + 16), a);
+        acc2 = vdotq_s32(acc2, vld1q_s8(b + 32), a);
+        acc3 = vdotq_s32(acc3, vld1q_s8(b + 48), a);
+      }
+      vst1q_s32(out + i * Np + j, acc0);
+      vst1q_s32(out + i * Np + j + 4, acc1);
+      vst1q_s32(out + i * Np + j + 8, acc2);
+      vst1q_s32(out + i * Np + j + 12, acc3);
+    }
+  }
+}
+#endif
+
+template <typename T>
+constexpr bool is_byte_int_v =
+    std::is_same_v<T, int8_t> || std::is_same_v<T, uint8_t>;
+
+template <typename A_type, typename B_type, typename C_type>
+constexpr bool is_int8_gemm_v = is_byte_int_v<A_type> && is_byte_int_v<B_type> &&
+                                std::is_same_v<C_type, int32_t>;
+
+// Packs B through load_b(k, j), which returns op(B)[k][j] such that
+// op(B)[k][j] - cb fits a signed byte. Quantised weights are decoded through
+// it straight into the packed panel, see gemm_dequant.h.
+template <int M, int N, int K, bool trans_A, bool clear_accum, int lda,
+          int ldc, typename A_type, typename LoadB>
+inline void gemm_int8_packed(const A_type *pA, int32_t cb, LoadB load_b,
+                             int32_t *pC) {
+  constexpr int Kq = (K + 3) / 4;
+  constexpr int Np = (N + 15) / 16 * 16;
+  const Int8Kernel kernel = int8_kernel();
+  const bool unsigned_a = kernel == Int8Kernel::kAVXVNNI ||
+                          kernel == Int8Kernel::kAVX512VNNI;
+  const int32_t ca = unsigned_a ? (std::is_signed_v<A_type> ? -128 : 0)
+                                : (std::is_signed_v<A_type> ? 0 : 128);
+
+  static thread_local std::vector<int8_t> a_pack, b_pack;
+  static thread_local std::vector<int32_t> acc, row_sum, col_sum;
+  a_pack.assign(M * Kq * 4, 0);
+  b_pack.assign(Kq * Np * 4, 0);
+  acc.resize(M * Np);
+  row_sum.assign(M, 0);
+  col_sum.assign(Np, 0);
+
+  for (int i = 0; i < M; ++i) {
+    for (int k = 0; k < K; ++k) {
+      int32_t a = trans_A ? pA[k * lda + i] : pA[i * lda + k];
+      int32_t pa = a - ca;
+      row_sum[i] += pa;
+      a_pack[i * Kq * 4 + k] = static_cast<int8_t>(static_cast<uint8_t>(pa));
+    }
+  }
+  for (int k = 0; k < K; ++k) {
+    for (int j = 0; j < N; ++j) {
+      int32_t pb = load_b(k, j) - cb;
+      col_sum[j] += pb;
+      b_pack[((k / 4) * Np + j) * 4 + k % 4] = static_cast<int8_t>(pb);
+    }
+  }
+
+  switch (kernel) {
+#if defined(TL_CPU_HAS_AVX512_VNNI)
+  case Int8Kernel::kAVX512VNNI:
+    dot_tiles_avx512vnni(a_pack.data(), b_pack.data(), acc.data(), M, Np, Kq);
+    break;
+#endif
+#if defined(TL_CPU_HAS_AVX_VNNI)
+  case Int8Kernel::kAVXVNNI:
+    dot_tiles_avxvnni(a_pack.data(), b_pack.data(), acc.data(), M, Np, Kq);
+    break;
+#endif
+#if defined(TL_CPU_HAS_SDOT)
+  case Int8Kernel::kSDOT:
+    dot_tiles_sdot(a_pack.data(), b_pack.data(), acc.data(), M, Np, Kq);
+    break;
+#endif
+  default:
+    dot_tiles_portable(a_pack.data(), b_pack.data(), acc.data(), M, Np, Kq);
+    break;
+  }
+
+  const int32_t constant = ca * cb * K;
+  for (int i = 0; i < M; ++i) {
+    for (int j = 0; j < N; ++j) {
+      int32_t v =
+          acc[i * Np + j] + cb * row_sum[i] + ca * col_sum[j] + constant;
+      pC[i * ldc + j] = clear_accum ? v : pC[i * ldc + j] + v;
+    }
+  }
+}
+
+template <int M, int N, int K, bool trans_A, bool trans_B, bool clear_accum,
+          int lda, int ldb, int ldc, typename A_type, typename B_type>
+inline void gemm_int8(const A_type *pA, const B_type *pB, int32_t *pC) {
+  gemm_int8_packed<M, N, K, trans_A, clear_accum, lda, ldc>(
+      pA, std::is_signed_v<B_type> ? 0 : 128,
+      [pB](int k, int j) -> int32_t {
+        return trans_B ? pB[j * ldb + k] : pB[k * ldb + j];
+      },
+      pC);
+}
+
+} // namespace cpu
+} // namespace tl
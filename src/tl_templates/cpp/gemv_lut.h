@@ -0,0 +1,223 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "common.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define TL_CPU_HAS_AVX2_SHUFFLE 1
+#endif
+
+#if defined(__aarch64__) && defined(__GNUC__)
+#include <arm_neon.h>
+#define TL_CPU_HAS_NEON_TBL 1
+#endif
+
+namespace tl {
+namespace cpu {
+
+// Table-lookup GEMV for ternary (1.58-bit) weights and int8 activations.
+//
+// A pair of ternary weights (w0, w1) has nine values, encoded as the 4-bit
+// index (w0 + 1) * 3 + (w1 + 1). For every pair of activations (a0, a1) a
+// 16-entry table holds w0 * a0 + w1 * a1 for all nine indices, so each pair
+// of weights costs one table lookup instead of two multiplies. The int16
+// entries are kept as a table of low and a table of high bytes, which lets
+// pshufb (x86) and tbl (AArch64) look up 32 rows at once.
+//
+// Weights are stored in blocks of 32 rows as [N / 32][K / 2][16] bytes: byte
+// b of a pair holds the index of row b in its low and of row b + 16 in its
+// high nibble, see tilelang.quantize.compress_ternary_lut.
+namespace decode {
+
+struct TernaryLUT {
+  static constexpr int kBits = 2;
+  static constexpr bool kIntegral = true;
+};
+
+} // namespace decode
+
+constexpr int kLUTRows = 32;
+// int16 partial sums are widened every kLUTFlush pairs; |entry| <= 256.
+constexpr int kLUTFlush = 64;
+
+enum class LUTKernel { kPortable, kAVX2, kNEON };
+
+// The host's shuffle kernel, TL_CPU_LUT_KERNEL=portable forces the scalar one.
+inline LUTKernel lut_kernel() {
+  static const LUTKernel value = [] {
+    const char *env = std::getenv("TL_CPU_LUT_KERNEL");
+    if (env && std::strcmp(env, "portable") == 0) {
+      return LUTKernel::kPortable;
+    }
+#if defined(TL_CPU_HAS_AVX2_SHUFFLE)
+    if (__builtin_cpu_supports("avx2")) {
+      return LUTKernel::kAVX2;
+    }
+#endif
+#if defined(TL_CPU_HAS_NEON_TBL)
+    return LUTKernel::kNEON;
+#endif
+    return LUTKernel::kPortable;
+  }();
+  return value;
+}
+
+template <typename A_type>
+inline void build_ternary_lut(const A_type *a, int pairs, int8_t *lo,
+                              int8_t *hi) {
+  for (int p = 0; p < pairs; ++p) {
+    const int32_t a0 = a[2 * p], a1 = a[2 * p + 1];
+    const int32_t v[16] = {-a0 - a1, -a0, -a0 + a1, -a1, 0, a1, a0 - a1, a0,
+                           a0 + a1};
+    for (int e = 0; e < 16; ++e) {
+      const uint16_t bits = static_cast<uint16_t>(v[e]);
+      lo[p * 16 + e] = static_cast<int8_t>(bits & 0xFF);
+      hi[p * 16 + e] = static_cast<int8_t>(bits >> 8);
+    }
+  }
+}
+
+// out[32] = sum over pairs of the looked up entries of one block of rows.
+inline void lut_rows_portable(const uint8_t *w, const int8_t *lo,
+                              const int8_t *hi, int pairs, int32_t *out) {
+  std::memset(out, 0, sizeof(int32_t) * kLUTRows);
+  for (int p = 0; p < pairs; ++p) {
+    const uint8_t *x = w + p * 16;
+    for (int r = 0; r < kLUTRows; ++r) {
+      const int idx = r < 16 ? x[r] & 15 : x[r - 16] >> 4;
+      const uint16_t bits = static_cast<uint8_t>(lo[p * 16 + idx]) |
+                            static_cast<uint8_t>(hi[p * 16 + idx]) << 8;
+      out[r] += static_cast<int16_t>(bits);
+    }
+  }
+}
+
+#if defined(TL_CPU_HAS_AVX2_SHUFFLE)
+__attribute__((target("avx2"))) inline void
+lut_rows_avx2(const uint8_t *w, const int8_t *lo, const int8_t *hi, int pairs,
+              int32_t *out) {
+  const __m256i mask = _mm256_set1_epi8(0x0F);
+  // Rows 0-7, 8-15, 16-23 and 24-31.
+  __m256i sum0 = _mm256_setzero_si256(), sum1 = _mm256_setzero_si256();
+  __m256i sum2 = _mm256_setzero_si256(), sum3 = _mm256_setzero_si256();
+  for (int p0 = 0; p0 < pairs; p0 += kLUTFlush) {
+    // Rows 0-7 | 16-23 and 8-15 | 24-31, as unpack works within lanes.
+    __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+    for (int p = p0, end = std::min(pairs, p0 + kLUTFlush); p < end; ++p) {
+      const __m128i x =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(w + p * 16));
+      const __m256i idx =
+          _mm256_and_si256(_mm256_set_m128i(_mm_srli_epi16(x, 4), x), mask);
+      const __m256i tlo = _mm256_broadcastsi128_si256(
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(lo + p * 16)));
+      const __m256i thi = _mm256_broadcastsi128_si256(
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(hi + p * 16)));
+      const __m256i vlo = _mm256_shuffle_epi8(tlo, idx);
+      const __m256i vhi = _mm256_shuffle_epi8(thi, idx);
+      acc0 = _mm256_add_epi16(acc0, _mm256_unpacklo_epi8(vlo, vhi));
+      acc1 = _mm256_add_epi16(acc1, _mm256_unpackhi_epi8(vlo, vhi));
+    }
+    sum0 = _mm256_add_epi32(
+        sum0, _mm256_cvtepi16_epi32(_mm256_castsi256_si128(acc0)));
+    sum1 = _mm256_add_epi32(
+        sum1, _mm256_cvtepi16_epi32(_mm256_castsi256_si128(acc1)));
+    sum2 = _mm256_add_epi32(
+        sum2, _mm256_cvtepi16_epi32(_mm256_extracti128_si256(acc0, 1)));
+    sum3 = _mm256_add_epi32(
+        sum3, _mm256_cvtepi16_epi32(_mm256_extracti128_si256(acc1, 1)));
+  }
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), sum0);
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 8), sum1);
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 16), sum2);
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 24), sum3);
+}
+#endif
+
+#if defined(TL_CPU_HAS_NEON_TBL)
+inline void lut_rows_neon(const uint8_t *w, const int8_t *lo, const int8_t *hi,
+                          int pairs, int32_t *out) {
+  const uint8x16_t mask = vdupq_n_u8(0x0F);
+  int32x4_t sum[8];
+  for (int i = 0; i < 8; ++i) {
+    sum[i] = vdupq_n_s32(0);
+  }
+  for (int p0 = 0; p0 < pairs; p0 += kLUTFlush) {
+    // acc[r] holds rows 8r to 8r + 7.
+    int16x8_t acc[4] = {vdupq_n_s16(0), vdupq_n_s16(0), vdupq_n_s16(0),
+                        vdupq_n_s16(0)};
+    for (int p = p0, end = std::min(pairs, p0 + kLUTFlush); p < end; ++p) {
+      const uint8x16_t x = vld1q_u8(w + p * 16);
+      const uint8x16_t ia = vandq_u8(x, mask), ib = vshrq_n_u8(x, 4);
+      const uint8x16_t tlo =
+          vld1q_u8(reinterpret_cast<const uint8_t *>(lo + p * 16));
+      const uint8x16_t thi =
+          vld1q_u8(reinterpret_cast<const uint8_t *>(hi + p * 16));
+      const uint8x16_t la = vqtbl1q_u8(tlo, ia), ha = vqtbl1q_u8(thi, ia);
+      const uint8x16_t lb = vqtbl1q_u8(tlo, ib), hb = vqtbl1q_u8(thi, ib);
+      acc[0] = vaddq_s16(acc[0], vreinterpretq_s16_u8(vzip1q_u8(la, ha)));
+      acc[1] = vaddq_s16(acc[1], vreinterpretq_s16_u8(vzip2q_u8(la, ha)));
+      acc[2] = vaddq_s16(acc[2], vreinterpretq_s16_u8(vzip1q_u8(lb, hb)));
+      acc[3] = vaddq_s16(acc[3], vreinterpretq_s16_u8(vzip2q_u8(lb, hb)));
+    }
+    for (int r = 0; r < 4; ++r) {
+      sum[2 * r] = vaddw_s16(sum[2 * r], vget_low_s16(acc[r]));
+      sum[2 * r + 1] = vaddw_high_s16(sum[2 * r + 1], acc[r]);
+    }
+  }
+  for (int i = 0; i < 8; ++i) {
+    vst1q_s32(out + 4 * i, sum[i]);
+  }
+}
+#endif
+
+// C[M, N] (+)= A[M, K] * W[N, K]^T for ternary W in the block layout above,
+// the table of a row of A is built once and shared by all blocks of W.
+template <int M, int N, int K, bool clear_accum, int lda, int ldb, int ldc,
+          typename A_type>
+inline void gemv_lut(const A_type *pA, const int8_t *pB, int32_t *pC) {
+  static_assert(std::is_same_v<A_type, int8_t>,
+                "table lookup GEMV takes int8 activations");
+  static_assert(N % kLUTRows == 0 && K % 2 == 0,
+                "table lookup GEMV tiles rows by 32 and k by pairs");
+  constexpr int pairs = K / 2;
+  static thread_local std::vector<int8_t> lo, hi;
+  lo.resize(pairs * 16);
+  hi.resize(pairs * 16);
+  const LUTKernel kernel = lut_kernel();
+  int32_t out[kLUTRows];
+  for (int i = 0; i < M; ++i) {
+    build_ternary_lut(pA + i * lda, pairs, lo.data(), hi.data());
+    for (int nb = 0; nb < N / kLUTRows; ++nb) {
+      const uint8_t *w = reinterpret_cast<const uint8_t *>(pB + nb * ldb);
+      switch (kernel) {
+#if defined(TL_CPU_HAS_AVX2_SHUFFLE)
+      case LUTKernel::kAVX2:
+        lut_rows_avx2(w, lo.data(), hi.data(), pairs, out);
+        break;
+#endif
+#if defined(TL_CPU_HAS_NEON_TBL)
+      case LUTKernel::kNEON:
+        lut_rows_neon(w, lo.data(), hi.data(), pairs, out);
+        break;
+#endif
+      default:
+        lut_rows_portable(w, lo.data(), hi.data(), pairs, out);
+        break;
+      }
+      int32_t *c = pC + i * ldc + nb * kLUTRows;
+      for (int r = 0; r < kLUTRows; ++r) {
+        c[r] = clear_accum ? out[r] : c[r] + out[r];
+      }
+    }
+  }
+}
+
+} // namespace cpu
+} // namespace tl
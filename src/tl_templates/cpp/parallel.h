@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tl {
+namespace cpu {
+
+// Number of host threads that run worker loops, TL_NUM_THREADS overrides the
+// hardware concurrency.
+inline int num_threads() {
+  static const int value = [] {
+    if (const char *env = std::getenv("TL_NUM_THREADS")) {
+      int n = std::atoi(env);
+      if (n > 0) {
+        return n;
+      }
+    }
+    int n = static_cast<int>(std::thread::hardware_concurrency());
+    return n > 0 ? n : 1;
+  }();
+  return value;
+}
+
+// Host threads shared by all parallel_for calls of a kernel library. The
+// threads are created on first use and wait for work between launches, so a
+// launch costs a wake-up rather than a thread creation.
+class ThreadPool {
+public:
+  static ThreadPool &Global() {
+    static ThreadPool pool(num_threads() - 1);
+    return pool;
+  }
+
+  explicit ThreadPool(int num_workers) {
+    workers_.reserve(num_workers);
+    for (int i = 0; i < num_workers; ++i) {
+      workers_.emplace_back([this] { Loop(); });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto &t : workers_) {
+      t.join();
+    }
+  }
+
+  // Run task on `helpers` pool threads and on the calling thread, and return
+  // once all of them finished. A nested or concurrent call finds the pool
+  // busy and returns false without running the task.
+  bool Run(int helpers, const std::function<void()> &task) {
+    std::unique_lock<std::mutex> busy(run_mutex_, std::try_to_lock);
+    if (!busy.owns_lock()) {
+      return false;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      task_ = &task;
+      claims_ = helpers;
+      pending_ = helpers;
+      ++generation_;
+    }
+    wake_.notify_all();
+    task();
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return pending_ == 0; });
+    task_ = nullptr;
+    return true;
+  }
+
+private:
+  void Loop() {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      wake_.wait(lock, [&] {
+        return stop_ || (generation_ != seen && claims_ > 0);
+      });
+      if (stop_) {
+        return;
+      }
+      seen = generation_;
+      --claims_;
+      const std::function<void()> *task = task_;
+      lock.unlock();
+      (*task)();
+      lock.lock();
+      if (--pending_ == 0) {
+        done_.notify_one();
+      }
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::mutex run_mutex_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  const std::function<void()> *task_{nullptr};
+  uint64_t generation_{0};
+  int claims_{0};
+  int pending_{0};
+  bool stop_{false};
+};
+
+// Run f(worker) for every worker in [0, extent) on the thread pool. Workers
+// are handed out to the threads through a shared counter, so threads that
+// finish early pick up the remaining ones.
+template <typename IndexT, typename F>
+inline void parallel_for(IndexT extent, F &&f) {
+  int64_t total = static_cast<int64_t>(extent);
+  int nthreads =
+      static_cast<int>(std::min<int64_t>(num_threads(), total));
+  std::atomic<int64_t> next{0};
+  std::function<void()> run = [&]() {
+    for (int64_t i = next.fetch_add(1, std::memory_order_relaxed); i < total;
+         i = next.fetch_add(1, std::memory_order_relaxed)) {
+      f(static_cast<IndexT>(i));
+    }
+  };
+  if (nthreads <= 1 || !ThreadPool::Global().Run(nthreads - 1, run)) {
+    run();
+  }
+}
+
+} // namespace cpu
+} // namespace tl
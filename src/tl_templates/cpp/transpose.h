@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "common.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define TL_CPU_HAS_SSE2_UNPACK 1
+#endif
+
+#if defined(__aarch64__) && defined(__GNUC__)
+#include <arm_neon.h>
+#define TL_CPU_HAS_NEON_ZIP 1
+#endif
+
+namespace tl {
+namespace cpu {
+
+// Transpose of a B x B block of a copy whose source is contiguous along
+// columns and whose destination is contiguous along rows:
+//
+//   dst[c * dst_stride + r] = src[r * src_stride + c]
+//
+// B rows of 16 bytes are loaded as vectors and transposed in registers with
+// log2(B) rounds of interleaves (unpack on x86, zip on AArch64), where round
+// output 2k / 2k + 1 interleaves the low / high halves of rows k and k + B / 2,
+// then stored as B contiguous vectors: 4x4 blocks of 32-bit, 8x8 of 16-bit and
+// 16x16 of 8-bit elements. Copies that convert between types or blocks of
+// other sizes move element by element.
+namespace transpose_detail {
+
+template <int B, typename S, typename D>
+inline void transpose_portable(const S *src, int64_t src_stride, D *dst,
+                               int64_t dst_stride) {
+  for (int r = 0; r < B; ++r) {
+    for (int c = 0; c < B; ++c) {
+      dst[c * dst_stride + r] = static_cast<D>(src[r * src_stride + c]);
+    }
+  }
+}
+
+#if defined(TL_CPU_HAS_SSE2_UNPACK)
+template <int bytes>
+inline void unpack(__m128i a, __m128i b, __m128i *lo, __m128i *hi) {
+  if constexpr (bytes == 1) {
+    *lo = _mm_unpacklo_epi8(a, b);
+    *hi = _mm_unpackhi_epi8(a, b);
+  } else if constexpr (bytes == 2) {
+    *lo = _mm_unpacklo_epi16(a, b);
+    *hi = _mm_unpackhi_epi16(a, b);
+  } else {
+    *lo = _mm_unpacklo_epi32(a, b);
+    *hi = _mm_unpackhi_epi32(a, b);
+  }
+}
+
+template <int B, typename T>
+inline void transpose_sse2(const T *src, int64_t src_stride, T *dst,
+                           int64_t dst_stride) {
+  __m128i row[B], next[B];
+  for (int r = 0; r < B; ++r) {
+    row[r] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + r * src_stride));
+  }
+  for (int round = 1; round < B; round *= 2) {
+    for (int k = 0; k < B / 2; ++k) {
+      unpack<sizeof(T)>(row[k], row[k + B / 2], &next[2 * k], &next[2 * k + 1]);
+    }
+    for (int r = 0; r < B; ++r) {
+      row[r] = next[r];
+    }
+  }
+  for (int c = 0; c < B; ++c) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + c * dst_stride), row[c]);
+  }
+}
+#endif
+
+#if defined(TL_CPU_HAS_NEON_ZIP)
+template <int bytes>
+inline void zip(uint8x16_t a, uint8x16_t b, uint8x16_t *lo, uint8x16_t *hi) {
+  if constexpr (bytes == 1) {
+    *lo = vzip1q_u8(a, b);
+    *hi = vzip2q_u8(a, b);
+  } else if constexpr (bytes == 2) {
+    *lo = vreinterpretq_u8_u16(
+        vzip1q_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+    *hi = vreinterpretq_u8_u16(
+        vzip2q_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+  } else {
+    *lo = vreinterpretq_u8_u32(
+        vzip1q_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+    *hi = vreinterpretq_u8_u32(
+        vzip2q_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+  }
+}
+
+template <int B, typename T>
+inline void transpose_neon(const T *src, int64_t src_stride, T *dst,
+                           int64_t dst_stride) {
+  uint8x16_t row[B], next[B];
+  for (int r = 0; r < B; ++r) {
+    row[r] = vld1q_u8(reinterpret_cast<const uint8_t *>(src + r * src_stride));
+  }
+  for (int round = 1; round < B; round *= 2) {
+    for (int k = 0; k < B / 2; ++k) {
+      zip<sizeof(T)>(row[k], row[k + B / 2], &next[2 * k], &next[2 * k + 1]);
+    }
+    for (int r = 0; r < B; ++r) {
+      row[r] = next[r];
+    }
+  }
+  for (int c = 0; c < B; ++c) {
+    vst1q_u8(reinterpret_cast<uint8_t *>(dst + c * dst_stride), row[c]);
+  }
+}
+#endif
+
+} // namespace transpose_detail
+
+template <int B, typename S, typename D>
+inline void transpose_block(const S *src, int64_t src_stride, D *dst,
+                            int64_t dst_stride) {
+  using namespace transpose_detail;
+  constexpr bool kShuffle = std::is_same_v<S, D> && sizeof(S) * B == 16 &&
+                            (sizeof(S) == 1 || sizeof(S) == 2 ||
+                             sizeof(S) == 4);
+  if constexpr (kShuffle) {
+#if defined(TL_CPU_HAS_SSE2_UNPACK)
+    transpose_sse2<B>(src, src_stride, dst, dst_stride);
+    return;
+#elif defined(TL_CPU_HAS_NEON_ZIP)
+    transpose_neon<B>(src, src_stride, dst, dst_stride);
+    return;
+#endif
+  }
+  transpose_portable<B>(src, src_stride, dst, dst_stride);
+}
+
+} // namespace cpu
+} // namespace tl
@@ -234,6 +234,19 @@ template <int y = 1, typename T> TL_DEVICE T pow_of_int(T x) {
   return result;
 }
 
+// Pull the next tile id of a dynamic persistent schedule, the first thread of
+// the block performs the atomic and broadcasts the tile to the whole block.
+TL_DEVICE int persistent_fetch_tile(int *counter) {
+  __shared__ int tile;
+  if (threadIdx.x == 0 && threadIdx.y == 0 && threadIdx.z == 0) {
+    tile = atomicAdd(counter, 1);
+  }
+  __syncthreads();
+  int result = tile;
+  __syncthreads();
+  return result;
+}
+
 // Thread partial barrier synchronization
 // https://docs.nvidia.com/cuda/parallel-thread-execution/#memory-consistency-model
 template <int barrier_id = 0, int thread_count = 0>
@@ -109,3 +109,20 @@ template <typename T1, typename T2>
 TL_DEVICE void AtomicAdd(T1 *address, T2 val) {
   atomicAdd(reinterpret_cast<T1 *>(address), static_cast<T1>(val));
 }
+
+namespace tl {
+
+// Pull the next tile id of a dynamic persistent schedule, the first thread of
+// the block performs the atomic and broadcasts the tile to the whole block.
+TL_DEVICE int persistent_fetch_tile(int *counter) {
+  __shared__ int tile;
+  if (threadIdx.x == 0 && threadIdx.y == 0 && threadIdx.z == 0) {
+    tile = atomicAdd(counter, 1);
+  }
+  __syncthreads();
+  int result = tile;
+  __syncthreads();
+  return result;
+}
+
+} // namespace tl
@@ -0,0 +1,205 @@
+/*!
+ * \file bind_symbolic_params.cc
+ * \brief Bind the symbolic tile parameters of a parsed tile program to
+ * constants.
+ *
+ * The autotuner parses a program once with its tile sizes as placeholder
+ * variables and derives every configuration from that parse. Binding has to
+ * reach buffer shapes (allocations, match buffers, buffer regions) as well as
+ * expressions, and folds the result so that shapes are plain integers again
+ * as if the program had been parsed with the constants.
+ */
+
+#include <tvm/arith/analyzer.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <unordered_map>
+
+namespace tvm {
+namespace tl {
+
+using namespace tir;
+
+class SymbolicParamBinder : public StmtExprMutator {
+public:
+  static PrimFunc Bind(PrimFunc f, const Map<Var, PrimExpr> &values) {
+    if (values.empty()) {
+      return f;
+    }
+    SymbolicParamBinder binder(values);
+    PrimFuncNode *fptr = f.CopyOnWrite();
+    Map<Var, Buffer> buffer_map;
+    for (const auto &[var, buffer] : fptr->buffer_map) {
+      buffer_map.Set(var, binder.RemapBuffer(buffer));
+    }
+    fptr->buffer_map = buffer_map;
+    fptr->body = binder(fptr->body);
+    return f;
+  }
+
+private:
+  explicit SymbolicParamBinder(const Map<Var, PrimExpr> &values) {
+    for (const auto &[var, value] : values) {
+      values_[var.get()] = value;
+    }
+  }
+
+  // Fold every outermost arithmetic expression that had a placeholder
+  // substituted, so that `T.ceildiv(N, block_M)` becomes a constant again.
+  // Arguments of handle typed calls (tl.region, access pointers, tile ops)
+  // are folded one by one.
+  PrimExpr VisitExpr(const PrimExpr &expr) final {
+    bool fold_root = fold_root_;
+    bool is_handle = expr.dtype().is_handle();
+    fold_root_ = is_handle;
+    PrimExpr result = StmtExprMutator::VisitExpr(expr);
+    fold_root_ = fold_root;
+    if (fold_root && !is_handle && !result.same_as(expr)) {
+      result = analyzer_.Simplify(result);
+    }
+    return result;
+  }
+
+  PrimExpr VisitExpr_(const VarNode *op) final {
+    auto it = values_.find(op);
+    if (it != values_.end()) {
+      return it->second;
+    }
+    return GetRef<Var>(op);
+  }
+
+  PrimExpr VisitExpr_(const BufferLoadNode *op) final {
+    BufferLoad load = Downcast<BufferLoad>(StmtExprMutator::VisitExpr_(op));
+    Buffer buffer = RemapBuffer(load->buffer);
+    if (!buffer.same_as(load->buffer)) {
+      load.CopyOnWrite()->buffer = buffer;
+    }
+    return load;
+  }
+
+  Stmt VisitStmt_(const BufferStoreNode *op) final {
+    BufferStore store = Downcast<BufferStore>(StmtExprMutator::VisitStmt_(op));
+    Buffer buffer = RemapBuffer(store->buffer);
+    if (!buffer.same_as(store->buffer)) {
+      store.CopyOnWrite()->buffer = buffer;
+    }
+    return store;
+  }
+
+  Stmt VisitStmt_(const DeclBufferNode *op) final {
+    DeclBuffer decl = Downcast<DeclBuffer>(StmtExprMutator::VisitStmt_(op));
+    Buffer buffer = RemapBuffer(decl->buffer);
+    if (!buffer.same_as(decl->buffer)) {
+      decl.CopyOnWrite()->buffer = buffer;
+    }
+    return decl;
+  }
+
+  // Launch threads keep their extent in the IterVar as well (thread_extent
+  // only rewrites the value), which later passes read from the domain.
+  Stmt VisitStmt_(const AttrStmtNode *op) final {
+    AttrStmt attr = Downcast<AttrStmt>(StmtExprMutator::VisitStmt_(op));
+    auto *iv = attr->node.as<IterVarNode>();
+    if (!iv || !iv->dom.defined()) {
+      return attr;
+    }
+    PrimExpr min = VisitExpr(iv->dom->min);
+    PrimExpr extent = VisitExpr(iv->dom->extent);
+    if (min.same_as(iv->dom->min) && extent.same_as(iv->dom->extent)) {
+      return attr;
+    }
+    IterVar new_iv = GetRef<IterVar>(iv);
+    new_iv.CopyOnWrite()->dom = Range::FromMinExtent(min, extent);
+    attr.CopyOnWrite()->node = new_iv;
+    return attr;
+  }
+
+  Stmt VisitStmt_(const BlockNode *op) final {
+    Block block = Downcast<Block>(StmtExprMutator::VisitStmt_(op));
+    Array<Buffer> alloc_buffers = block->alloc_buffers.Map(
+        [this](const Buffer &buffer) { return RemapBuffer(buffer); });
+    Array<MatchBufferRegion> match_buffers = block->match_buffers.Map(
+        [this](const MatchBufferRegion &match) {
+          return MatchBufferRegion(RemapBuffer(match->buffer),
+                                   RemapRegion(match->source));
+        });
+    auto remap_region = [this](const BufferRegion &region) {
+      return RemapRegion(region);
+    };
+    Array<BufferRegion> reads = block->reads.Map(remap_region);
+    Array<BufferRegion> writes = block->writes.Map(remap_region);
+    if (!alloc_buffers.same_as(block->alloc_buffers) ||
+        !match_buffers.same_as(block->match_buffers) ||
+        !reads.same_as(block->reads) || !writes.same_as(block->writes)) {
+      BlockNode *n = block.CopyOnWrite();
+      n->alloc_buffers = alloc_buffers;
+      n->match_buffers = match_buffers;
+      n->reads = reads;
+      n->writes = writes;
+    }
+    return block;
+  }
+
+  BufferRegion RemapRegion(const BufferRegion &region) {
+    Buffer buffer = RemapBuffer(region->buffer);
+    Array<Range> ranges = region->region.Map([this](const Range &range) {
+      return Range::FromMinExtent(VisitExpr(range->min),
+                                  VisitExpr(range->extent));
+    });
+    if (buffer.same_as(region->buffer) && ranges.same_as(region->region)) {
+      return region;
+    }
+    return BufferRegion(buffer, ranges);
+  }
+
+  // Buffers keep their data variable, so references through `buffer.data`
+  // (access pointers, layout annotations) stay valid.
+  Buffer RemapBuffer(const Buffer &buffer) {
+    auto it = buffer_remap_.find(buffer.get());
+    if (it != buffer_remap_.end()) {
+      return it->second;
+    }
+    // The buffer may first be met inside an expression; its shape is folded
+    // on its own regardless.
+    bool fold_root = fold_root_;
+    fold_root_ = true;
+    auto visit = [this](const PrimExpr &e) { return VisitExpr(e); };
+    Array<PrimExpr> shape = buffer->shape.Map(visit);
+    Array<PrimExpr> strides = buffer->strides.Map(visit);
+    PrimExpr elem_offset = buffer->elem_offset.defined()
+                               ? VisitExpr(buffer->elem_offset)
+                               : buffer->elem_offset;
+    fold_root_ = fold_root;
+    Buffer result = buffer;
+    if (!shape.same_as(buffer->shape) || !strides.same_as(buffer->strides) ||
+        !elem_offset.same_as(buffer->elem_offset)) {
+      BufferNode *n = result.CopyOnWrite();
+      n->shape = shape;
+      n->strides = strides;
+      n->elem_offset = elem_offset;
+    }
+    buffer_remap_[buffer.get()] = result;
+    return result;
+  }
+
+  std::unordered_map<const VarNode *, PrimExpr> values_;
+  std::unordered_map<const BufferNode *, Buffer> buffer_remap_;
+  arith::Analyzer analyzer_;
+  bool fold_root_{true};
+};
+
+using namespace tir::transform;
+
+tvm::transform::Pass BindSymbolicParams(Map<Var, PrimExpr> values) {
+  auto pass_func = [values](PrimFunc f, IRModule m, PassContext ctx) {
+    return SymbolicParamBinder::Bind(std::move(f), values);
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tl.BindSymbolicParams", {});
+}
+
+TVM_REGISTER_GLOBAL("tl.transform.BindSymbolicParams")
+    .set_body_typed(BindSymbolicParams);
+
+} // namespace tl
+} // namespace tvm
@@ -0,0 +1,150 @@
+/*!
+ * \file buffer_region.h
+ * \brief Buffer regions read and written by statements, shared by pipeline
+ * planning and loop invariant code motion.
+ */
+
+#ifndef TVM_TL_TRANSFORM_COMMON_BUFFER_REGION_H_
+#define TVM_TL_TRANSFORM_COMMON_BUFFER_REGION_H_
+
+#include <tvm/arith/int_set.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/stmt_functor.h>
+
+namespace tvm {
+namespace tl {
+
+using namespace tir;
+
+/*!
+ * \brief Check whether two regions have intersections.
+ * \param region1 The first region.
+ * \param region2 The second region.
+ * \return Whether region1 and region2 have intersections.
+ */
+inline bool MayConflict(Region region1, Region region2) {
+  ICHECK(region1.size() == region2.size());
+  for (size_t i = 0; i < region1.size(); i++) {
+    Range dim1 = region1[i];
+    Range dim2 = region2[i];
+    auto int_set1 = arith::IntSet::FromRange(dim1);
+    auto int_set2 = arith::IntSet::FromRange(dim2);
+    if (arith::Intersect({int_set1, int_set2}).IsNothing()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*!
+ * \brief Detect if a statement follows the global memory copy pattern:
+ *        1. Contains exactly one buffer store operation
+ *        2. Source buffer must be in global memory scope
+ *        3. Destination buffer must be in local or shared memory scope
+ */
+class BufferRegionCollector : public StmtExprVisitor {
+public:
+  BufferRegionCollector(Map<Var, Buffer> buffer_data_to_buffer)
+      : buffer_data_to_buffer_(buffer_data_to_buffer) {}
+
+  Array<BufferRegion> GetReads() const { return reads_; }
+
+  Array<BufferRegion> GetWrites() const { return writes_; }
+
+  bool GetGlobalCopyPattern() const { return is_global_copy_pattern_; }
+
+  PrimExpr GetConditonalExpr() const { return conditonal_expr; }
+
+private:
+  void VisitStmt_(const BufferStoreNode *op) final {
+    Buffer store_buffer = op->buffer;
+    Array<PrimExpr> indices = op->indices;
+    // convert indices to region
+    Array<Range> region;
+    for (const auto &index : indices) {
+      region.push_back(Range::FromMinExtent(index, 1));
+    }
+    auto store_region = BufferRegion(store_buffer, region);
+    writes_.push_back(store_region);
+
+    is_global_read_ = false;
+    this->VisitExpr(op->value);
+    if (is_global_read_ && (store_buffer.scope() == "shared" ||
+                            store_buffer.scope() == "shared.dyn")) {
+      is_global_copy_pattern_ = true;
+    }
+    is_global_read_ = false;
+  }
+
+  void VisitExpr_(const BufferLoadNode *op) final {
+    auto load_buffer = op->buffer;
+    Array<PrimExpr> indices = op->indices;
+    // convert indices to region
+    Array<Range> region;
+    for (const auto &index : indices) {
+      region.push_back(Range::FromMinExtent(index, 1));
+    }
+    auto load_region = BufferRegion(load_buffer, region);
+    reads_.push_back(load_region);
+
+    if (op->buffer.scope() == "global") {
+      is_global_read_ = true;
+    }
+  }
+
+  void VisitExpr_(const CallNode *op) final {
+    auto args = op->args;
+    if (op->op.same_as(builtin::address_of())) {
+      const BufferLoad load = Downcast<BufferLoad>(op->args[0]);
+      const BufferRegion buffer_region = BufferRegion::FullRegion(load->buffer);
+      // because we only care about the buffer itself instead of indices
+      reads_.push_back(buffer_region);
+    } else if (op->op.same_as(builtin::tvm_access_ptr())) {
+      const VarNode *buffer_var = op->args[1].as<VarNode>();
+      ICHECK(buffer_var);
+      auto it = buffer_data_to_buffer_.find(GetRef<Var>(buffer_var));
+      if (it != buffer_data_to_buffer_.end()) {
+        const Buffer &buffer = (*it).second;
+        const BufferRegion buffer_region = BufferRegion::FullRegion(buffer);
+        // because we only care about the buffer itself instead of indices
+        reads_.push_back(buffer_region);
+      }
+    } else if (op->op.same_as(tir::builtin::if_then_else())) {
+      // Simplify nested if_then_else
+      // if (cond) { if (inner_cond) { inner_then_expr } else { inner_else_expr
+      // } } else { else_expr }
+      // => if (cond && inner_cond) { inner_then_expr } else { else_expr }
+      const PrimExpr &cond = op->args[0];
+      const PrimExpr &then_expr = op->args[1];
+      const PrimExpr &else_expr = op->args[2];
+      conditonal_expr = cond;
+      this->VisitExpr(then_expr);
+      this->VisitExpr(else_expr);
+    } else {
+      StmtExprVisitor::VisitExpr_(op);
+    }
+  }
+
+  void VisitStmt_(const IfThenElseNode *op) final {
+    // Skip condition
+    this->VisitStmt(op->then_case);
+    conditonal_expr = op->condition;
+    if (op->else_case.defined()) {
+      this->VisitStmt(op->else_case.value());
+    }
+  }
+
+private:
+  Map<Var, Buffer> buffer_data_to_buffer_;
+  Array<BufferRegion> reads_;
+  Array<BufferRegion> writes_;
+  bool is_global_read_ = false;
+  bool under_buffer_store_ = false;
+  bool is_global_copy_pattern_ = false;
+  PrimExpr conditonal_expr;
+};
+
+} // namespace tl
+} // namespace tvm
+
+#endif // TVM_TL_TRANSFORM_COMMON_BUFFER_REGION_H_
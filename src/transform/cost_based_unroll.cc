@@ -0,0 +1,247 @@
+/*!
+ * \file cost_based_unroll.cc
+ * \brief Decide how far to unroll the per-thread loops of parallel loops.
+ *
+ * PartitionLoop leaves every T.Parallel loop as a nest of per-thread loops
+ * with constant extents, marked unrolled by pragma (LoopPragmaUnroll):
+ *
+ *   #pragma unroll
+ *   for (int i = 0; i < 8; ++i)
+ *     B_local[i] = A_local[i] * scale;
+ *
+ * The pragma leaves unrolling to the device compiler, so no index or
+ * predicate is folded before code generation, and the C target ignores it
+ * altogether. This pass weighs each of these loops, innermost first, by an
+ * estimate of the instructions of one iteration and of the registers that
+ * the loaded values of one iteration occupy, against a per-target budget:
+ *
+ *  - loops that fit the budget are unrolled explicitly by UnrollLoop, so that
+ *    Simplify folds their indices and SLPVectorize can pack the result;
+ *  - on CPU targets, longer loops are split, and an inner loop of 2 to 8
+ *    iterations that fits the budget is unrolled explicitly;
+ *  - the other loops are left to the pragma.
+ *
+ * GPU loops are never split: a serial outer loop would index the fragments
+ * with a runtime variable, which demotes them to local memory. Their
+ * register budget is what the fragments leave free of the per-thread budget
+ * recorded by LayoutInference (tl.register_footprint).
+ * The decision for every loop is recorded in the tl.unroll_decisions
+ * attribute of the function.
+ */
+
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <sstream>
+#include <unordered_set>
+
+#include "../op/builtin.h"
+#include "../target/utils.h"
+
+namespace tvm {
+namespace tl {
+
+using namespace tir;
+
+namespace {
+
+/*! \brief Unrolling budget of a target, per unrolled loop. */
+struct UnrollBudget {
+  // Estimated instructions of the unrolled body.
+  int64_t instructions;
+  // 32-bit registers the loaded values of the unrolled body may occupy.
+  int64_t registers;
+  // Whether loops longer than the budget may be split and partially unrolled.
+  bool split;
+};
+
+/*! \brief Estimated cost of one iteration of a loop body. */
+struct IterationCost {
+  int64_t instructions{0};
+  int64_t registers{0};
+  // False if the body keeps a loop or allocates, which is not unrolled.
+  bool unrollable{true};
+};
+
+class IterationCostEstimator : public StmtExprVisitor {
+public:
+  static IterationCost Estimate(const Stmt &body) {
+    IterationCostEstimator estimator;
+    estimator(body);
+    return estimator.cost_;
+  }
+
+private:
+  void VisitExpr(const PrimExpr &expr) final {
+    if (!expr->IsInstance<VarNode>() && !expr->IsInstance<IntImmNode>() &&
+        !expr->IsInstance<FloatImmNode>() && !expr->IsInstance<RampNode>() &&
+        !expr->IsInstance<BroadcastNode>())
+      cost_.instructions++;
+    StmtExprVisitor::VisitExpr(expr);
+  }
+
+  void VisitExpr_(const BufferLoadNode *op) final {
+    // Locals already live in registers and are counted by the footprint, and
+    // a value loaded twice occupies its registers once.
+    if (op->buffer.scope() != "local" && op->buffer.scope() != "local.var" &&
+        loads_.insert(GetRef<BufferLoad>(op)).second)
+      cost_.registers += (op->dtype.bits() * op->dtype.lanes() + 31) / 32;
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const BufferStoreNode *op) final {
+    cost_.instructions++;
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const ForNode *op) final {
+    // Inner loops chosen for full unrolling count once per iteration.
+    const int64_t *extent = as_const_int(op->extent);
+    if (op->kind != ForKind::kUnrolled || !extent ||
+        op->annotations.count(tir::attr::pragma_unroll_explicit)) {
+      cost_.unrollable = false;
+      return;
+    }
+    IterationCost inner = Estimate(op->body);
+    cost_.instructions += *extent * inner.instructions;
+    cost_.registers += *extent * inner.registers;
+    cost_.unrollable = cost_.unrollable && inner.unrollable;
+  }
+
+  void VisitStmt_(const AllocateNode *op) final { cost_.unrollable = false; }
+
+  void VisitStmt_(const WhileNode *op) final { cost_.unrollable = false; }
+
+  IterationCost cost_;
+  std::unordered_set<BufferLoad, StructuralHash, StructuralEqual> loads_;
+};
+
+class CostBasedUnroller : public StmtMutator {
+public:
+  explicit CostBasedUnroller(UnrollBudget budget) : budget_(budget) {}
+
+  Array<String> decisions;
+
+private:
+  bool Fits(const IterationCost &cost, int64_t factor) const {
+    return factor * cost.instructions <= budget_.instructions &&
+           factor * cost.registers <= budget_.registers;
+  }
+
+  Stmt VisitStmt_(const ForNode *op) final {
+    For loop = Downcast<For>(StmtMutator::VisitStmt_(op));
+    // Only the per-thread loops that LoopPragmaUnroll left to the compiler.
+    auto explicit_unroll =
+        loop->annotations.Get(tir::attr::pragma_unroll_explicit);
+    if (loop->kind != ForKind::kUnrolled || !explicit_unroll ||
+        Downcast<Bool>(explicit_unroll.value())->value ||
+        loop->annotations.size() != 1)
+      return loop;
+    const int64_t *extent = as_const_int(loop->extent);
+    if (!extent)
+      return loop;
+
+    IterationCost cost = IterationCostEstimator::Estimate(loop->body);
+    std::ostringstream os;
+    os << loop->loop_var->name_hint << ": extent " << *extent << ", "
+       << cost.instructions << " insts and " << cost.registers
+       << " regs per iteration, ";
+    if (!cost.unrollable) {
+      os << "keep, the body has a loop or an allocation";
+      decisions.push_back(os.str());
+      return loop;
+    }
+    if (Fits(cost, *extent)) {
+      os << "unroll fully";
+      decisions.push_back(os.str());
+      loop.CopyOnWrite()->annotations = {};
+      return loop;
+    }
+    if (!budget_.split) {
+      os << "keep, the loop exceeds the budget of " << budget_.instructions
+         << " insts and " << budget_.registers << " regs";
+      decisions.push_back(os.str());
+      return loop;
+    }
+    int64_t factor = 8;
+    while (factor > 1 && (*extent % factor != 0 || !Fits(cost, factor)))
+      factor /= 2;
+    if (factor == 1) {
+      os << "keep, no unroll factor dividing the extent fits the budget of "
+         << budget_.instructions << " insts and " << budget_.registers
+         << " regs";
+      decisions.push_back(os.str());
+      return loop;
+    }
+    os << "unroll by " << factor;
+    decisions.push_back(os.str());
+    DataType dtype = loop->loop_var.dtype();
+    Var outer = loop->loop_var.copy_with_suffix(".outer");
+    Var inner = loop->loop_var.copy_with_suffix(".inner");
+    PrimExpr index = loop->min + outer * make_const(dtype, factor) + inner;
+    Stmt body = Substitute(loop->body, {{loop->loop_var, index}});
+    body = For(inner, make_zero(dtype), make_const(dtype, factor),
+               ForKind::kUnrolled, body);
+    return For(outer, make_zero(dtype), make_const(dtype, *extent / factor),
+               ForKind::kSerial, body);
+  }
+
+  UnrollBudget budget_;
+};
+
+/*! \brief The budget of the target of f, false if the target is not handled. */
+bool TargetBudget(const PrimFunc &f, UnrollBudget *budget) {
+  Optional<Target> target = f->GetAttr<Target>(tvm::attr::kTarget);
+  if (!target.defined())
+    return false;
+  if (TargetIsCuda(target.value()) || TargetIsRocm(target.value())) {
+    *budget = {256, 64, false};
+    auto footprint =
+        f->GetAttr<Map<String, ObjectRef>>(attr::kRegisterFootprint);
+    if (footprint.defined()) {
+      int64_t limit =
+          Downcast<Integer>(footprint.value()["register_budget"])->value;
+      int64_t peak =
+          Downcast<Integer>(footprint.value()["peak_registers"])->value;
+      if (limit > 0)
+        budget->registers = std::max<int64_t>(limit - peak, 0);
+    }
+    return true;
+  }
+  // 16 vector registers of 128 bits.
+  if (TargetIsCPU(target.value())) {
+    *budget = {128, 64, true};
+    return true;
+  }
+  return false;
+}
+
+} // namespace
+
+tvm::transform::Pass CostBasedUnroll() {
+  using namespace tir::transform;
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    if (ctx->GetConfig<Bool>(kDisableCostBasedUnroll, Bool(false)).value()) {
+      return f;
+    }
+    UnrollBudget budget;
+    if (!TargetBudget(f, &budget)) {
+      return f;
+    }
+    CostBasedUnroller unroller(budget);
+    auto *n = f.CopyOnWrite();
+    n->body = unroller(std::move(n->body));
+    if (!unroller.decisions.empty()) {
+      f = WithAttr(std::move(f), attr::kUnrollDecisions, unroller.decisions);
+    }
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tl.CostBasedUnroll", {});
+}
+
+TVM_REGISTER_GLOBAL("tl.transform.CostBasedUnroll")
+    .set_body_typed(CostBasedUnroll);
+
+} // namespace tl
+} // namespace tvm
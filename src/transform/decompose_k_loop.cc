@@ -0,0 +1,669 @@
+/*!
+ * \file decompose_k_loop.cc
+ * \brief Split the reduction (K) loop of a tile program across blocks.
+ *
+ * Given an ordinary tile GEMM, i.e. a kernel whose body clears an accumulator,
+ * runs a (pipelined) K loop that accumulates into it and finally copies the
+ * accumulator to global memory, this pass rewrites the kernel with one of the
+ * following decomposition policies:
+ *
+ *  - split-K (tl.split_k = S): the first grid dimension is multiplied by S and
+ *    every block runs a contiguous 1/S slice of the K loop.
+ *  - stream-K (tl.stream_k_workers = W): the grid is replaced by W workers
+ *    which evenly divide the flattened (tile, k) iteration space, each worker
+ *    walking over the tile segments it owns.
+ *
+ * Partial results are reduced by turning the final global stores into atomic
+ * additions, so the output has to be zero-initialized by the caller. Tiles
+ * that a stream-K worker computes entirely keep their original epilogue.
+ * The parameters reduced that way are listed in the tl.atomic_outputs
+ * attribute of the function, so that the JIT can reject them as outputs it
+ * would allocate uninitialized (out_idx).
+ */
+
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <unordered_set>
+
+#include "../op/builtin.h"
+#include "../op/elem.h"
+#include "../op/gemm.h"
+#include "../op/gemm_sp.h"
+#include "common/attr.h"
+
+namespace tvm {
+namespace tl {
+
+using namespace tir;
+
+namespace {
+
+using VarSet = std::unordered_set<const VarNode *>;
+
+bool IsGlobalVar(const VarNode *var) {
+  if (auto *ptr = var->type_annotation.as<PointerTypeNode>()) {
+    return ptr->storage_scope.empty() || ptr->storage_scope == "global";
+  }
+  return false;
+}
+
+bool IsRegion(const CallNode *call) {
+  return call && call->op.same_as(RegionOp::Get());
+}
+
+/*!
+ * \brief Collect the data vars of the buffers read and written by a statement,
+ * looking through tile operator arguments (access pointers and regions).
+ */
+void CollectBufferAccess(const ObjectRef &node, VarSet *reads, VarSet *writes) {
+  PostOrderVisit(node, [&](const ObjectRef &obj) {
+    if (auto *store = obj.as<BufferStoreNode>()) {
+      writes->insert(store->buffer->data.get());
+    } else if (auto *load = obj.as<BufferLoadNode>()) {
+      reads->insert(load->buffer->data.get());
+    } else if (auto *call = obj.as<CallNode>()) {
+      if (call->op.same_as(builtin::tvm_access_ptr())) {
+        auto *var = call->args[1].as<VarNode>();
+        int mask = static_cast<int>(*as_const_int(call->args[4]));
+        if (var && (mask & 1))
+          reads->insert(var);
+        if (var && (mask & 2))
+          writes->insert(var);
+      } else if (IsRegion(call)) {
+        auto *load = call->args[0].as<BufferLoadNode>();
+        int mask = static_cast<int>(*as_const_int(call->args[1]));
+        if (load && (mask & 2))
+          writes->insert(load->buffer->data.get());
+      } else if (call->op.same_as(Fill::Get())) {
+        if (auto *load = call->args[0].as<BufferLoadNode>())
+          writes->insert(load->buffer->data.get());
+      }
+    }
+  });
+}
+
+bool WritesGlobal(const Stmt &stmt) {
+  VarSet reads, writes;
+  CollectBufferAccess(stmt, &reads, &writes);
+  for (const VarNode *var : writes) {
+    if (IsGlobalVar(var))
+      return true;
+  }
+  return false;
+}
+
+PrimExpr StripCast(PrimExpr value) {
+  while (auto *cast = value.as<CastNode>()) {
+    value = cast->value;
+  }
+  return value;
+}
+
+PrimExpr MakeAtomicAdd(const Buffer &dst, const Array<PrimExpr> &indices,
+                       const PrimExpr &value) {
+  PrimExpr address = Call(DataType::Handle(), builtin::address_of(),
+                          {BufferLoad(dst, indices)});
+  return Call(DataType::Handle(), builtin::call_extern(),
+              {StringImm("AtomicAdd"), address, value});
+}
+
+/*!
+ * \brief Find the accumulators updated inside the K loop: the C operand of
+ * tile gemms and local buffers updated as `acc[i] = acc[i] + ...`.
+ */
+class AccumulatorCollector : public StmtExprVisitor {
+public:
+  static VarSet Collect(const Stmt &stmt) {
+    AccumulatorCollector collector;
+    collector(stmt);
+    return collector.accumulators_;
+  }
+
+private:
+  void VisitExpr_(const CallNode *op) final {
+    if (op->op.same_as(Gemm::Get())) {
+      accumulators_.insert(GetVarFromAccessPtr(op->args[2]).get());
+    } else if (op->op.same_as(GemmSP::Get())) {
+      accumulators_.insert(GetVarFromAccessPtr(op->args[3]).get());
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const BufferStoreNode *op) final {
+    if (!IsGlobalVar(op->buffer->data.get())) {
+      if (auto *add = op->value.as<AddNode>()) {
+        for (const PrimExpr &operand : {add->a, add->b}) {
+          auto *load = operand.as<BufferLoadNode>();
+          if (load && load->buffer.same_as(op->buffer) &&
+              StructuralEqual()(load->indices, op->indices)) {
+            accumulators_.insert(op->buffer->data.get());
+          }
+        }
+      }
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  VarSet accumulators_;
+};
+
+/*!
+ * \brief Check that the epilogue only moves accumulator values to global
+ * memory, so that summing partial epilogues equals the full epilogue.
+ *
+ * A buffer is "derived" when it holds a plain copy (up to casts) of an
+ * accumulator and "tainted" when it depends on an accumulator in any other
+ * way. Every global write must come from a derived buffer.
+ */
+class EpilogueChecker : public StmtExprVisitor {
+public:
+  explicit EpilogueChecker(VarSet accumulators)
+      : derived_(std::move(accumulators)) {}
+
+  bool Check(const Stmt &stmt) {
+    (*this)(stmt);
+    return valid_;
+  }
+
+private:
+  enum class State { kNone, kDerived, kTainted };
+
+  State GetState(const VarNode *var) const {
+    if (derived_.count(var))
+      return State::kDerived;
+    if (tainted_.count(var))
+      return State::kTainted;
+    return State::kNone;
+  }
+
+  void SetState(const VarNode *var, State state) {
+    // Overwriting part of a derived buffer with unrelated data still leaves
+    // accumulator values in it.
+    if (state == State::kNone && GetState(var) != State::kNone)
+      state = State::kTainted;
+    derived_.erase(var);
+    tainted_.erase(var);
+    if (state == State::kDerived)
+      derived_.insert(var);
+    if (state == State::kTainted)
+      tainted_.insert(var);
+  }
+
+  void VisitStmt_(const EvaluateNode *op) final {
+    auto *call = op->value.as<CallNode>();
+    if (call && call->op.same_as(Copy::Get())) {
+      auto *src = call->args[0].as<CallNode>();
+      auto *dst = call->args[1].as<CallNode>();
+      ICHECK(IsRegion(src) && IsRegion(dst));
+      const VarNode *src_var =
+          src->args[0].as<BufferLoadNode>()->buffer->data.get();
+      const VarNode *dst_var =
+          dst->args[0].as<BufferLoadNode>()->buffer->data.get();
+      if (IsGlobalVar(dst_var)) {
+        valid_ &= GetState(src_var) == State::kDerived;
+      } else {
+        SetState(dst_var, GetState(src_var));
+      }
+      return;
+    }
+    VarSet reads, writes;
+    CollectBufferAccess(GetRef<Evaluate>(op), &reads, &writes);
+    bool uses_accumulator = false;
+    for (const VarNode *var : reads) {
+      uses_accumulator |= GetState(var) != State::kNone;
+    }
+    for (const VarNode *var : writes) {
+      if (IsGlobalVar(var)) {
+        valid_ = false;
+      }
+      SetState(var, uses_accumulator ? State::kTainted : State::kNone);
+    }
+  }
+
+  void VisitStmt_(const BufferStoreNode *op) final {
+    const VarNode *dst_var = op->buffer->data.get();
+    PrimExpr value = StripCast(op->value);
+    State state = State::kNone;
+    if (auto *load = value.as<BufferLoadNode>()) {
+      state = GetState(load->buffer->data.get());
+    } else {
+      VarSet reads, writes;
+      CollectBufferAccess(op->value, &reads, &writes);
+      for (const VarNode *var : reads) {
+        if (GetState(var) != State::kNone)
+          state = State::kTainted;
+      }
+    }
+    if (IsGlobalVar(dst_var)) {
+      valid_ &= state == State::kDerived;
+    } else {
+      SetState(dst_var, state);
+    }
+  }
+
+  VarSet derived_;
+  VarSet tainted_;
+  bool valid_{true};
+};
+
+/*!
+ * \brief Turn the global stores of a checked epilogue into atomic additions.
+ */
+class EpilogueAtomicRewriter : public StmtExprMutator {
+public:
+  static Stmt Rewrite(const Stmt &stmt, VarSet *reduced) {
+    EpilogueAtomicRewriter rewriter(reduced);
+    return rewriter(stmt);
+  }
+
+private:
+  explicit EpilogueAtomicRewriter(VarSet *reduced) : reduced_(reduced) {}
+
+  Stmt VisitStmt_(const EvaluateNode *op) final {
+    auto *call = op->value.as<CallNode>();
+    if (call && call->op.same_as(Copy::Get())) {
+      RegionOp src(call->args[0].as<CallNode>()->args, {});
+      RegionOp dst(call->args[1].as<CallNode>()->args, {});
+      if (IsGlobalVar(dst.GetBuffer()->data.get())) {
+        reduced_->insert(dst.GetBuffer()->data.get());
+        return MakeAtomicCopy(src, dst);
+      }
+    }
+    return StmtExprMutator::VisitStmt_(op);
+  }
+
+  Stmt VisitStmt_(const BufferStoreNode *op) final {
+    if (IsGlobalVar(op->buffer->data.get())) {
+      reduced_->insert(op->buffer->data.get());
+      return Evaluate(
+          MakeAtomicAdd(op->buffer, op->indices, StripCast(op->value)));
+    }
+    return StmtExprMutator::VisitStmt_(op);
+  }
+
+  // Mirrors Copy::MakeSIMTLoop: iterate over the non-unit extents of the
+  // source region and map them, in order, onto the destination region.
+  Stmt MakeAtomicCopy(const RegionOp &src, const RegionOp &dst) {
+    Array<Range> src_range = src.GetRanges();
+    Array<Range> dst_range = dst.GetRanges();
+    Array<Var> loop_vars;
+    Array<PrimExpr> extents;
+    Array<PrimExpr> src_indices;
+    for (const Range &range : src_range) {
+      if (is_one(range->extent)) {
+        src_indices.push_back(range->min);
+        continue;
+      }
+      Var var(std::string{char('i' + loop_vars.size())},
+              range->extent->dtype);
+      src_indices.push_back(range->min + var);
+      loop_vars.push_back(var);
+      extents.push_back(range->extent);
+    }
+    Array<PrimExpr> dst_indices;
+    size_t idx = 0;
+    for (const Range &range : dst_range) {
+      if (is_one(range->extent)) {
+        dst_indices.push_back(range->min);
+      } else {
+        ICHECK_LT(idx, loop_vars.size())
+            << "Mismatched copy regions " << src_range << " and " << dst_range;
+        dst_indices.push_back(range->min + loop_vars[idx++]);
+      }
+    }
+    ICHECK_EQ(idx, loop_vars.size())
+        << "Mismatched copy regions " << src_range << " and " << dst_range;
+
+    Stmt body = Evaluate(MakeAtomicAdd(
+        dst.GetBuffer(), dst_indices, BufferLoad(src.GetBuffer(), src_indices)));
+    for (int i = static_cast<int>(loop_vars.size()) - 1; i >= 0; --i) {
+      body = For(loop_vars[i], 0, extents[i], ForKind::kParallel, body);
+    }
+    return body;
+  }
+
+  VarSet *reduced_;
+};
+
+struct GridAxis {
+  Var var;
+  PrimExpr extent;
+};
+
+/*!
+ * \brief Locate the root block of the kernel and the grid axes around it,
+ * either blockIdx thread extents or the grid loops of a CPU kernel.
+ */
+class KernelGridCollector : public StmtVisitor {
+public:
+  std::vector<GridAxis> axes;
+  const BlockNode *root{nullptr};
+
+private:
+  void VisitStmt_(const AttrStmtNode *op) final {
+    if (op->attr_key == tir::attr::thread_extent && !root) {
+      IterVar iv = Downcast<IterVar>(op->node);
+      std::string tag = iv->thread_tag;
+      if (tag.rfind("blockIdx.", 0) == 0) {
+        size_t dim = tag.back() - 'x';
+        if (axes.size() <= dim)
+          axes.resize(dim + 1);
+        axes[dim] = {iv->var, op->value};
+      }
+    }
+    StmtVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const ForNode *op) final {
+    if (root)
+      return;
+    loop_stack_.push_back(op);
+    StmtVisitor::VisitStmt_(op);
+    loop_stack_.pop_back();
+  }
+
+  void VisitStmt_(const BlockNode *op) final {
+    if (root || op->name_hint != MainBlockName) {
+      StmtVisitor::VisitStmt_(op);
+      return;
+    }
+    root = op;
+    if (op->annotations.count(tilelang_is_cpu_kernel_frame)) {
+      for (const ForNode *loop : loop_stack_) {
+        axes.push_back({loop->loop_var, loop->extent});
+      }
+    }
+  }
+
+  std::vector<const ForNode *> loop_stack_;
+};
+
+class KLoopDecomposer : public StmtExprMutator {
+public:
+  static PrimFunc Rewrite(PrimFunc f, int split_k, int stream_k_workers) {
+    KernelGridCollector collector;
+    collector(f->body);
+    if (!collector.root || collector.axes.empty()) {
+      return f;
+    }
+    KLoopDecomposer decomposer(collector.axes, split_k, stream_k_workers);
+    if (!decomposer.Plan(collector.root)) {
+      return f;
+    }
+    f.CopyOnWrite()->body = decomposer(f->body);
+    Array<Integer> atomic_outputs;
+    for (size_t i = 0; i < f->params.size(); ++i) {
+      const Var &param = f->params[i];
+      if (f->buffer_map.count(param) &&
+          decomposer.reduced_.count(f->buffer_map[param]->data.get()))
+        atomic_outputs.push_back(Integer(i));
+    }
+    return WithAttr(std::move(f), attr::kAtomicOutputs, atomic_outputs);
+  }
+
+private:
+  KLoopDecomposer(std::vector<GridAxis> axes, int split_k,
+                  int stream_k_workers)
+      : axes_(std::move(axes)), split_k_(split_k),
+        stream_k_workers_(stream_k_workers) {}
+
+  bool Plan(const BlockNode *root) {
+    // Peel attributes (e.g. T.use_swizzle) wrapped around the kernel body.
+    Stmt body = root->body;
+    while (auto *attr = body.as<AttrStmtNode>()) {
+      body = attr->body;
+    }
+    Array<Stmt> stmts;
+    if (auto *seq = body.as<SeqStmtNode>()) {
+      stmts = seq->seq;
+    } else {
+      stmts.push_back(body);
+    }
+
+    // The K loop is the only top-level loop updating an accumulator.
+    for (size_t i = 0; i < stmts.size(); ++i) {
+      auto *loop = stmts[i].as<ForNode>();
+      if (!loop || loop->kind == ForKind::kParallel)
+        continue;
+      VarSet accumulators = AccumulatorCollector::Collect(stmts[i]);
+      if (accumulators.empty())
+        continue;
+      if (k_loop_index_ >= 0) {
+        return Reject("multiple reduction loops");
+      }
+      k_loop_index_ = i;
+      accumulators_ = std::move(accumulators);
+    }
+    if (k_loop_index_ < 0) {
+      return Reject("no reduction loop found");
+    }
+    For k_loop = Downcast<For>(stmts[k_loop_index_]);
+    for (const GridAxis &axis : axes_) {
+      if (UsesVar(k_loop->min, [&](const VarNode *v) {
+            return v == axis.var.get();
+          }) ||
+          UsesVar(k_loop->extent,
+                  [&](const VarNode *v) { return v == axis.var.get(); })) {
+        return Reject("the reduction loop bounds depend on the block index");
+      }
+    }
+    if (WritesGlobal(k_loop)) {
+      return Reject("the reduction loop writes global memory");
+    }
+
+    // Every partial result must start from zero.
+    for (int i = 0; i < k_loop_index_; ++i) {
+      if (WritesGlobal(stmts[i])) {
+        return Reject("the prologue writes global memory");
+      }
+      VarSet reads, writes;
+      CollectBufferAccess(stmts[i], &reads, &writes);
+      bool writes_accumulator = false;
+      for (const VarNode *var : writes) {
+        writes_accumulator |= accumulators_.count(var) > 0;
+      }
+      if (!writes_accumulator)
+        continue;
+      auto *eval = stmts[i].as<EvaluateNode>();
+      auto *call = eval ? eval->value.as<CallNode>() : nullptr;
+      if (!call || !call->op.same_as(Fill::Get()) || !is_zero(call->args[1])) {
+        return Reject("the accumulator is not cleared before the loop");
+      }
+    }
+
+    Array<Stmt> epilogue(stmts.begin() + k_loop_index_ + 1, stmts.end());
+    if (!EpilogueChecker(accumulators_).Check(SeqStmt::Flatten(epilogue))) {
+      return Reject("the epilogue is not a plain store of the accumulator");
+    }
+    return true;
+  }
+
+  bool Reject(const std::string &reason) {
+    LOG(WARNING) << "DecomposeKLoop: skip kernel, " << reason;
+    return false;
+  }
+
+  bool IsStreamK() const { return stream_k_workers_ > 0; }
+
+  Stmt VisitStmt_(const AttrStmtNode *op) final {
+    if (op->attr_key == tir::attr::thread_extent) {
+      IterVar iv = Downcast<IterVar>(op->node);
+      for (size_t i = 0; i < axes_.size(); ++i) {
+        if (iv->var.same_as(axes_[i].var)) {
+          PrimExpr extent = NewExtent(i, op->value);
+          IterVar new_iv(Range::FromMinExtent(0, extent), iv->var,
+                         iv->iter_type, iv->thread_tag);
+          return AttrStmt(new_iv, op->attr_key, extent,
+                          VisitStmt(op->body));
+        }
+      }
+    }
+    return StmtExprMutator::VisitStmt_(op);
+  }
+
+  Stmt VisitStmt_(const ForNode *op) final {
+    For loop = Downcast<For>(StmtExprMutator::VisitStmt_(op));
+    for (size_t i = 0; i < axes_.size(); ++i) {
+      if (loop->loop_var.same_as(axes_[i].var)) {
+        loop.CopyOnWrite()->extent = NewExtent(i, loop->extent);
+      }
+    }
+    return loop;
+  }
+
+  Stmt VisitStmt_(const BlockNode *op) final {
+    if (op->name_hint != MainBlockName) {
+      return StmtExprMutator::VisitStmt_(op);
+    }
+    Block block = GetRef<Block>(op);
+    block.CopyOnWrite()->body = RewriteBody(op->body);
+    return block;
+  }
+
+  PrimExpr NewExtent(size_t axis, PrimExpr extent) const {
+    PrimExpr dtype_one = make_const(extent.dtype(), 1);
+    if (IsStreamK()) {
+      return axis == 0 ? make_const(extent.dtype(), stream_k_workers_)
+                       : dtype_one;
+    }
+    return axis == 0 ? extent * make_const(extent.dtype(), split_k_) : extent;
+  }
+
+  Stmt RewriteBody(const Stmt &body) {
+    if (auto *attr = body.as<AttrStmtNode>()) {
+      AttrStmt node = GetRef<AttrStmt>(attr);
+      node.CopyOnWrite()->body = RewriteBody(attr->body);
+      return node;
+    }
+    Array<Stmt> stmts;
+    if (auto *seq = body.as<SeqStmtNode>()) {
+      stmts = seq->seq;
+    } else {
+      stmts.push_back(body);
+    }
+    Array<Stmt> prologue(stmts.begin(), stmts.begin() + k_loop_index_);
+    For k_loop = Downcast<For>(stmts[k_loop_index_]);
+    Array<Stmt> epilogue(stmts.begin() + k_loop_index_ + 1, stmts.end());
+    Stmt epilogue_stmt = SeqStmt::Flatten(epilogue);
+    Stmt atomic_epilogue =
+        EpilogueAtomicRewriter::Rewrite(epilogue_stmt, &reduced_);
+    PrimExpr iters = k_loop->extent;
+    DataType dtype = iters.dtype();
+    const GridAxis &axis0 = axes_[0];
+
+    if (!IsStreamK()) {
+      PrimExpr num_splits = make_const(dtype, split_k_);
+      PrimExpr old_extent = cast(dtype, axis0.extent);
+      PrimExpr split = floordiv(cast(dtype, axis0.var), old_extent);
+      PrimExpr chunk = floordiv(iters + num_splits - 1, num_splits);
+      PrimExpr k_begin = split * chunk;
+      PrimExpr k_iters = max(min(chunk, iters - k_begin), 0);
+      auto *const_iters = iters.as<IntImmNode>();
+      if (const_iters && const_iters->value % split_k_ == 0) {
+        k_iters = make_const(dtype, const_iters->value / split_k_);
+      }
+      Map<Var, PrimExpr> vmap;
+      vmap.Set(axis0.var,
+               floormod(axis0.var, cast(axis0.var.dtype(), axis0.extent)));
+      Array<Stmt> seq;
+      for (const Stmt &stmt : prologue)
+        seq.push_back(Substitute(stmt, vmap));
+      seq.push_back(RewriteKLoop(Downcast<For>(Substitute(k_loop, vmap)),
+                                 k_begin, k_iters));
+      seq.push_back(Substitute(atomic_epilogue, vmap));
+      return SeqStmt::Flatten(seq);
+    }
+
+    // Stream-K: the same decomposition as T.StreamK, with the block indices
+    // recovered from the tile id (blockIdx.x varies fastest).
+    PrimExpr num_tiles = make_const(dtype, 1);
+    for (const GridAxis &axis : axes_)
+      num_tiles = num_tiles * cast(dtype, axis.extent);
+    PrimExpr workers = make_const(dtype, stream_k_workers_);
+    PrimExpr total = num_tiles * iters;
+    PrimExpr iters_per_worker = floordiv(total + workers - 1, workers);
+    PrimExpr begin = cast(dtype, axis0.var) * iters_per_worker;
+    PrimExpr end = min(begin + iters_per_worker, total);
+    PrimExpr num_segments = floordiv(iters_per_worker + iters - 1, iters) + 1;
+
+    Var segment("segment", dtype);
+    PrimExpr seg_begin = max(begin, (floordiv(begin, iters) + segment) * iters);
+    PrimExpr tile = floordiv(seg_begin, iters);
+    PrimExpr k_begin = seg_begin - tile * iters;
+    PrimExpr k_end = min(end - tile * iters, iters);
+
+    Map<Var, PrimExpr> vmap;
+    PrimExpr rest = tile;
+    for (const GridAxis &axis : axes_) {
+      PrimExpr extent = cast(dtype, axis.extent);
+      vmap.Set(axis.var, cast(axis.var.dtype(), floormod(rest, extent)));
+      rest = floordiv(rest, extent);
+    }
+    Array<Stmt> seq;
+    for (const Stmt &stmt : prologue)
+      seq.push_back(Substitute(stmt, vmap));
+    seq.push_back(RewriteKLoop(Downcast<For>(Substitute(k_loop, vmap)),
+                               k_begin, k_end - k_begin));
+    PrimExpr full_tile = k_begin == 0 && k_end == iters;
+    seq.push_back(IfThenElse(full_tile, Substitute(epilogue_stmt, vmap),
+                             Substitute(atomic_epilogue, vmap)));
+    Stmt segment_body = IfThenElse(seg_begin < end, SeqStmt::Flatten(seq));
+    return For(segment, 0, num_segments, ForKind::kSerial, segment_body);
+  }
+
+  // Iterate the K loop over [k_begin, k_begin + k_iters) of its original
+  // range, keeping its annotations (num_stages, ...).
+  Stmt RewriteKLoop(For k_loop, PrimExpr k_begin, PrimExpr k_iters) {
+    Var var = k_loop->loop_var;
+    PrimExpr offset = k_loop->min + cast(var.dtype(), k_begin);
+    Map<Var, PrimExpr> vmap;
+    vmap.Set(var, var + offset);
+    Stmt body = Substitute(k_loop->body, vmap);
+    auto *n = k_loop.CopyOnWrite();
+    n->min = make_zero(var.dtype());
+    n->extent = cast(var.dtype(), k_iters);
+    n->body = body;
+    return k_loop;
+  }
+
+  std::vector<GridAxis> axes_;
+  int split_k_;
+  int stream_k_workers_;
+  int k_loop_index_{-1};
+  VarSet accumulators_;
+  // Global buffers whose stores became atomic additions.
+  VarSet reduced_;
+};
+
+} // namespace
+
+using namespace tir::transform;
+
+tvm::transform::Pass DecomposeKLoop() {
+  auto pass_func = [](PrimFunc f, IRModule m, PassContext ctx) {
+    int split_k = ctx->GetConfig(kSplitK, Integer(1)).value()->value;
+    int stream_k_workers =
+        ctx->GetConfig(kStreamKWorkers, Integer(0)).value()->value;
+    ICHECK(split_k >= 1) << kSplitK << " must be positive, got " << split_k;
+    ICHECK(stream_k_workers >= 0)
+        << kStreamKWorkers << " must be non-negative, got "
+        << stream_k_workers;
+    ICHECK(split_k == 1 || stream_k_workers == 0)
+        << kSplitK << " and " << kStreamKWorkers << " are exclusive";
+    if (split_k == 1 && stream_k_workers == 0) {
+      return f;
+    }
+    return KLoopDecomposer::Rewrite(std::move(f), split_k, stream_k_workers);
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tl.DecomposeKLoop", {});
+}
+
+TVM_REGISTER_GLOBAL("tl.transform.DecomposeKLoop")
+    .set_body_typed(DecomposeKLoop);
+
+} // namespace tl
+} // namespace tvm
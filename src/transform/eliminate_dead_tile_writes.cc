@@ -0,0 +1,388 @@
+/*!
+ * \file eliminate_dead_tile_writes.cc
+ * \brief Remove fills and copies of tile buffers that are overwritten before
+ * being read.
+ *
+ * Tile programs often clear an accumulator right before a gemm that clears
+ * it again, or fill a shared buffer that the next copy overwrites:
+ *
+ *   T.clear(C_local)
+ *   T.gemm(A_shared, B_shared, C_local, clear_accum=True)
+ *
+ *   T.fill(A_shared, 0)
+ *   T.copy(A[by * 64, 0], A_shared)
+ *
+ * Before layout inference this pass walks every statement sequence and drops
+ * a fill or copy into a shared or local buffer when a later statement of the
+ * same sequence writes a region covering it before anything reads the
+ * buffer. The regions come from the tl.region operands of the tile ops
+ * (RegionOp), whose access masks tell reads from writes. A zero fill of the
+ * whole accumulator followed by a gemm that accumulates into it is folded
+ * into the clear_accum flag of the gemm instead:
+ *
+ *   T.clear(C_local)
+ *   T.gemm(A_shared, B_shared, C_local)
+ *     =>
+ *   T.gemm(A_shared, B_shared, C_local, clear_accum=True)
+ *
+ * A copy writes as much of its destination as its source spans: a fill that
+ * pads a tile loaded from a smaller source region stays. Copies out of
+ * bounds of their source still write that whole span (LegalizeSafeMemoryAccess
+ * pads shared and local stores), so a fill ahead of a boundary copy is dead
+ * as well.
+ */
+
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <unordered_set>
+
+#include "../op/builtin.h"
+#include "../op/elem.h"
+#include "../op/gemm.h"
+#include "arith/ir_mutator_with_analyzer.h"
+
+namespace tvm {
+namespace tl {
+
+using namespace tir;
+
+namespace {
+
+using VarSet = std::unordered_set<const VarNode *>;
+
+const CallNode *AsTileOp(const Stmt &stmt, const Op &op) {
+  auto *eval = stmt.as<EvaluateNode>();
+  auto *call = eval ? eval->value.as<CallNode>() : nullptr;
+  return call && call->op.same_as(op) ? call : nullptr;
+}
+
+/*! \brief A region of a buffer written as a whole by a tile op. */
+struct TileWrite {
+  Buffer buffer;
+  Array<Range> region;
+};
+
+/*! \brief The region written by a tl.fill, or nothing. */
+Optional<Array<Range>> FillRegion(const CallNode *fill,
+                                  const Map<Var, Buffer> &buffers,
+                                  Buffer *buffer) {
+  Array<Range> region;
+  if (auto *load = fill->args[0].as<BufferLoadNode>()) {
+    for (const PrimExpr &index : load->indices) {
+      if (auto *ramp = index.as<RampNode>()) {
+        if (!is_one(ramp->stride))
+          return NullOpt;
+        region.push_back(Range::FromMinExtent(ramp->base, ramp->lanes));
+      } else {
+        region.push_back(Range::FromMinExtent(index, 1));
+      }
+    }
+    *buffer = load->buffer;
+    return region;
+  }
+  auto *ptr = fill->args[0].as<CallNode>();
+  if (!ptr || !ptr->op.same_as(builtin::tvm_access_ptr()) ||
+      !is_zero(ptr->args[2]))
+    return NullOpt;
+  auto it = buffers.find(GetVarFromAccessPtr(fill->args[0]));
+  if (it == buffers.end())
+    return NullOpt;
+  *buffer = (*it).second;
+  for (const PrimExpr &extent : (*buffer)->shape)
+    region.push_back(Range::FromMinExtent(0, extent));
+  return region;
+}
+
+/*!
+ * \brief The region written by a tl.copy. Like Copy::MakeIterVars, the loop
+ * runs over the non-unit extents of the source, which are mapped in order
+ * onto the non-unit dimensions of the destination, so a smaller source
+ * writes only part of the destination region.
+ */
+Optional<Array<Range>> CopyRegion(const RegionOp &src, const RegionOp &dst) {
+  Array<PrimExpr> extents;
+  for (const Range &range : src.GetRanges()) {
+    if (!is_one(range->extent))
+      extents.push_back(range->extent);
+  }
+  Array<Range> region;
+  size_t idx = 0;
+  for (const Range &range : dst.GetRanges()) {
+    if (is_one(range->extent)) {
+      region.push_back(range);
+    } else if (idx < extents.size()) {
+      region.push_back(Range::FromMinExtent(range->min, extents[idx++]));
+    } else {
+      return NullOpt;
+    }
+  }
+  if (idx != extents.size())
+    return NullOpt;
+  return region;
+}
+
+/*! \brief Whether a gemm accumulates into all of C. */
+bool AccumulatesWhole(const CallNode *gemm, const Buffer &C) {
+  auto *ptr = gemm->args[2].as<CallNode>();
+  if (!ptr || !ptr->op.same_as(builtin::tvm_access_ptr()) ||
+      !is_zero(ptr->args[2]) ||
+      !GetVarFromAccessPtr(gemm->args[2]).same_as(C->data))
+    return false;
+  const int64_t *M = as_const_int(gemm->args[5]);
+  const int64_t *N = as_const_int(gemm->args[6]);
+  return M && N && C->shape.size() == 2 && is_const_int(C->shape[0], *M) &&
+         is_const_int(C->shape[1], *N);
+}
+
+/*!
+ * \brief The buffers a statement reads or partially writes, and the regions it
+ * overwrites without reading them first.
+ */
+class TileAccessCollector : public StmtExprVisitor {
+public:
+  static TileAccessCollector Collect(const Stmt &stmt,
+                                     const Map<Var, Buffer> &buffers) {
+    TileAccessCollector collector(buffers);
+    collector.Summarize(stmt);
+    return collector;
+  }
+
+  VarSet uses;
+  std::vector<TileWrite> writes;
+
+private:
+  explicit TileAccessCollector(const Map<Var, Buffer> &buffers)
+      : buffers_(buffers) {}
+
+  void Summarize(const Stmt &stmt) {
+    if (auto *fill = AsTileOp(stmt, Fill::Get())) {
+      Buffer buffer;
+      if (auto region = FillRegion(fill, buffers_, &buffer)) {
+        writes.push_back({buffer, region.value()});
+        VisitExpr(fill->args[1]);
+        return;
+      }
+    } else if (auto *copy = AsTileOp(stmt, Copy::Get())) {
+      auto *src = copy->args[0].as<CallNode>();
+      auto *dst = copy->args[1].as<CallNode>();
+      if (src && dst && src->op.same_as(RegionOp::Get()) &&
+          dst->op.same_as(RegionOp::Get())) {
+        RegionOp src_region(src->args, {});
+        RegionOp dst_region(dst->args, {});
+        auto region = CopyRegion(src_region, dst_region);
+        if ((src_region.GetAccessMask() & 1) &&
+            dst_region.GetAccessMask() == 2 && region) {
+          VisitExpr(copy->args[0]);
+          for (const Range &range : dst_region.GetRanges()) {
+            VisitExpr(range->min);
+            VisitExpr(range->extent);
+          }
+          writes.push_back({dst_region.GetBuffer(), region.value()});
+          return;
+        }
+      }
+    } else if (auto *gemm = AsTileOp(stmt, Gemm::Get())) {
+      auto it = buffers_.find(GetVarFromAccessPtr(gemm->args[2]));
+      if (it != buffers_.end() && AccumulatesWhole(gemm, (*it).second) &&
+          gemm->args[9].as<Bool>().value()) {
+        for (int i = 0; i < 2; i++)
+          VisitExpr(gemm->args[i]);
+        const Buffer &C = (*it).second;
+        Array<Range> region;
+        for (const PrimExpr &extent : C->shape)
+          region.push_back(Range::FromMinExtent(0, extent));
+        writes.push_back({C, region});
+        return;
+      }
+    }
+    VisitStmt(stmt);
+  }
+
+  void VisitExpr_(const VarNode *op) final { uses.insert(op); }
+
+  void VisitExpr_(const BufferLoadNode *op) final {
+    uses.insert(op->buffer->data.get());
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const BufferStoreNode *op) final {
+    uses.insert(op->buffer->data.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  const Map<Var, Buffer> &buffers_;
+};
+
+/*! \brief Buffers allocated by the blocks of a function. */
+class BufferMapCollector : public StmtVisitor {
+public:
+  Map<Var, Buffer> buffers;
+
+private:
+  void VisitStmt_(const BlockNode *op) final {
+    for (const Buffer &buffer : op->alloc_buffers)
+      buffers.Set(buffer->data, buffer);
+    StmtVisitor::VisitStmt_(op);
+  }
+};
+
+class DeadTileWriteEliminator : public arith::IRMutatorWithAnalyzer {
+public:
+  static PrimFunc Substitute(PrimFunc f) {
+    arith::Analyzer analyzer;
+    DeadTileWriteEliminator eliminator(&analyzer);
+    BufferMapCollector collector;
+    collector(f->body);
+    eliminator.buffers_ = collector.buffers;
+    for (const auto &[_, buffer] : f->buffer_map)
+      eliminator.buffers_.Set(buffer->data, buffer);
+    PrimFuncNode *fptr = f.CopyOnWrite();
+    fptr->body = eliminator.VisitStmt(f->body);
+    return f;
+  }
+
+private:
+  using arith::IRMutatorWithAnalyzer::IRMutatorWithAnalyzer;
+
+  bool Covers(const Array<Range> &outer, const Array<Range> &inner) {
+    if (outer.size() != inner.size())
+      return false;
+    for (size_t i = 0; i < outer.size(); i++) {
+      if (!analyzer_->CanProve(outer[i]->min <= inner[i]->min) ||
+          !analyzer_->CanProve(inner[i]->min + inner[i]->extent <=
+                               outer[i]->min + outer[i]->extent))
+        return false;
+    }
+    return true;
+  }
+
+  bool IsFullRegion(const TileWrite &write) {
+    for (size_t i = 0; i < write.region.size(); i++) {
+      if (!analyzer_->CanProveEqual(write.region[i]->min, 0) ||
+          !analyzer_->CanProveEqual(write.region[i]->extent,
+                                    write.buffer->shape[i]))
+        return false;
+    }
+    return true;
+  }
+
+  /*! \brief The write of a fill or copy into a shared or local buffer. */
+  Optional<TileWrite> CandidateWrite(const Stmt &stmt) {
+    if (!AsTileOp(stmt, Fill::Get()) && !AsTileOp(stmt, Copy::Get()))
+      return NullOpt;
+    auto access = TileAccessCollector::Collect(stmt, buffers_);
+    if (access.writes.size() != 1)
+      return NullOpt;
+    const TileWrite &write = access.writes[0];
+    String scope = write.buffer.scope();
+    if (scope != "shared" && scope != "shared.dyn" && scope != "local" &&
+        scope != "local.fragment")
+      return NullOpt;
+    if (access.uses.count(write.buffer->data.get()))
+      return NullOpt;
+    return write;
+  }
+
+  Stmt VisitStmt_(const SeqStmtNode *op) final {
+    Stmt stmt = arith::IRMutatorWithAnalyzer::VisitStmt_(op);
+    auto *seq_node = stmt.as<SeqStmtNode>();
+    if (!seq_node)
+      return stmt;
+    Array<Stmt> seq = seq_node->seq;
+    std::unordered_set<int> dropped;
+    for (int i = 0; i < static_cast<int>(seq.size()); i++) {
+      auto write = CandidateWrite(seq[i]);
+      if (!write)
+        continue;
+      const VarNode *data = write.value().buffer->data.get();
+      for (int j = i + 1; j < static_cast<int>(seq.size()); j++) {
+        if (dropped.count(j))
+          continue;
+        auto access = TileAccessCollector::Collect(seq[j], buffers_);
+        if (access.uses.count(data)) {
+          if (auto folded = FoldClear(seq[i], write.value(), seq[j])) {
+            seq.Set(j, folded.value());
+            dropped.insert(i);
+          }
+          break;
+        }
+        bool overwritten = false;
+        for (const TileWrite &later : access.writes) {
+          overwritten = overwritten || (later.buffer->data.get() == data &&
+                                        Covers(later.region,
+                                               write.value().region));
+        }
+        if (overwritten) {
+          dropped.insert(i);
+          break;
+        }
+      }
+    }
+    if (dropped.empty())
+      return stmt;
+    Array<Stmt> kept;
+    for (int i = 0; i < static_cast<int>(seq.size()); i++) {
+      if (!dropped.count(i))
+        kept.push_back(seq[i]);
+    }
+    return SeqStmt::Flatten(kept);
+  }
+
+  /*!
+   * \brief A gemm accumulating into the buffer that a zero fill just cleared,
+   * with clear_accum set instead.
+   */
+  Optional<Stmt> FoldClear(const Stmt &fill_stmt, const TileWrite &write,
+                           const Stmt &gemm_stmt) {
+    auto *fill = AsTileOp(fill_stmt, Fill::Get());
+    auto *gemm = AsTileOp(gemm_stmt, Gemm::Get());
+    if (!fill || !gemm || !is_zero(fill->args[1]) || !IsFullRegion(write) ||
+        gemm->args[9].as<Bool>().value() ||
+        !AccumulatesWhole(gemm, write.buffer))
+      return NullOpt;
+    // The operands must not alias the accumulator.
+    for (int k = 0; k < 2; k++) {
+      if (GetVarFromAccessPtr(gemm->args[k]).same_as(write.buffer->data))
+        return NullOpt;
+    }
+    Array<PrimExpr> args = gemm->args;
+    args.Set(9, Bool(true));
+    return Evaluate(Call(gemm->dtype, gemm->op, args, gemm->span));
+  }
+
+  Stmt VisitStmt_(const ForNode *op) final {
+    // Statements of loops with an explicit pipeline schedule are indexed by
+    // the tl_pipeline_order / tl_pipeline_stage annotations.
+    if (op->annotations.count("tl_pipeline_order") ||
+        op->annotations.count("tl_pipeline_stage"))
+      return GetRef<Stmt>(op);
+    return arith::IRMutatorWithAnalyzer::VisitStmt_(op);
+  }
+
+  Map<Var, Buffer> buffers_;
+};
+
+} // namespace
+
+using namespace tir::transform;
+
+tvm::transform::Pass EliminateDeadTileWrites() {
+  auto pass_func = [](PrimFunc f, IRModule m, PassContext ctx) {
+    bool disabled =
+        ctx->GetConfig(kDisableDeadTileWriteElimination, Bool(false)).value();
+    if (disabled) {
+      return f;
+    }
+    return DeadTileWriteEliminator::Substitute(std::move(f));
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tl.EliminateDeadTileWrites", {});
+}
+
+TVM_REGISTER_GLOBAL("tl.transform.EliminateDeadTileWrites")
+    .set_body_typed(EliminateDeadTileWrites);
+
+} // namespace tl
+} // namespace tvm
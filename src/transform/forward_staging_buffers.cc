@@ -0,0 +1,359 @@
+/*!
+ * \file forward_staging_buffers.cc
+ * \brief Remove shared memory round trips of the tile program.
+ *
+ * Two kinds of staging are eliminated before layout inference:
+ *
+ *  - With tl.enable_fragment_forwarding, a fragment copied to a shared buffer
+ *    whose only reader is the A operand of a following gemm (e.g. P in flash
+ *    attention) is fed to the gemm directly, which then lowers to gemm_rs.
+ *    The shared buffer, the copy and the barriers that would guard it
+ *    disappear, and the fragment gets the register layout of the gemm
+ *    operand. The round trip is also how a fragment changes layout (see
+ *    ParallelOp::InferLayout), and before layout inference the pass cannot
+ *    tell whether the producer's layout matches the gemm operand, so this is
+ *    opt-in.
+ *  - A copy from global to shared memory inside a serial loop whose source
+ *    does not depend on the loop and whose destination is not written
+ *    elsewhere loads the same tile on every iteration; it is hoisted out of
+ *    the loop, under a guard unless the loop provably runs.
+ */
+
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../layout/layout.h"
+#include "../op/builtin.h"
+#include "../op/elem.h"
+#include "../op/gemm.h"
+#include "../op/gemm_sp.h"
+#include "arith/ir_mutator_with_analyzer.h"
+
+namespace tvm {
+namespace tl {
+
+using namespace tir;
+
+namespace {
+
+using VarSet = std::unordered_set<const VarNode *>;
+
+bool IsSharedScope(const Buffer &buffer) {
+  return buffer.scope() == "shared" || buffer.scope() == "shared.dyn";
+}
+
+bool IsGlobalScope(const Buffer &buffer) {
+  return buffer.scope() == "global" || buffer.scope().empty();
+}
+
+/*! \brief A tl.copy between two buffer regions. */
+struct CopyRegions {
+  Buffer src, dst;
+  const CallNode *src_region{nullptr};
+  const CallNode *dst_region{nullptr};
+};
+
+bool MatchCopy(const Stmt &stmt, CopyRegions *copy) {
+  auto *eval = stmt.as<EvaluateNode>();
+  auto *call = eval ? eval->value.as<CallNode>() : nullptr;
+  if (!call || !call->op.same_as(Copy::Get()))
+    return false;
+  auto *src = call->args[0].as<CallNode>();
+  auto *dst = call->args[1].as<CallNode>();
+  if (!src || !dst || !src->op.same_as(RegionOp::Get()) ||
+      !dst->op.same_as(RegionOp::Get()))
+    return false;
+  auto *src_load = src->args[0].as<BufferLoadNode>();
+  auto *dst_load = dst->args[0].as<BufferLoadNode>();
+  if (!src_load || !dst_load)
+    return false;
+  copy->src = src_load->buffer;
+  copy->dst = dst_load->buffer;
+  copy->src_region = src;
+  copy->dst_region = dst;
+  return true;
+}
+
+/*! \brief Whether a tl.region covers its whole buffer. */
+bool IsFullRegion(const CallNode *region, arith::Analyzer *analyzer) {
+  auto *load = region->args[0].as<BufferLoadNode>();
+  const Buffer &buffer = load->buffer;
+  size_t ndim = region->args.size() - 2;
+  if (ndim != buffer->shape.size() || ndim != load->indices.size())
+    return false;
+  for (size_t i = 0; i < ndim; i++) {
+    if (!analyzer->CanProveEqual(load->indices[i], 0) ||
+        !analyzer->CanProveEqual(region->args[i + 2], buffer->shape[i]))
+      return false;
+  }
+  return true;
+}
+
+/*!
+ * \brief Count the references to and the writes of every buffer, and collect
+ * the buffers that are already operands of gemms or carry a user layout.
+ */
+class BufferUseCollector : public StmtExprVisitor {
+public:
+  std::unordered_map<const VarNode *, int> uses;
+  std::unordered_map<const VarNode *, int> writes;
+  VarSet gemm_operands;
+  VarSet annotated;
+
+private:
+  void VisitExpr_(const VarNode *op) final { uses[op]++; }
+
+  void VisitExpr_(const BufferLoadNode *op) final {
+    uses[op->buffer->data.get()]++;
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const BufferStoreNode *op) final {
+    uses[op->buffer->data.get()]++;
+    writes[op->buffer->data.get()]++;
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const CallNode *op) final {
+    if (op->op.same_as(builtin::tvm_access_ptr())) {
+      auto *var = op->args[1].as<VarNode>();
+      if (var && (*as_const_int(op->args[4]) & 2))
+        writes[var]++;
+    } else if (op->op.same_as(RegionOp::Get())) {
+      auto *load = op->args[0].as<BufferLoadNode>();
+      if (load && (*as_const_int(op->args[1]) & 2))
+        writes[load->buffer->data.get()]++;
+    } else if (op->op.same_as(Fill::Get())) {
+      if (auto *load = op->args[0].as<BufferLoadNode>())
+        writes[load->buffer->data.get()]++;
+    } else if (op->op.same_as(builtin::address_of())) {
+      // Addresses escape to extern calls (atomics, ...), assume a write.
+      if (auto *load = op->args[0].as<BufferLoadNode>())
+        writes[load->buffer->data.get()]++;
+    }
+    if (op->op.same_as(Gemm::Get()) || op->op.same_as(GemmSP::Get())) {
+      int num_operands = op->op.same_as(Gemm::Get()) ? 3 : 4;
+      for (int i = 0; i < num_operands; i++)
+        gemm_operands.insert(GetVarFromAccessPtr(op->args[i]).get());
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const BlockNode *op) final {
+    if (op->annotations.count(attr::kLayoutMap)) {
+      auto layout_map =
+          op->annotations.Get(attr::kLayoutMap).as<Map<Var, Layout>>();
+      if (layout_map) {
+        for (const auto &[var, _] : layout_map.value())
+          annotated.insert(var.get());
+      }
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+};
+
+class StagingForwarder : public arith::IRMutatorWithAnalyzer {
+public:
+  static PrimFunc Substitute(PrimFunc f, bool forward_fragments) {
+    arith::Analyzer analyzer;
+    StagingForwarder forwarder(&analyzer);
+    forwarder.forward_fragments_ = forward_fragments;
+    forwarder.collector_(f->body);
+    PrimFuncNode *fptr = f.CopyOnWrite();
+    fptr->body = forwarder.VisitStmt(f->body);
+    return f;
+  }
+
+private:
+  using arith::IRMutatorWithAnalyzer::IRMutatorWithAnalyzer;
+
+  int Uses(const Buffer &buffer) const {
+    auto it = collector_.uses.find(buffer->data.get());
+    return it == collector_.uses.end() ? 0 : it->second;
+  }
+
+  int Writes(const Buffer &buffer) const {
+    auto it = collector_.writes.find(buffer->data.get());
+    return it == collector_.writes.end() ? 0 : it->second;
+  }
+
+  /*!
+   * \brief Whether frag can stand in for the A operand of gemm as a register
+   * operand: the operand is the whole, untransposed M x K tile and has the
+   * dtype of B, as the register layout of gemm_rs expects.
+   */
+  bool IsGemmOperandA(const Buffer &frag, const CallNode *gemm) {
+    auto *a_ptr = gemm->args[0].as<CallNode>();
+    auto *b_ptr = gemm->args[1].as<CallNode>();
+    bool trans_A = gemm->args[3].as<Bool>().value();
+    if (trans_A || !is_zero(a_ptr->args[2]) || frag->shape.size() != 2)
+      return false;
+    PrimExpr M = gemm->args[5], K = gemm->args[7];
+    return analyzer_->CanProveEqual(frag->shape[0], M) &&
+           analyzer_->CanProveEqual(frag->shape[1], K) &&
+           analyzer_->CanProveEqual(a_ptr->args[3], M * K) &&
+           frag->dtype == b_ptr->args[0].dtype();
+  }
+
+  /*!
+   * \brief Check if seq[index] is a fragment -> shared copy that can be
+   * forwarded to a gemm further down the sequence, and return the position
+   * of that gemm or -1.
+   */
+  int FindForwardedGemm(const Array<Stmt> &seq, int index) {
+    CopyRegions copy;
+    if (!MatchCopy(seq[index], &copy))
+      return -1;
+    const Buffer &frag = copy.src, &shared = copy.dst;
+    if (frag.scope() != "local.fragment" || !IsSharedScope(shared) ||
+        frag->dtype != shared->dtype ||
+        !StructuralEqual()(frag->shape, shared->shape) ||
+        !IsFullRegion(copy.src_region, analyzer_) ||
+        !IsFullRegion(copy.dst_region, analyzer_))
+      return -1;
+    // The staging buffer must be written by the copy and read by a single
+    // gemm only (the copy region and the gemm access pointer), and the
+    // fragment must be free to take the register layout of the gemm operand.
+    if (Uses(shared) != 2 || Writes(shared) != 1 ||
+        collector_.gemm_operands.count(frag->data.get()) ||
+        collector_.annotated.count(frag->data.get()) ||
+        collector_.annotated.count(shared->data.get()))
+      return -1;
+    for (size_t j = index + 1; j < seq.size(); j++) {
+      auto *eval = seq[j].as<EvaluateNode>();
+      auto *call = eval ? eval->value.as<CallNode>() : nullptr;
+      if (call && call->op.same_as(Gemm::Get()) &&
+          GetVarFromAccessPtr(call->args[0]).same_as(shared->data)) {
+        return IsGemmOperandA(frag, call) ? j : -1;
+      }
+      // The fragment must hold the same values when the gemm runs.
+      BufferUseCollector between;
+      between(seq[j]);
+      if (between.writes.count(frag->data.get()) ||
+          between.uses.count(shared->data.get()))
+        return -1;
+    }
+    return -1;
+  }
+
+  Stmt VisitStmt_(const SeqStmtNode *op) final {
+    Stmt stmt = arith::IRMutatorWithAnalyzer::VisitStmt_(op);
+    auto *seq_node = stmt.as<SeqStmtNode>();
+    if (!seq_node || !forward_fragments_)
+      return stmt;
+    Array<Stmt> seq = seq_node->seq;
+    std::unordered_set<int> dropped;
+    for (int i = 0; i < static_cast<int>(seq.size()); i++) {
+      int gemm_index = FindForwardedGemm(seq, i);
+      if (gemm_index < 0)
+        continue;
+      CopyRegions copy;
+      MatchCopy(seq[i], &copy);
+      auto *call = seq[gemm_index].as<EvaluateNode>()->value.as<CallNode>();
+      Array<PrimExpr> a_args = call->args[0].as<CallNode>()->args;
+      a_args.Set(1, copy.src->data);
+      Array<PrimExpr> args = call->args;
+      args.Set(0, Call(DataType::Handle(), builtin::tvm_access_ptr(), a_args));
+      seq.Set(gemm_index, Evaluate(Call(call->dtype, call->op, args)));
+      dropped.insert(i);
+      removed_buffers_.insert(copy.dst->data.get());
+    }
+    if (dropped.empty())
+      return stmt;
+    Array<Stmt> kept;
+    for (int i = 0; i < static_cast<int>(seq.size()); i++) {
+      if (!dropped.count(i))
+        kept.push_back(seq[i]);
+    }
+    return SeqStmt::Flatten(kept);
+  }
+
+  /*! \brief Whether stmt is a loop invariant global -> shared copy. */
+  bool IsInvariantLoad(const Stmt &stmt, const Var &loop_var) {
+    CopyRegions copy;
+    if (!MatchCopy(stmt, &copy))
+      return false;
+    if (!IsGlobalScope(copy.src) || !IsSharedScope(copy.dst) ||
+        Writes(copy.src) != 0 || Writes(copy.dst) != 1)
+      return false;
+    return !UsesVar(stmt, [&](const VarNode *var) {
+      return var == loop_var.get();
+    });
+  }
+
+  Stmt VisitStmt_(const ForNode *op) final {
+    For loop = Downcast<For>(arith::IRMutatorWithAnalyzer::VisitStmt_(op));
+    // Statements of loops with an explicit pipeline schedule are indexed by
+    // the tl_pipeline_order / tl_pipeline_stage annotations.
+    if ((loop->kind != ForKind::kSerial && loop->kind != ForKind::kUnrolled) ||
+        loop->annotations.count("tl_pipeline_order") ||
+        loop->annotations.count("tl_pipeline_stage"))
+      return loop;
+    auto *body = loop->body.as<SeqStmtNode>();
+    if (!body)
+      return loop;
+    Array<Stmt> hoisted, kept;
+    for (const Stmt &stmt : body->seq) {
+      if (IsInvariantLoad(stmt, loop->loop_var)) {
+        hoisted.push_back(stmt);
+      } else {
+        kept.push_back(stmt);
+      }
+    }
+    if (hoisted.empty() || kept.empty())
+      return loop;
+    loop.CopyOnWrite()->body = SeqStmt::Flatten(kept);
+    // The loop may not run at all, then neither may the hoisted loads.
+    Stmt loads = SeqStmt::Flatten(hoisted);
+    if (!analyzer_->CanProve(loop->extent > 0))
+      loads = IfThenElse(loop->extent > 0, loads);
+    return SeqStmt::Flatten(loads, loop);
+  }
+
+  Stmt VisitStmt_(const BlockNode *op) final {
+    Block block = Downcast<Block>(arith::IRMutatorWithAnalyzer::VisitStmt_(op));
+    if (removed_buffers_.empty())
+      return block;
+    Array<Buffer> alloc_buffers;
+    for (const Buffer &buffer : block->alloc_buffers) {
+      if (!removed_buffers_.count(buffer->data.get()))
+        alloc_buffers.push_back(buffer);
+    }
+    if (alloc_buffers.size() != block->alloc_buffers.size())
+      block.CopyOnWrite()->alloc_buffers = alloc_buffers;
+    return block;
+  }
+
+  BufferUseCollector collector_;
+  VarSet removed_buffers_;
+  bool forward_fragments_{false};
+};
+
+} // namespace
+
+using namespace tir::transform;
+
+tvm::transform::Pass ForwardStagingBuffers() {
+  auto pass_func = [](PrimFunc f, IRModule m, PassContext ctx) {
+    bool disabled =
+        ctx->GetConfig(kDisableStagingForwarding, Bool(false)).value();
+    if (disabled) {
+      return f;
+    }
+    bool forward_fragments =
+        ctx->GetConfig(kEnableFragmentForwarding, Bool(false)).value();
+    return StagingForwarder::Substitute(std::move(f), forward_fragments);
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tl.ForwardStagingBuffers", {});
+}
+
+TVM_REGISTER_GLOBAL("tl.transform.ForwardStagingBuffers")
+    .set_body_typed(ForwardStagingBuffers);
+
+} // namespace tl
+} // namespace tvm
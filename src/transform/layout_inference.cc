@@ -10,9 +10,13 @@
 #include <tvm/tir/transform.h>
 #include <tvm/tir/utils.h>
 
+#include <algorithm>
 #include <queue>
+#include <sstream>
 
+#include "../op/builtin.h"
 #include "../op/parallel.h"
+#include "../target/utils.h"
 #include "arith/ir_mutator_with_analyzer.h"
 #include "arith/ir_visitor_with_analyzer.h"
 #include "common/loop_fusion_utils.h"
@@ -52,12 +56,54 @@ struct LayoutInferenceResult {
   Map<Buffer, Layout> layout_map;
   Map<For, Fragment> for_map;
   Map<For, PrimExpr> predicate_map;
+  // Estimated peak of 32-bit registers per thread held by fragments, and the
+  // per-thread budget of the target (0 if unknown).
+  int64_t peak_registers{0};
+  int64_t register_budget{0};
+  // Human readable record of the layout decisions, see RegisterFootprintAttr.
+  Array<String> decisions;
 };
 
+/*!
+ * \brief Number of 32-bit registers a thread needs for its part of a fragment,
+ * or 0 if the fragment shape is not static.
+ */
+static int64_t FragmentRegisters(const Buffer &buffer,
+                                 const Fragment &fragment) {
+  int64_t elems = 1;
+  for (const PrimExpr &extent : fragment->OutputShape()) {
+    const int64_t *imm = as_const_int(extent);
+    if (imm == nullptr)
+      return 0;
+    elems *= *imm;
+  }
+  int64_t bits = elems * buffer->dtype.bits() * buffer->dtype.lanes();
+  return (bits + 31) / 32;
+}
+
+/*!
+ * \brief Registers per thread available to a block of num_threads threads.
+ */
+static int64_t RegisterBudget(const Target &target, int64_t num_threads) {
+  auto budget = tvm::transform::PassContext::Current()
+                    ->GetConfig<Integer>(kRegisterBudget, Integer(0))
+                    .value();
+  if (budget->value > 0)
+    return budget->value;
+  num_threads = std::max<int64_t>(num_threads, 1);
+  if (TargetIsCuda(target))
+    return std::min<int64_t>(255, 65536 / num_threads);
+  if (TargetIsRocm(target))
+    return std::min<int64_t>(512, 131072 / num_threads);
+  return 0;
+}
+
 class BufferUseDefCollector : public IRVisitorWithAnalyzer {
 public:
-  BufferUseDefCollector(bool skip_thread_partition)
-      : skip_thread_partition_(skip_thread_partition) {}
+  BufferUseDefCollector(bool skip_thread_partition,
+                        bool prefer_low_replication = false)
+      : skip_thread_partition_(skip_thread_partition),
+        prefer_low_replication_(prefer_low_replication) {}
 
   LayoutInferenceResult Run() {
     // Basic consistency check: infer_list_ and thread_var_vec_ should have the
@@ -128,7 +174,9 @@ public:
 
       // Run InferLayout
       auto updates = next->InferLayout(
-          LayoutInferArgs{target_, thread_bounds, layout_map}, level);
+          LayoutInferArgs{target_, thread_bounds, layout_map, {},
+                          prefer_low_replication_},
+          level);
       // Process the returned updates
       for (const auto &[buffer, layout] : updates) {
         // Basic validity checks
@@ -147,6 +195,10 @@ public:
                 as_const_int(src_layout->ReplicateExtent()) &&
                 (*as_const_int(dst_layout->ReplicateExtent()) >
                  *as_const_int(src_layout->ReplicateExtent()))) {
+              LogDecision(cur_infer_id, level, buffer, layout,
+                          "replication raised from " +
+                              std::to_string(*as_const_int(
+                                  src_layout->ReplicateExtent())));
               // update map
               layout_map.Set(buffer, layout);
               continue;
@@ -160,6 +212,7 @@ public:
         } else {
           // Otherwise, update map
           layout_map.Set(buffer, layout);
+          LogDecision(cur_infer_id, level, buffer, layout, "inferred");
           if (!update_queue)
             continue;
 
@@ -256,7 +309,9 @@ public:
       }
     }
 
-    return {layout_map, for_map, predicate_map};
+    LayoutInferenceResult result{layout_map, for_map, predicate_map};
+    EstimateRegisterFootprint(&result);
+    return result;
   }
 
   void Collect(const PrimFunc &f) {
@@ -271,6 +326,72 @@ public:
   }
 
 private:
+  void LogDecision(int infer_id, InferLevel level, const Buffer &buffer,
+                   const Layout &layout, const std::string &what) {
+    auto fragment = layout.as<Fragment>();
+    if (!fragment.defined())
+      return;
+    static const char *level_names[] = {"free", "common", "strict"};
+    std::ostringstream os;
+    os << "op " << infer_id << " ("
+       << (dynamic_cast<ParallelOp *>(infer_list_[infer_id].get())
+               ? "parallel"
+               : "tile op")
+       << ", " << level_names[static_cast<int>(level)] << "): " << what
+       << " " << buffer->name << " replicate="
+       << fragment.value()->ReplicateExtent()
+       << " regs=" << FragmentRegisters(buffer, fragment.value());
+    decisions_.push_back(os.str());
+  }
+
+  /*!
+   * \brief Estimate the peak register footprint of the inferred fragments.
+   *
+   * A fragment is live from the first to the last operator using it, the
+   * footprint at an operator is the sum over the live fragments.
+   */
+  void EstimateRegisterFootprint(LayoutInferenceResult *result) {
+    int num_infer = thread_bounds_vec_.size();
+    int64_t num_threads = 1;
+    for (const Range &bounds : thread_bounds_vec_) {
+      if (const int64_t *extent = as_const_int(bounds->extent))
+        num_threads = std::max(num_threads, *extent);
+    }
+    std::vector<int64_t> pressure(num_infer, 0);
+    std::vector<std::vector<std::string>> live(num_infer);
+    for (const auto &[buffer, uses] : use_list_) {
+      if (buffer.scope() != "local.fragment" || uses.empty() ||
+          !result->layout_map.count(buffer))
+        continue;
+      auto fragment = result->layout_map[buffer].as<Fragment>();
+      if (!fragment.defined())
+        continue;
+      int64_t regs = FragmentRegisters(buffer, fragment.value());
+      auto [first, last] = std::minmax_element(uses.begin(), uses.end());
+      for (int i = *first; i <= *last && i < num_infer; i++) {
+        pressure[i] += regs;
+        live[i].push_back(buffer->name + ":" + std::to_string(regs));
+      }
+    }
+    int peak_id = -1;
+    for (int i = 0; i < num_infer; i++) {
+      if (peak_id < 0 || pressure[i] > pressure[peak_id])
+        peak_id = i;
+    }
+    result->register_budget = RegisterBudget(target_, num_threads);
+    result->decisions = decisions_;
+    if (peak_id < 0)
+      return;
+    result->peak_registers = pressure[peak_id];
+    std::ostringstream os;
+    os << "peak " << pressure[peak_id] << " regs at op " << peak_id
+       << ", budget " << result->register_budget << " for " << num_threads
+       << " threads, live:";
+    for (const std::string &entry : live[peak_id])
+      os << " " << entry;
+    result->decisions.push_back(os.str());
+  }
+
   void VisitExpr_(const CallNode *op) final {
     IRVisitorWithAnalyzer::VisitExpr_(op);
     // Do not analysis the call node to the global function.
@@ -386,6 +507,8 @@ private:
   Target target_;
   LayoutMap annotated_layout_map_;
   bool skip_thread_partition_{false};
+  bool prefer_low_replication_{false};
+  Array<String> decisions_;
 };
 
 class LayoutInferencer : public IRMutatorWithAnalyzer {
@@ -397,16 +520,51 @@ public:
     BufferUseDefCollector collector(skip_thread_partition);
     collector.Collect(f);
     auto result = collector.Run();
-    LayoutInferencer substituter(result, skip_thread_partition, &analyzer);
+    if (result.register_budget > 0 &&
+        result.peak_registers > result.register_budget) {
+      // Over budget: retry with operators avoiding replicated fragments and
+      // keep whichever plan needs fewer registers.
+      BufferUseDefCollector relaxed(skip_thread_partition,
+                                    /*prefer_low_replication=*/true);
+      relaxed.Collect(f);
+      auto relaxed_result = relaxed.Run();
+      if (relaxed_result.peak_registers < result.peak_registers) {
+        relaxed_result.decisions.push_back(
+            "fall back to less replicated layouts, peak " +
+            std::to_string(result.peak_registers) + " -> " +
+            std::to_string(relaxed_result.peak_registers) + " regs");
+        result = relaxed_result;
+      }
+      if (result.peak_registers > result.register_budget) {
+        LOG(WARNING) << "LayoutInference: fragments need an estimated "
+                     << result.peak_registers
+                     << " registers per thread, over the budget of "
+                     << result.register_budget
+                     << ", the kernel is likely to spill. Decisions:\n"
+                     << result.decisions;
+      }
+    }
+    auto target = f->GetAttr<Target>(tvm::attr::kTarget);
+    bool is_cpu = target.defined() && TargetIsCPU(target.value());
+    LayoutInferencer substituter(result, skip_thread_partition, is_cpu,
+                                 &analyzer);
     fptr->body = substituter.VisitStmt(f->body);
+    if (result.peak_registers > 0) {
+      Map<String, ObjectRef> footprint;
+      footprint.Set("peak_registers", Integer(result.peak_registers));
+      footprint.Set("register_budget", Integer(result.register_budget));
+      footprint.Set("decisions", result.decisions);
+      f = WithAttr(std::move(f), attr::kRegisterFootprint, footprint);
+    }
     return f;
   }
 
 private:
   LayoutInferencer(const LayoutInferenceResult result,
-                   bool skip_thread_partition, arith::Analyzer *analyzer)
+                   bool skip_thread_partition, bool is_cpu,
+                   arith::Analyzer *analyzer)
       : arith::IRMutatorWithAnalyzer(analyzer), result_(result),
-        skip_thread_partition_(skip_thread_partition){};
+        skip_thread_partition_(skip_thread_partition), is_cpu_(is_cpu){};
 
   Stmt VisitStmt_(const BlockNode *op) final {
     Block block = Downcast<Block>(IRMutatorWithAnalyzer::VisitStmt_(op));
@@ -469,7 +627,12 @@ private:
       });
 
       if (has_non_local) {
-        for_node = VectorizeLoop(for_node);
+        Optional<For> transposed;
+        if (is_cpu_) {
+          transposed = VectorizeTransposedCopy(for_node);
+        }
+        for_node = transposed.defined() ? transposed.value()
+                                        : VectorizeLoop(for_node);
       }
 
       if (result_.predicate_map.count(root) && parallel_loop) {
@@ -497,6 +660,8 @@ private:
   IterVar thread_var_ = IterVar(Range::FromMinExtent(0, 1), Var("v_thread"),
                                 IterVarType::kDataPar);
   bool skip_thread_partition_{false};
+  // Transposing copies become blocked in-register transposes on CPU.
+  bool is_cpu_{false};
 };
 
 tvm::transform::Pass LayoutInference() {
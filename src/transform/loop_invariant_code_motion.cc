@@ -0,0 +1,415 @@
+/*!
+ * \file loop_invariant_code_motion.cc
+ * \brief Hoist loop invariant loads and predicates out of serial loops.
+ *
+ * Scale factors, block-sparse masks, bias vectors and boundary predicates that
+ * depend only on block indices are reloaded or recomputed in every iteration
+ * of a pipelined loop:
+ *
+ *   for k in range(K // 32):
+ *     for i in range(4):
+ *       C_local[i] = C_local[i] + B_local[k * 4 + i] * Scale[by * 64 + tx]
+ *     if by * 64 + tx < M:
+ *       ...
+ *
+ * Once the pipeline has been injected and the blocks are lowered, this pass
+ * binds such expressions to variables before the loop, innermost loop first,
+ * and moves the bindings further out while they stay invariant:
+ *
+ *   Scale_inv = if_then_else(K // 32 > 0, Scale[by * 64 + tx], 0)
+ *   cond_inv = by * 64 + tx < M
+ *   for k in range(K // 32):
+ *     for i in range(4):
+ *       C_local[i] = C_local[i] + B_local[k * 4 + i] * Scale_inv
+ *     if cond_inv:
+ *       ...
+ *
+ * A load is invariant if its indices are, if its buffer is not written in the
+ * loop, which is decided on the regions of BufferRegionCollector as in
+ * pipeline planning, and if its address is not taken by any call in the loop.
+ * Loads of shared memory are only hoisted out of loops free of barriers and
+ * opaque calls, through which other threads may write them, and loads of
+ * global memory not out of loops issuing TMA stores. Distinct buffers are
+ * assumed not to alias, as kernel parameters are declared restrict. Only
+ * expressions evaluated in every iteration are hoisted, and loads are guarded
+ * by the trip count when it is not known to be positive.
+ */
+
+#include <tvm/arith/analyzer.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/op_attr_types.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <unordered_set>
+
+#include "../op/builtin.h"
+#include "common/buffer_region.h"
+
+namespace tvm {
+namespace tl {
+
+using namespace tir;
+
+namespace {
+
+using VarSet = std::unordered_set<const VarNode *>;
+
+/*! \brief Writes and side effects of a loop body. */
+class LoopEffectCollector : public StmtExprVisitor {
+public:
+  static LoopEffectCollector Collect(const Stmt &body) {
+    LoopEffectCollector collector;
+    collector(body);
+    BufferRegionCollector regions({});
+    regions(body);
+    collector.writes = regions.GetWrites();
+    return collector;
+  }
+
+  Array<BufferRegion> writes;
+  // Buffer data whose address is taken, so that calls may write it.
+  VarSet escaped;
+  // Variables bound inside the loop body.
+  VarSet defined;
+  // Barriers and opaque calls, through which other threads may write shared
+  // memory.
+  bool has_opaque_call = false;
+  // TMA stores write global memory through a descriptor.
+  bool writes_global_opaquely = false;
+
+private:
+  void VisitExpr_(const VarNode *op) final {
+    if (op->dtype.is_handle()) {
+      escaped.insert(op);
+    }
+  }
+
+  void VisitExpr_(const CallNode *op) final {
+    if (op->op.same_as(builtin::address_of())) {
+      if (const auto *load = op->args[0].as<BufferLoadNode>()) {
+        escaped.insert(load->buffer->data.get());
+      }
+    } else if (op->op.same_as(tma_store())) {
+      writes_global_opaquely = true;
+    }
+    if (const auto *call_op = op->op.as<OpNode>()) {
+      static auto op_call_effect =
+          Op::GetAttrMap<TCallEffectKind>("TCallEffectKind");
+      auto effect = static_cast<CallEffectKind>(
+          op_call_effect
+              .get(GetRef<Op>(call_op), Integer(CallEffectKind::kOpaque))
+              ->value);
+      if (effect == CallEffectKind::kUpdateState ||
+          effect == CallEffectKind::kOpaque ||
+          effect == CallEffectKind::kEmbedC) {
+        has_opaque_call = true;
+      }
+    } else {
+      has_opaque_call = true;
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const ForNode *op) final {
+    defined.insert(op->loop_var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const LetStmtNode *op) final {
+    defined.insert(op->var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const LetNode *op) final {
+    defined.insert(op->var.get());
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const AllocateNode *op) final {
+    defined.insert(op->buffer_var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+};
+
+/*!
+ * \brief Replace the invariant expressions evaluated in every iteration of a
+ * loop body with variables bound before the loop.
+ */
+class LoopBodyHoister : public StmtExprMutator {
+public:
+  LoopBodyHoister(const For &loop, LoopEffectCollector effects,
+                  VarSet *hoisted_vars)
+      : loop_(loop), effects_(std::move(effects)),
+        hoisted_vars_(hoisted_vars) {
+    trip_count_positive_ = analyzer_.CanProve(loop->extent > 0);
+  }
+
+  // Bindings to place before the loop, in order of creation.
+  std::vector<std::pair<Var, PrimExpr>> bindings;
+
+private:
+  // Inner loops were processed first, and their invariants bound before them.
+  Stmt VisitStmt_(const ForNode *op) final { return GetRef<Stmt>(op); }
+
+  Stmt VisitStmt_(const WhileNode *op) final { return GetRef<Stmt>(op); }
+
+  Stmt VisitStmt_(const IfThenElseNode *op) final {
+    PrimExpr condition = VisitExpr(op->condition);
+    if (condition.same_as(op->condition)) {
+      return GetRef<Stmt>(op);
+    }
+    auto n = CopyOnWrite(op);
+    n->condition = condition;
+    return Stmt(n);
+  }
+
+  // Move the bindings of inner loops further out when they are invariant here
+  // as well.
+  Stmt VisitStmt_(const LetStmtNode *op) final {
+    if (hoisted_vars_->count(op->var.get()) && IsInvariant(op->value)) {
+      bindings.emplace_back(op->var, Guard(op->value));
+      effects_.defined.erase(op->var.get());
+      return VisitStmt(op->body);
+    }
+    return StmtExprMutator::VisitStmt_(op);
+  }
+
+  PrimExpr VisitExpr(const PrimExpr &expr) final {
+    if (IsWorthHoisting(expr) && IsInvariant(expr)) {
+      return Hoist(expr);
+    }
+    return StmtExprMutator::VisitExpr(expr);
+  }
+
+  PrimExpr VisitExpr_(const CallNode *op) final {
+    if (op->op.same_as(builtin::if_then_else())) {
+      PrimExpr condition = VisitExpr(op->args[0]);
+      if (condition.same_as(op->args[0])) {
+        return GetRef<PrimExpr>(op);
+      }
+      return Call(op->dtype, op->op, {condition, op->args[1], op->args[2]},
+                  op->span);
+    }
+    if (op->op.same_as(builtin::address_of()) ||
+        op->op.same_as(builtin::tvm_access_ptr())) {
+      return GetRef<PrimExpr>(op);
+    }
+    return StmtExprMutator::VisitExpr_(op);
+  }
+
+  // The right operand may be guarded by the left one.
+  PrimExpr VisitExpr_(const AndNode *op) final {
+    PrimExpr a = VisitExpr(op->a);
+    return a.same_as(op->a) ? GetRef<PrimExpr>(op) : And(a, op->b);
+  }
+
+  PrimExpr VisitExpr_(const OrNode *op) final {
+    PrimExpr a = VisitExpr(op->a);
+    return a.same_as(op->a) ? GetRef<PrimExpr>(op) : Or(a, op->b);
+  }
+
+  PrimExpr VisitExpr_(const SelectNode *op) final {
+    PrimExpr condition = VisitExpr(op->condition);
+    return condition.same_as(op->condition)
+               ? GetRef<PrimExpr>(op)
+               : Select(condition, op->true_value, op->false_value);
+  }
+
+  /*! \brief Loads and predicates; the C and CUDA compilers hoist the rest. */
+  bool IsWorthHoisting(const PrimExpr &expr) const {
+    if (expr.dtype().lanes() != 1 || expr.dtype().is_handle() ||
+        expr->IsInstance<VarNode>() || is_const_number(expr)) {
+      return false;
+    }
+    bool has_load = false;
+    int operations = 0;
+    PostOrderVisit(expr, [&](const ObjectRef &obj) {
+      has_load = has_load || obj->IsInstance<BufferLoadNode>();
+      if (obj.as<PrimExprNode>() && !obj->IsInstance<VarNode>() &&
+          !obj->IsInstance<IntImmNode>() && !obj->IsInstance<FloatImmNode>()) {
+        ++operations;
+      }
+    });
+    // Comparing a variable with a constant costs no more than testing a
+    // hoisted flag.
+    return has_load || (expr.dtype().is_bool() && operations > 1);
+  }
+
+  bool IsInvariant(const PrimExpr &expr) const {
+    if (UsesVar(expr, [&](const VarNode *v) {
+          return v == loop_->loop_var.get() || effects_.defined.count(v) > 0;
+        })) {
+      return false;
+    }
+    bool invariant = true;
+    PostOrderVisit(expr, [&](const ObjectRef &obj) {
+      if (!invariant) {
+        return;
+      }
+      if (const auto *load = obj.as<BufferLoadNode>()) {
+        invariant = IsInvariantLoad(load);
+      } else if (const auto *call = obj.as<CallNode>()) {
+        invariant = IsPureCall(call);
+      } else if (obj->IsInstance<LetNode>() ||
+                 obj->IsInstance<ShuffleNode>()) {
+        invariant = false;
+      }
+      // Evaluated before the loop, a division may now run by zero.
+      PrimExpr divisor;
+      if (const auto *div = obj.as<DivNode>()) {
+        divisor = div->b;
+      } else if (const auto *mod = obj.as<ModNode>()) {
+        divisor = mod->b;
+      } else if (const auto *div = obj.as<FloorDivNode>()) {
+        divisor = div->b;
+      } else if (const auto *mod = obj.as<FloorModNode>()) {
+        divisor = mod->b;
+      }
+      if (divisor.defined() && divisor.dtype().is_int() &&
+          (!is_const_int(divisor) || is_zero(divisor))) {
+        invariant = false;
+      }
+    });
+    return invariant;
+  }
+
+  bool IsInvariantLoad(const BufferLoadNode *load) const {
+    const Buffer &buffer = load->buffer;
+    if (load->predicate.defined() ||
+        effects_.escaped.count(buffer->data.get()) ||
+        effects_.defined.count(buffer->data.get())) {
+      return false;
+    }
+    String scope = buffer.scope();
+    if (scope == "shared" || scope == "shared.dyn") {
+      if (effects_.has_opaque_call) {
+        return false;
+      }
+    } else if (scope == "global") {
+      if (effects_.writes_global_opaquely) {
+        return false;
+      }
+    } else if (scope != "local" && scope != "local.fragment" &&
+               scope != "local.var") {
+      return false;
+    }
+    Region region;
+    for (const PrimExpr &index : load->indices) {
+      if (index.dtype().lanes() != 1) {
+        return false;
+      }
+      region.push_back(Range::FromMinExtent(index, 1));
+    }
+    for (const BufferRegion &write : effects_.writes) {
+      if (!write->buffer->data.same_as(buffer->data)) {
+        continue;
+      }
+      if (write->region.size() != region.size() ||
+          MayConflict(write->region, region)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static bool IsPureCall(const CallNode *call) {
+    const auto *op = call->op.as<OpNode>();
+    if (!op) {
+      return false;
+    }
+    static auto op_call_effect =
+        Op::GetAttrMap<TCallEffectKind>("TCallEffectKind");
+    auto effect = static_cast<CallEffectKind>(
+        op_call_effect.get(GetRef<Op>(op), Integer(CallEffectKind::kOpaque))
+            ->value);
+    return effect == CallEffectKind::kPure ||
+           effect == CallEffectKind::kExprAnnotation;
+  }
+
+  /*! \brief Guard the loads of a hoisted expression by the trip count. */
+  PrimExpr Guard(const PrimExpr &expr) const {
+    bool has_load = false;
+    PostOrderVisit(expr, [&](const ObjectRef &obj) {
+      has_load = has_load || obj->IsInstance<BufferLoadNode>();
+    });
+    if (!has_load || trip_count_positive_) {
+      return expr;
+    }
+    return if_then_else(loop_->extent > 0, expr, make_zero(expr.dtype()));
+  }
+
+  PrimExpr Hoist(const PrimExpr &expr) {
+    for (const auto &[var, key] : keys_) {
+      if (StructuralEqual()(key, expr)) {
+        return var;
+      }
+    }
+    std::string name = "cond_inv";
+    PostOrderVisit(expr, [&](const ObjectRef &obj) {
+      if (const auto *load = obj.as<BufferLoadNode>()) {
+        name = load->buffer->name + "_inv";
+      }
+    });
+    Var var(name, expr.dtype());
+    keys_.emplace_back(var, expr);
+    bindings.emplace_back(var, Guard(expr));
+    hoisted_vars_->insert(var.get());
+    return var;
+  }
+
+  For loop_;
+  LoopEffectCollector effects_;
+  VarSet *hoisted_vars_;
+  bool trip_count_positive_;
+  std::vector<std::pair<Var, PrimExpr>> keys_;
+  arith::Analyzer analyzer_;
+};
+
+class LoopInvariantHoister : public StmtExprMutator {
+private:
+  Stmt VisitStmt_(const ForNode *op) final {
+    auto loop = Downcast<For>(StmtExprMutator::VisitStmt_(op));
+    if (loop->kind != ForKind::kSerial && loop->kind != ForKind::kUnrolled) {
+      return loop;
+    }
+    LoopBodyHoister hoister(loop, LoopEffectCollector::Collect(loop->body),
+                            &hoisted_vars_);
+    Stmt body = hoister(loop->body);
+    if (hoister.bindings.empty()) {
+      return loop;
+    }
+    loop.CopyOnWrite()->body = body;
+    Stmt result = loop;
+    for (auto it = hoister.bindings.rbegin(); it != hoister.bindings.rend();
+         ++it) {
+      result = LetStmt(it->first, it->second, result);
+    }
+    return result;
+  }
+
+  VarSet hoisted_vars_;
+};
+
+} // namespace
+
+tvm::transform::Pass LoopInvariantCodeMotion() {
+  using namespace tir::transform;
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    if (ctx->GetConfig<Bool>(kDisableLoopInvariantCodeMotion, Bool(false))
+            .value()) {
+      return f;
+    }
+    auto *n = f.CopyOnWrite();
+    n->body = LoopInvariantHoister()(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tl.LoopInvariantCodeMotion", {});
+}
+
+TVM_REGISTER_GLOBAL("tl.transform.LoopInvariantCodeMotion")
+    .set_body_typed(LoopInvariantCodeMotion);
+
+} // namespace tl
+} // namespace tvm
@@ -25,9 +25,11 @@
 #include "loop_vectorize.h"
 
 #include <tvm/arith/iter_affine_map.h>
+#include <tvm/arith/pattern.h>
 #include <tvm/tir/builtin.h>
 #include <tvm/tir/stmt_functor.h>
 
+#include <algorithm>
 #include <numeric>
 
 #include "../layout/layout.h"
@@ -256,6 +258,109 @@ bool IndiceCanVectorize(PrimExpr expr, Var var, PrimExpr iter_var_size,
   }
 }
 
+Optional<For> VectorizeTransposedCopy(const For &loop) {
+  std::vector<const ForNode *> nest;
+  Stmt stmt = loop;
+  while (const auto *node = stmt.as<ForNode>()) {
+    nest.push_back(node);
+    stmt = node->body;
+  }
+  const auto *store = stmt.as<BufferStoreNode>();
+  if (nest.size() < 2 || !store) {
+    return NullOpt;
+  }
+  PrimExpr value = store->value;
+  if (const auto *cast = value.as<CastNode>()) {
+    value = cast->value;
+  }
+  const auto *load = value.as<BufferLoadNode>();
+  if (!load || load->buffer->data.same_as(store->buffer->data) ||
+      load->buffer.scope() == "local.fragment" ||
+      store->buffer.scope() == "local.fragment" ||
+      load->dtype.lanes() != 1 || store->value.dtype().lanes() != 1) {
+    return NullOpt;
+  }
+  const ForNode *outer = nest[nest.size() - 2];
+  const ForNode *inner = nest.back();
+  const int64_t *outer_extent = as_const_int(outer->extent);
+  const int64_t *inner_extent = as_const_int(inner->extent);
+  if (!outer_extent || !inner_extent || !is_zero(outer->min) ||
+      !is_zero(inner->min)) {
+    return NullOpt;
+  }
+
+  // Strides along the outer and the inner loop, then the base offset.
+  const Buffer &src = load->buffer, &dst = store->buffer;
+  Var i = outer->loop_var, j = inner->loop_var;
+  Array<PrimExpr> src_coeffs =
+      arith::DetectLinearEquation(src.OffsetOf(load->indices).back(), {i, j});
+  Array<PrimExpr> dst_coeffs =
+      arith::DetectLinearEquation(dst.OffsetOf(store->indices).back(), {i, j});
+  if (src_coeffs.empty() || dst_coeffs.empty()) {
+    return NullOpt;
+  }
+  // Rows of a block are read contiguously from the source and written
+  // contiguously, as columns, to the destination.
+  PrimExpr src_stride, dst_stride;
+  if (is_one(src_coeffs[1]) && is_one(dst_coeffs[0]) &&
+      !is_one(dst_coeffs[1])) {
+    src_stride = src_coeffs[0];
+    dst_stride = dst_coeffs[1];
+  } else if (is_one(src_coeffs[0]) && is_one(dst_coeffs[1]) &&
+             !is_one(src_coeffs[1])) {
+    src_stride = src_coeffs[1];
+    dst_stride = dst_coeffs[0];
+  } else {
+    return NullOpt;
+  }
+  // One 16-byte vector of the source per row.
+  int block = std::min(16, std::max(4, 16 / src->dtype.bytes()));
+  arith::Analyzer analyzer;
+  if (*outer_extent % block != 0 || *inner_extent % block != 0 ||
+      !analyzer.CanProve(dst_stride >= block)) {
+    return NullOpt;
+  }
+
+  Var io = i.copy_with_suffix("_outer"), jo = j.copy_with_suffix("_outer");
+  Map<Var, PrimExpr> vmap;
+  vmap.Set(i, io * block);
+  vmap.Set(j, jo * block);
+  auto block_extent = [&](const PrimExpr &stride) {
+    return analyzer.Simplify(stride * (block - 1) + block);
+  };
+  PrimExpr src_ptr = src.access_ptr(
+      1, DataType::Handle(), 1,
+      analyzer.Simplify(Substitute(src_coeffs[0] * i + src_coeffs[1] * j +
+                                       src_coeffs[2],
+                                   vmap)),
+      block_extent(src_stride));
+  PrimExpr dst_ptr = dst.access_ptr(
+      2, DataType::Handle(), 1,
+      analyzer.Simplify(Substitute(dst_coeffs[0] * i + dst_coeffs[1] * j +
+                                       dst_coeffs[2],
+                                   vmap)),
+      block_extent(dst_stride));
+  std::string name = "tl::cpu::transpose_block<" + std::to_string(block) + ">";
+  Stmt body = Evaluate(Call(DataType::Handle(), builtin::call_extern(),
+                            {StringImm(name), src_ptr,
+                             cast(DataType::Int(64), src_stride), dst_ptr,
+                             cast(DataType::Int(64), dst_stride)}));
+
+  auto kind = [](ForKind kind) {
+    return kind == ForKind::kVectorized ? ForKind::kSerial : kind;
+  };
+  body = For(jo, 0, IntImm(j.dtype(), *inner_extent / block),
+             kind(inner->kind), body);
+  body = For(io, 0, IntImm(i.dtype(), *outer_extent / block),
+             kind(outer->kind), body);
+  for (int k = static_cast<int>(nest.size()) - 3; k >= 0; --k) {
+    body = For(nest[k]->loop_var, nest[k]->min, nest[k]->extent,
+               nest[k]->kind, body, nest[k]->thread_binding,
+               nest[k]->annotations);
+  }
+  return Downcast<For>(body);
+}
+
 For VectorizeLoop(const For &loop, int vectorize_hint) {
   VectorizePlanResult res{128, false, 0};
   if (vectorize_hint <= 0) {
@@ -37,6 +37,14 @@ int GetVectorizeSize(const For &loop);
 
 For VectorizeLoop(const For &loop, int vectorize_hint = -1);
 
+/*!
+ * \brief Lower a copy nest whose two innermost loops transpose, i.e. the
+ * source is contiguous along one loop and the destination along the other,
+ * into blocked calls of tl::cpu::transpose_block for CPU targets. Returns
+ * NullOpt for any other loop.
+ */
+Optional<For> VectorizeTransposedCopy(const For &loop);
+
 bool IndiceCanVectorize(PrimExpr expr, Var var, PrimExpr iter_var_size,
                         int target_vectorized_size, arith::Analyzer *analyzer);
 
@@ -439,6 +439,18 @@ private:
     return IRMutatorWithAnalyzer::VisitStmt(lowered);
   }
 
+  Stmt VisitStmt_(const ForNode *op) final {
+    auto for_node = Downcast<For>(IRMutatorWithAnalyzer::VisitStmt_(op));
+    // The CPU worker loop stays serial during layout inference, as parallel
+    // loops are tile operators there. Once tile operators are lowered it can
+    // become a real parallel loop, which also keeps local allocations private
+    // to each worker in StorageRewrite.
+    if (for_node->annotations.count(attr::kCPUWorkerLoop)) {
+      for_node.CopyOnWrite()->kind = ForKind::kParallel;
+    }
+    return for_node;
+  }
+
   Stmt VisitStmt_(const AttrStmtNode *op) final {
     if (op->attr_key == tir::attr::thread_extent) {
       IterVar iv = Downcast<IterVar>(op->node);
@@ -34,6 +34,7 @@
 #include <unordered_set>
 
 #include "../op/builtin.h"
+#include "../target/utils.h"
 #include "runtime/thread_storage_scope.h"
 #include "support/arena.h"
 #include "tir/transforms/ir_utils.h"
@@ -1009,18 +1010,38 @@ private:
   support::Arena arena_;
 };
 
+// Whether all allocations share one element width, i.e. the merged buffer can
+// be declared as a typed array on targets without byte-addressable shared
+// memory (WGSL workgroup arrays).
+bool HasUniformElementWidth(
+    const std::unordered_map<const VarNode *, const AllocateNode *> &allocs) {
+  int bits = -1;
+  for (const auto &kv : allocs) {
+    int alloc_bits = kv.second->dtype.bits();
+    if (bits != -1 && bits != alloc_bits)
+      return false;
+    bits = alloc_bits;
+  }
+  return true;
+}
+
 Stmt MergeSharedMemoryAllocations(Stmt stmt, bool merge_static_smem,
                                   bool enable_aggressive_merge,
-                                  int align_bytes = 16, bool verbose = false) {
+                                  int align_bytes = 16, bool verbose = false,
+                                  bool require_uniform_width = false) {
   AllocateCollector collector;
   collector(stmt);
-  if (collector.dyn_shmem_allocs_.size() > 1) {
+  if (collector.dyn_shmem_allocs_.size() > 1 &&
+      (!require_uniform_width ||
+       HasUniformElementWidth(collector.dyn_shmem_allocs_))) {
     SharedMemoryRewriter rewriter(collector.dyn_shmem_allocs_, true, verbose,
                                   align_bytes);
     rewriter.PlanReuse(stmt, true, enable_aggressive_merge);
     stmt = rewriter(std::move(stmt));
   }
-  if (merge_static_smem && collector.static_shmem_allocs_.size() > 1) {
+  if (merge_static_smem && collector.static_shmem_allocs_.size() > 1 &&
+      (!require_uniform_width ||
+       HasUniformElementWidth(collector.static_shmem_allocs_))) {
     SharedMemoryRewriter rewriter(collector.static_shmem_allocs_, false,
                                   verbose, align_bytes);
     rewriter.PlanReuse(stmt, false, enable_aggressive_merge);
@@ -1042,10 +1063,14 @@ Pass MergeSharedMemoryAllocations(bool enable_aggressive_merge = false,
     bool debug_merge_shared_memory_allocations =
         ctx->GetConfig<Bool>(kDebugMergeSharedMemoryAllocations, Bool(false))
             .value();
+    auto target = f->GetAttr<Target>(tvm::attr::kTarget);
+    bool require_uniform_width =
+        target.defined() && TargetIsWebGPU(target.value());
     auto *n = f.CopyOnWrite();
     n->body = tl::MergeSharedMemoryAllocations(
         std::move(n->body), merge_static_smem, enable_aggressive_merge,
-        align_bytes, debug_merge_shared_memory_allocations);
+        align_bytes, debug_merge_shared_memory_allocations,
+        require_uniform_width);
     return f;
   };
   return CreatePrimFuncPass(pass_func, 0, "tl.MergeSharedMemoryAllocations",
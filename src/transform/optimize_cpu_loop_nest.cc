@@ -0,0 +1,415 @@
+/*!
+ * \file optimize_cpu_loop_nest.cc
+ * \brief Reorder and register tile perfectly nested serial loops on CPU.
+ *
+ * Kernels written with T.grid / T.serial are emitted in source order, e.g.
+ *
+ *   for i, j, k in T.grid(M, N, K):
+ *     C[i, j] += A[i, k] * B[k, j]
+ *
+ * walks B with a stride of N in the innermost loop. For a perfect nest of
+ * serial loops around a single store this pass
+ *
+ *  - computes the element stride of every access along every loop and the
+ *    dependences between iterations, which are legal to reorder when the
+ *    stored element is fixed by the non-reduction loops and the reduction
+ *    loops keep their relative order;
+ *  - interchanges the loops by their cache line cost (the number of lines an
+ *    access touches when the loop runs innermost), which puts the unit-stride
+ *    loop innermost: i, k, j for the nest above;
+ *  - for reductions, tiles the store into a register block of MR rows by NR
+ *    lanes sized to the target's vector registers and unrolls-and-jams the
+ *    rows into the lane loop:
+ *
+ *      for io, jo, k:
+ *        for jv in range(NR):
+ *          for iu in T.unroll(MR):
+ *            C[io * MR + iu, jo * NR + jv] += A[io * MR + iu, k] * B[k, jv..]
+ *
+ *    so that each B vector is loaded once for MR accumulators.
+ */
+
+#include <tvm/arith/analyzer.h>
+#include <tvm/arith/pattern.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <optional>
+
+#include "../op/builtin.h"
+#include "../target/utils.h"
+
+namespace tvm {
+namespace tl {
+
+using namespace tir;
+
+namespace {
+
+constexpr int64_t kCacheLineBytes = 64;
+// Upper bound of the rows jammed into one register block.
+constexpr int64_t kMaxJamRows = 8;
+
+struct VectorRegisters {
+  int64_t bytes;
+  int64_t count;
+};
+
+/*!
+ * \brief Vector register file of a CPU target. The C backend is built by the
+ * host compiler without -march, so it gets the 128-bit baseline.
+ */
+VectorRegisters GetVectorRegisters(const Target &target) {
+  std::string features;
+  if (auto mcpu = target->GetAttr<String>("mcpu")) {
+    features += mcpu.value();
+  }
+  if (auto mtriple = target->GetAttr<String>("mtriple")) {
+    features += " " + std::string(mtriple.value());
+  }
+  if (auto mattr = target->GetAttr<Array<String>>("mattr")) {
+    for (const String &attr : mattr.value()) {
+      features += " " + std::string(attr);
+    }
+  }
+  auto has = [&](const char *feature) {
+    return features.find(feature) != std::string::npos;
+  };
+  if (has("avx512") || has("sapphirerapids") || has("icelake") ||
+      has("znver4")) {
+    return {64, 32};
+  }
+  if (has("avx") || has("haswell") || has("skylake") || has("znver")) {
+    return {32, 16};
+  }
+  if (has("aarch64") || has("arm64") || has("neon")) {
+    return {16, 32};
+  }
+  return {16, 16};
+}
+
+struct Loop {
+  Var var;
+  int64_t extent;
+  // The loop does not index the stored element.
+  bool reduction;
+};
+
+struct Access {
+  Buffer buffer;
+  Array<PrimExpr> indices;
+};
+
+/*!
+ * \brief Element stride of an access along `var`, or nullopt when an index is
+ * not affine in `var` or the buffer strides are not constant.
+ */
+std::optional<int64_t> AccessStride(const Access &access, const Var &var) {
+  const Buffer &buffer = access.buffer;
+  int64_t stride = 0;
+  // Stride of dimension d, unknown past a dimension of symbolic extent.
+  std::optional<int64_t> dim_stride = 1;
+  for (int d = static_cast<int>(access.indices.size()) - 1; d >= 0; --d) {
+    if (!buffer->strides.empty()) {
+      const int64_t *s = as_const_int(buffer->strides[d]);
+      dim_stride = s ? std::optional<int64_t>(*s) : std::nullopt;
+    }
+    Array<PrimExpr> coeffs =
+        arith::DetectLinearEquation(access.indices[d], {var});
+    if (coeffs.empty() || !as_const_int(coeffs[0])) {
+      return std::nullopt;
+    }
+    int64_t coeff = *as_const_int(coeffs[0]);
+    if (coeff != 0) {
+      if (!dim_stride) {
+        return std::nullopt;
+      }
+      stride += coeff * *dim_stride;
+    }
+    if (buffer->strides.empty() && dim_stride) {
+      const int64_t *extent = as_const_int(buffer->shape[d]);
+      dim_stride = extent ? std::optional<int64_t>(*dim_stride * *extent)
+                          : std::nullopt;
+    }
+  }
+  return stride;
+}
+
+/*! \brief Cache lines the accesses touch while `loop` runs innermost. */
+double LoopCost(const Loop &loop, const std::vector<Access> &accesses) {
+  double cost = 0;
+  for (const Access &access : accesses) {
+    std::optional<int64_t> stride = AccessStride(access, loop.var);
+    if (!stride) {
+      cost += loop.extent;
+    } else if (*stride == 0) {
+      cost += 1;
+    } else {
+      int64_t bytes = std::abs(*stride) * access.buffer->dtype.bytes();
+      cost += bytes >= kCacheLineBytes
+                  ? loop.extent
+                  : std::ceil(static_cast<double>(loop.extent * bytes) /
+                              kCacheLineBytes);
+    }
+  }
+  return cost;
+}
+
+int64_t LargestDivisor(int64_t extent, int64_t cap) {
+  for (int64_t d = std::min(extent, cap); d > 1; --d) {
+    if (extent % d == 0) {
+      return d;
+    }
+  }
+  return 1;
+}
+
+class CPULoopNestOptimizer : public StmtExprMutator {
+public:
+  explicit CPULoopNestOptimizer(VectorRegisters regs) : regs_(regs) {}
+
+private:
+  Stmt VisitStmt_(const ForNode *op) final {
+    std::vector<Loop> loops;
+    Stmt stmt = GetRef<Stmt>(op);
+    while (const auto *loop = stmt.as<ForNode>()) {
+      const int64_t *extent = as_const_int(loop->extent);
+      if (loop->kind != ForKind::kSerial || !loop->annotations.empty() ||
+          !is_zero(loop->min) || !extent) {
+        break;
+      }
+      loops.push_back({loop->loop_var, *extent, false});
+      stmt = loop->body;
+    }
+    // Only perfect nests around a single store are reordered, inner nests of
+    // other loops are tried on their own.
+    const auto *store = stmt.as<BufferStoreNode>();
+    if (loops.size() >= 2 && store) {
+      if (auto optimized = Optimize(loops, GetRef<BufferStore>(store))) {
+        return optimized.value();
+      }
+    }
+    return StmtExprMutator::VisitStmt_(op);
+  }
+
+  /*!
+   * \brief Check that reordering the nest preserves its dependences: the
+   * stored element is an injective function of the non-reduction loops and
+   * every read of the stored buffer reads that element.
+   */
+  static bool Legal(std::vector<Loop> *loops, const BufferStore &store,
+                    const std::vector<Access> &loads) {
+    if (SideEffect(store->value) > CallEffectKind::kReadState) {
+      return false;
+    }
+    for (const Access &load : loads) {
+      if (!load.buffer->data.same_as(store->buffer->data)) {
+        continue;
+      }
+      if (load.indices.size() != store->indices.size()) {
+        return false;
+      }
+      for (size_t d = 0; d < load.indices.size(); ++d) {
+        if (!StructuralEqual()(load.indices[d], store->indices[d])) {
+          return false;
+        }
+      }
+    }
+    std::vector<int> dims_of_loop(loops->size(), 0);
+    for (const PrimExpr &index : store->indices) {
+      int used = 0;
+      for (size_t l = 0; l < loops->size(); ++l) {
+        const Var &var = (*loops)[l].var;
+        if (!UsesVar(index, [&](const VarNode *v) { return v == var.get(); })) {
+          continue;
+        }
+        Array<PrimExpr> coeffs = arith::DetectLinearEquation(index, {var});
+        if (coeffs.empty() || is_zero(coeffs[0]) ||
+            !as_const_int(coeffs[0])) {
+          return false;
+        }
+        ++used;
+        ++dims_of_loop[l];
+      }
+      if (used > 1) {
+        return false;
+      }
+    }
+    for (size_t l = 0; l < loops->size(); ++l) {
+      if (dims_of_loop[l] > 1) {
+        return false;
+      }
+      (*loops)[l].reduction = dims_of_loop[l] == 0;
+    }
+    return true;
+  }
+
+  Optional<Stmt> Optimize(std::vector<Loop> loops, const BufferStore &store) {
+    std::vector<Access> loads;
+    PostOrderVisit(store->value, [&](const ObjectRef &obj) {
+      if (const auto *load = obj.as<BufferLoadNode>()) {
+        loads.push_back({load->buffer, load->indices});
+      }
+    });
+    if (!Legal(&loops, store, loads)) {
+      return NullOpt;
+    }
+    std::vector<Access> accesses = loads;
+    accesses.push_back({store->buffer, store->indices});
+
+    // Most expensive loops outermost, ties keep the source order.
+    std::vector<double> cost;
+    for (const Loop &loop : loops) {
+      cost.push_back(LoopCost(loop, accesses));
+    }
+    std::vector<int> order(loops.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+      order[i] = static_cast<int>(i);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](int a, int b) { return cost[a] > cost[b]; });
+    // Reduction loops take their slots in the source order, which keeps the
+    // order of the updates of every stored element.
+    std::vector<int> reductions;
+    for (size_t i = 0; i < loops.size(); ++i) {
+      if (loops[i].reduction) {
+        reductions.push_back(static_cast<int>(i));
+      }
+    }
+    for (size_t i = 0, r = 0; i < order.size(); ++i) {
+      if (loops[order[i]].reduction) {
+        order[i] = reductions[r++];
+      }
+    }
+
+    if (auto tiled = RegisterTile(loops, order, reductions, store)) {
+      return tiled;
+    }
+    if (std::is_sorted(order.begin(), order.end())) {
+      return NullOpt;
+    }
+    Stmt body = store;
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+      const Loop &loop = loops[*it];
+      body = MakeLoop(loop.var, loop.extent, ForKind::kSerial, body);
+    }
+    return body;
+  }
+
+  /*!
+   * \brief Unroll-and-jam the innermost non-reduction loop above the lane loop
+   * into a register block of MR x NR accumulators kept across the reduction
+   * loops.
+   */
+  Optional<Stmt> RegisterTile(const std::vector<Loop> &loops,
+                              const std::vector<int> &order,
+                              const std::vector<int> &reductions,
+                              const BufferStore &store) {
+    const Loop &lane = loops[order.back()];
+    if (reductions.empty() || lane.reduction ||
+        AccessStride({store->buffer, store->indices}, lane.var) != 1) {
+      return NullOpt;
+    }
+    int jam_index = -1;
+    for (int i = static_cast<int>(order.size()) - 2; i >= 0; --i) {
+      if (!loops[order[i]].reduction) {
+        jam_index = order[i];
+        break;
+      }
+    }
+    if (jam_index < 0) {
+      return NullOpt;
+    }
+    const Loop &jam = loops[jam_index];
+
+    int64_t lanes = std::max<int64_t>(1, regs_.bytes / store->buffer->dtype.bytes());
+    int64_t nr;
+    if (lane.extent % lanes == 0) {
+      nr = lanes * LargestDivisor(lane.extent / lanes, 2);
+    } else if (lane.extent <= 2 * lanes) {
+      nr = lane.extent;
+    } else {
+      return NullOpt;
+    }
+    int64_t nr_vectors = (nr + lanes - 1) / lanes;
+    // One register for the broadcast row operand and NR lanes of the shared
+    // column operand besides the accumulators.
+    int64_t mr_cap = std::min(kMaxJamRows, (regs_.count - nr_vectors - 1) / nr_vectors);
+    int64_t mr = LargestDivisor(jam.extent, mr_cap);
+    if (mr == 1) {
+      return NullOpt;
+    }
+
+    Var jam_outer = jam.var.copy_with_suffix("_outer");
+    Var jam_inner = jam.var.copy_with_suffix("_inner");
+    Var lane_outer = lane.var.copy_with_suffix("_outer");
+    Var lane_inner = lane.var.copy_with_suffix("_inner");
+    auto split = [](const Var &outer, const Var &inner, int64_t extent,
+                    int64_t factor) -> PrimExpr {
+      if (extent == factor) {
+        return inner;
+      }
+      return outer * make_const(outer.dtype(), factor) + inner;
+    };
+    Map<Var, PrimExpr> vmap;
+    vmap.Set(jam.var, split(jam_outer, jam_inner, jam.extent, mr));
+    vmap.Set(lane.var, split(lane_outer, lane_inner, lane.extent, nr));
+    Stmt body = Substitute(Stmt(store), vmap);
+
+    body = MakeLoop(jam_inner, mr, ForKind::kUnrolled, body);
+    body = MakeLoop(lane_inner, nr, ForKind::kSerial, body);
+    for (auto it = reductions.rbegin(); it != reductions.rend(); ++it) {
+      body = MakeLoop(loops[*it].var, loops[*it].extent, ForKind::kSerial, body);
+    }
+    if (lane.extent != nr) {
+      body = MakeLoop(lane_outer, lane.extent / nr, ForKind::kSerial, body);
+    }
+    if (jam.extent != mr) {
+      body = MakeLoop(jam_outer, jam.extent / mr, ForKind::kSerial, body);
+    }
+    for (int i = static_cast<int>(order.size()) - 1; i >= 0; --i) {
+      const Loop &loop = loops[order[i]];
+      if (!loop.reduction && order[i] != jam_index && order[i] != order.back()) {
+        body = MakeLoop(loop.var, loop.extent, ForKind::kSerial, body);
+      }
+    }
+    return body;
+  }
+
+  static Stmt MakeLoop(const Var &var, int64_t extent, ForKind kind, Stmt body) {
+    return For(var, make_zero(var.dtype()), make_const(var.dtype(), extent),
+               kind, std::move(body));
+  }
+
+  VectorRegisters regs_;
+};
+
+} // namespace
+
+tvm::transform::Pass OptimizeCPULoopNest() {
+  using namespace tir::transform;
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    if (ctx->GetConfig<Bool>(kDisableLoopNestOptimize, Bool(false)).value()) {
+      return f;
+    }
+    Optional<Target> target = f->GetAttr<Target>(tvm::attr::kTarget);
+    if (!target.defined() || !TargetIsCPU(target.value())) {
+      return f;
+    }
+    auto *n = f.CopyOnWrite();
+    n->body = CPULoopNestOptimizer(GetVectorRegisters(target.value()))(
+        std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tl.OptimizeCPULoopNest", {});
+}
+
+TVM_REGISTER_GLOBAL("tl.transform.OptimizeCPULoopNest")
+    .set_body_typed(OptimizeCPULoopNest);
+
+} // namespace tl
+} // namespace tvm
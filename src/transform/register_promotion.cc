@@ -0,0 +1,421 @@
+/*!
+ * \file register_promotion.cc
+ * \brief Keep loop invariant tiles of local buffers in registers across a loop.
+ *
+ * A reduction such as
+ *
+ *   for k in range(K):
+ *     for j in range(8):
+ *       C_local[i, j] = C_local[i, j] + A_local[i, k] * B_local[k, j]
+ *
+ * loads and stores the same eight elements of C_local on every iteration of
+ * k. Once the buffer is flattened (and, on CPU, its address escapes into the
+ * gemm templates) the C compiler can no longer prove that the stores of the
+ * other buffers leave it untouched, so the elements stay in memory. This pass
+ * finds elements, or small boxes of elements, of local buffers that a serial
+ * loop reads and writes at loop invariant offsets and replaces them with a
+ * private local buffer of the size of the box:
+ *
+ *   for j in T.unroll(8): C_local_reg[0, j] = C_local[i, j]
+ *   for k in range(K):
+ *     for j in range(8):
+ *       C_local_reg[0, j] = C_local_reg[0, j] + A_local[i, k] * B_local[k, j]
+ *   for j in T.unroll(8): C_local[i, j] = C_local_reg[0, j]
+ *
+ * The copy loops are unrolled and the new buffer never escapes, so it is
+ * promoted to scalar or vector registers by both the C and the CUDA compiler.
+ */
+
+#include <tvm/arith/analyzer.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../op/builtin.h"
+
+namespace tvm {
+namespace tl {
+
+using namespace tir;
+
+namespace {
+
+// Upper bound of the elements of a promoted box, one register file worth.
+constexpr int64_t kMaxPromotedElements = 64;
+
+bool IsLocalScope(const Buffer &buffer) {
+  return buffer.scope() == "local" || buffer.scope() == "local.fragment";
+}
+
+/*!
+ * \brief Accesses of the local buffers in the body of a loop, and what is
+ * defined inside it.
+ */
+class LoopBodyCollector : public StmtExprVisitor {
+public:
+  struct BufferAccesses {
+    Buffer buffer;
+    std::vector<const Object *> nodes;
+    std::vector<Array<PrimExpr>> indices;
+    bool written{false};
+    // Accessed conditionally, through another buffer object or with
+    // indirect or vector indices.
+    bool irregular{false};
+  };
+
+  std::unordered_map<const VarNode *, BufferAccesses> accesses;
+  std::unordered_set<const VarNode *> escaped;
+  // Loops with constant bounds, and every other variable defined in the body.
+  std::unordered_map<const VarNode *, Range> loop_ranges;
+  std::unordered_set<const VarNode *> defined;
+  bool unsupported_loop{false};
+
+  void VisitStmt_(const ForNode *op) final {
+    defined.insert(op->loop_var.get());
+    if (op->kind == ForKind::kParallel || op->kind == ForKind::kThreadBinding) {
+      unsupported_loop = true;
+    }
+    if (as_const_int(op->min) && as_const_int(op->extent)) {
+      loop_ranges[op->loop_var.get()] =
+          Range::FromMinExtent(op->min, op->extent);
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const LetStmtNode *op) final {
+    defined.insert(op->var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const LetNode *op) final {
+    defined.insert(op->var.get());
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const AllocateNode *op) final {
+    defined.insert(op->buffer_var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const IfThenElseNode *op) final {
+    VisitExpr(op->condition);
+    ++conditional_;
+    VisitStmt(op->then_case);
+    if (op->else_case) {
+      VisitStmt(op->else_case.value());
+    }
+    --conditional_;
+  }
+
+  void VisitExpr_(const CallNode *op) final {
+    if (op->op.same_as(builtin::if_then_else())) {
+      VisitExpr(op->args[0]);
+      ++conditional_;
+      VisitExpr(op->args[1]);
+      VisitExpr(op->args[2]);
+      --conditional_;
+      return;
+    }
+    if (op->op.same_as(builtin::address_of())) {
+      if (const auto *load = op->args[0].as<BufferLoadNode>()) {
+        escaped.insert(load->buffer->data.get());
+      }
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const SelectNode *op) final {
+    VisitExpr(op->condition);
+    ++conditional_;
+    VisitExpr(op->true_value);
+    VisitExpr(op->false_value);
+    --conditional_;
+  }
+
+  // Buffer data reached through anything but a load or store escapes.
+  void VisitExpr_(const VarNode *op) final { escaped.insert(op); }
+
+  void VisitExpr_(const BufferLoadNode *op) final {
+    Record(op, op->buffer, op->indices, false);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const BufferStoreNode *op) final {
+    Record(op, op->buffer, op->indices, true);
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+private:
+  void Record(const Object *node, const Buffer &buffer,
+              const Array<PrimExpr> &indices, bool write) {
+    if (!IsLocalScope(buffer)) {
+      return;
+    }
+    auto &entry = accesses[buffer->data.get()];
+    if (!entry.buffer.defined()) {
+      entry.buffer = buffer;
+    }
+    entry.nodes.push_back(node);
+    entry.indices.push_back(indices);
+    entry.written |= write;
+    if (conditional_ > 0 || !entry.buffer.same_as(buffer)) {
+      entry.irregular = true;
+    }
+    for (const PrimExpr &index : indices) {
+      if (index.dtype().lanes() != 1 ||
+          SideEffect(index) > CallEffectKind::kPure) {
+        entry.irregular = true;
+      }
+      PostOrderVisit(index, [&](const ObjectRef &obj) {
+        if (obj->IsInstance<BufferLoadNode>()) {
+          entry.irregular = true;
+        }
+      });
+    }
+  }
+
+  int conditional_{0};
+};
+
+/*! \brief A box of a buffer promoted across a loop. */
+struct Promotion {
+  Buffer buffer;
+  Buffer reg;
+  // Loop invariant origin of the box, and its extent in every dimension.
+  Array<PrimExpr> origin;
+  std::vector<int64_t> extent;
+  // Box relative indices of every access in the loop body.
+  std::unordered_map<const Object *, Array<PrimExpr>> indices;
+};
+
+class AccessReplacer : public StmtExprMutator {
+public:
+  explicit AccessReplacer(const std::vector<Promotion> &promotions) {
+    for (const Promotion &promotion : promotions) {
+      for (const auto &[node, indices] : promotion.indices) {
+        replace_[node] = {promotion.reg, indices};
+      }
+    }
+  }
+
+private:
+  PrimExpr VisitExpr_(const BufferLoadNode *op) final {
+    auto it = replace_.find(op);
+    PrimExpr expr = StmtExprMutator::VisitExpr_(op);
+    if (it == replace_.end()) {
+      return expr;
+    }
+    return BufferLoad(it->second.first, it->second.second);
+  }
+
+  Stmt VisitStmt_(const BufferStoreNode *op) final {
+    auto it = replace_.find(op);
+    Stmt stmt = StmtExprMutator::VisitStmt_(op);
+    if (it == replace_.end()) {
+      return stmt;
+    }
+    auto *store = stmt.as<BufferStoreNode>();
+    return BufferStore(it->second.first, store->value, it->second.second);
+  }
+
+  std::unordered_map<const Object *, std::pair<Buffer, Array<PrimExpr>>>
+      replace_;
+};
+
+class RegisterPromoter : public StmtExprMutator {
+private:
+  Stmt VisitStmt_(const ForNode *op) final {
+    if ((op->kind != ForKind::kSerial && op->kind != ForKind::kUnrolled) ||
+        !analyzer_.CanProve(op->extent > 0)) {
+      return StmtExprMutator::VisitStmt_(op);
+    }
+    LoopBodyCollector collector;
+    collector(op->body);
+    if (collector.unsupported_loop) {
+      return StmtExprMutator::VisitStmt_(op);
+    }
+    collector.defined.insert(op->loop_var.get());
+
+    std::vector<Promotion> promotions;
+    for (const auto &[data, accesses] : collector.accesses) {
+      if (auto promotion = Plan(accesses, collector)) {
+        promotions.push_back(std::move(promotion.value()));
+      }
+    }
+    if (promotions.empty()) {
+      return StmtExprMutator::VisitStmt_(op);
+    }
+    // Keep the order of the new buffers independent of hashing.
+    std::sort(promotions.begin(), promotions.end(),
+              [](const Promotion &a, const Promotion &b) {
+                return a.buffer->name < b.buffer->name;
+              });
+
+    For loop = GetRef<For>(op);
+    loop.CopyOnWrite()->body = AccessReplacer(promotions)(op->body);
+    // Promote other buffers of inner loops.
+    Stmt body = StmtExprMutator::VisitStmt_(loop.get());
+    for (const Promotion &promotion : promotions) {
+      body = SeqStmt({Copy(promotion, true), body, Copy(promotion, false)});
+      body = DeclBuffer(promotion.reg, body);
+      body = Allocate(promotion.reg->data, promotion.reg->dtype,
+                      promotion.reg->shape, const_true(), body);
+    }
+    return body;
+  }
+
+  /*!
+   * \brief Split every index of the accesses of a buffer into a loop invariant
+   * origin and an offset bounded by the inner loops, and check that the box
+   * spanned by the offsets is small.
+   */
+  Optional<Promotion>
+  Plan(const LoopBodyCollector::BufferAccesses &accesses,
+       const LoopBodyCollector &collector) {
+    const Buffer &buffer = accesses.buffer;
+    if (!accesses.written || accesses.irregular ||
+        collector.escaped.count(buffer->data.get()) ||
+        collector.defined.count(buffer->data.get())) {
+      return NullOpt;
+    }
+    arith::Analyzer analyzer;
+    Map<Var, PrimExpr> loop_min;
+    for (const auto &[var, range] : collector.loop_ranges) {
+      analyzer.Bind(GetRef<Var>(var), range);
+      loop_min.Set(GetRef<Var>(var), range->min);
+    }
+    auto inner_loop_var = [&](const VarNode *v) {
+      return collector.loop_ranges.count(v) > 0;
+    };
+
+    size_t ndim = buffer->shape.size();
+    Promotion promotion;
+    promotion.buffer = buffer;
+    std::vector<int64_t> box_min(ndim), box_max(ndim);
+    std::vector<std::vector<PrimExpr>> offsets(accesses.nodes.size());
+    for (size_t a = 0; a < accesses.nodes.size(); ++a) {
+      for (size_t d = 0; d < ndim; ++d) {
+        const PrimExpr &index = accesses.indices[a][d];
+        PrimExpr origin = analyzer.Simplify(Substitute(index, loop_min));
+        if (UsesVar(origin, [&](const VarNode *v) {
+              return collector.defined.count(v) > 0;
+            })) {
+          return NullOpt;
+        }
+        if (a == 0) {
+          promotion.origin.push_back(origin);
+        }
+        PrimExpr offset =
+            analyzer.Simplify(index - promotion.origin[d]);
+        if (UsesVar(offset,
+                    [&](const VarNode *v) { return !inner_loop_var(v); })) {
+          return NullOpt;
+        }
+        arith::ConstIntBound bound = analyzer.const_int_bound(offset);
+        if (bound->min_value == arith::ConstIntBound::kNegInf ||
+            bound->max_value == arith::ConstIntBound::kPosInf) {
+          return NullOpt;
+        }
+        box_min[d] = a == 0 ? bound->min_value
+                            : std::min(box_min[d], bound->min_value);
+        box_max[d] = a == 0 ? bound->max_value
+                            : std::max(box_max[d], bound->max_value);
+        offsets[a].push_back(offset);
+      }
+    }
+
+    int64_t elements = 1, buffer_elements = 1;
+    Array<PrimExpr> shape;
+    for (size_t d = 0; d < ndim; ++d) {
+      int64_t extent = box_max[d] - box_min[d] + 1;
+      elements *= extent;
+      promotion.extent.push_back(extent);
+      shape.push_back(make_const(DataType::Int(32), extent));
+      promotion.origin.Set(d, analyzer.Simplify(
+                                  promotion.origin[d] +
+                                  make_const(promotion.origin[d].dtype(),
+                                             box_min[d])));
+      const int64_t *dim = as_const_int(buffer->shape[d]);
+      buffer_elements *= dim ? *dim : kMaxPromotedElements + 1;
+    }
+    // A box covering the whole buffer is as small as the buffer already is.
+    if (elements > kMaxPromotedElements || elements >= buffer_elements) {
+      return NullOpt;
+    }
+
+    promotion.reg = decl_buffer(shape, buffer->dtype, buffer->name + "_reg",
+                                "local");
+    for (size_t a = 0; a < accesses.nodes.size(); ++a) {
+      Array<PrimExpr> indices;
+      for (size_t d = 0; d < ndim; ++d) {
+        indices.push_back(analyzer.Simplify(
+            offsets[a][d] - make_const(offsets[a][d].dtype(), box_min[d])));
+      }
+      promotion.indices[accesses.nodes[a]] = indices;
+    }
+    return promotion;
+  }
+
+  /*! \brief Copy the box into its registers before the loop, or back after. */
+  static Stmt Copy(const Promotion &promotion, bool load) {
+    size_t ndim = promotion.extent.size();
+    std::vector<Var> vars;
+    Array<PrimExpr> reg_indices, buffer_indices;
+    for (size_t d = 0; d < ndim; ++d) {
+      DataType dtype = promotion.origin[d].dtype();
+      if (promotion.extent[d] == 1) {
+        reg_indices.push_back(make_zero(DataType::Int(32)));
+        buffer_indices.push_back(promotion.origin[d]);
+        continue;
+      }
+      Var var("r" + std::to_string(d), dtype);
+      vars.push_back(var);
+      reg_indices.push_back(var);
+      buffer_indices.push_back(promotion.origin[d] + var);
+    }
+    Stmt body = load ? BufferStore(promotion.reg,
+                                   BufferLoad(promotion.buffer, buffer_indices),
+                                   reg_indices)
+                     : BufferStore(promotion.buffer,
+                                   BufferLoad(promotion.reg, reg_indices),
+                                   buffer_indices);
+    for (size_t d = ndim, v = vars.size(); d-- > 0;) {
+      if (promotion.extent[d] == 1) {
+        continue;
+      }
+      const Var &var = vars[--v];
+      body = For(var, make_zero(var.dtype()),
+                 make_const(var.dtype(), promotion.extent[d]),
+                 ForKind::kUnrolled, body);
+    }
+    return body;
+  }
+
+  arith::Analyzer analyzer_;
+};
+
+} // namespace
+
+tvm::transform::Pass RegisterPromotion() {
+  using namespace tir::transform;
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    if (ctx->GetConfig<Bool>(kDisableRegisterPromotion, Bool(false)).value()) {
+      return f;
+    }
+    auto *n = f.CopyOnWrite();
+    n->body = RegisterPromoter()(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tl.RegisterPromotion", {});
+}
+
+TVM_REGISTER_GLOBAL("tl.transform.RegisterPromotion")
+    .set_body_typed(RegisterPromotion);
+
+} // namespace tl
+} // namespace tvm
@@ -0,0 +1,389 @@
+/*!
+ * \file slp_vectorize.cc
+ * \brief Pack runs of isomorphic scalar statements into vector statements.
+ *
+ * Once UnrollLoop has expanded the per-thread loops over fragments and local
+ * tiles, an elementwise epilogue is a straight-line run of scalar stores such
+ * as
+ *
+ *   B_local[4] = A_local[4] * scale + bias[bx * 8 + 4]
+ *   B_local[5] = A_local[5] * scale + bias[bx * 8 + 5]
+ *   B_local[6] = A_local[6] * scale + bias[bx * 8 + 6]
+ *   B_local[7] = A_local[7] * scale + bias[bx * 8 + 7]
+ *
+ * VectorizeLoop never sees these, as there is no loop left. This pass finds
+ * adjacent stores to consecutive elements whose values have the same shape and
+ * whose loads either walk consecutive elements or repeat one element, and
+ * packs them into one store of at most 128 bits:
+ *
+ *   B_local[ramp(4, 1, 4)] = A_local[ramp(4, 1, 4)] * broadcast(scale, 4)
+ *                            + bias[ramp(bx * 8 + 4, 1, 4)]
+ *
+ * Vector accesses must start at a multiple of the lane count, which is what
+ * the C and CUDA code generators require of packed loads. A run is left
+ * scalar if a lane reads an element that an earlier lane of the run writes.
+ */
+
+#include <tvm/arith/analyzer.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include "../op/builtin.h"
+
+namespace tvm {
+namespace tl {
+
+using namespace tir;
+
+namespace {
+
+// Widest packed access, one SSE / NEON register or one 128-bit CUDA load.
+constexpr int kMaxVectorBits = 128;
+
+/*! \brief What the code generator of a target can print as a vector. */
+struct VectorTarget {
+  // The C target prints vectors as GCC vector extensions, whose casts
+  // reinterpret bits and which have no min / max, and half is a class type.
+  bool allow_cast;
+  bool allow_min_max;
+  bool allow_half;
+};
+
+class SLPVectorizer : public StmtExprMutator {
+public:
+  explicit SLPVectorizer(VectorTarget target) : target_(target) {}
+
+private:
+  Stmt VisitStmt_(const SeqStmtNode *op) final {
+    Stmt visited = StmtExprMutator::VisitStmt_(op);
+    const auto *seq = visited.as<SeqStmtNode>();
+    if (!seq) {
+      return visited;
+    }
+    std::vector<Stmt> stmts;
+    for (const Stmt &stmt : seq->seq) {
+      if (const auto *inner = stmt.as<SeqStmtNode>()) {
+        stmts.insert(stmts.end(), inner->seq.begin(), inner->seq.end());
+      } else {
+        stmts.push_back(stmt);
+      }
+    }
+    Array<Stmt> packed;
+    bool changed = false;
+    for (size_t i = 0; i < stmts.size();) {
+      int lanes = 0;
+      Optional<Stmt> group;
+      for (int width = MaxLanes(stmts[i]); width >= 2; width /= 2) {
+        if (i + width > stmts.size()) {
+          continue;
+        }
+        std::vector<BufferStore> stores;
+        for (int t = 0; t < width; ++t) {
+          if (const auto *store = stmts[i + t].as<BufferStoreNode>()) {
+            stores.push_back(GetRef<BufferStore>(store));
+          }
+        }
+        if (static_cast<int>(stores.size()) != width) {
+          continue;
+        }
+        group = Pack(stores);
+        if (group.defined()) {
+          lanes = width;
+          break;
+        }
+      }
+      if (group.defined()) {
+        packed.push_back(group.value());
+        i += lanes;
+        changed = true;
+      } else {
+        packed.push_back(stmts[i]);
+        i += 1;
+      }
+    }
+    return changed ? SeqStmt(packed) : visited;
+  }
+
+  /*! \brief Lanes of the widest vector of the stored element type. */
+  int MaxLanes(const Stmt &stmt) const {
+    const auto *store = stmt.as<BufferStoreNode>();
+    if (!store || store->value.dtype().lanes() != 1 ||
+        store->indices.size() != 1) {
+      return 0;
+    }
+    DataType t = store->value.dtype();
+    if (!IsPackable(t)) {
+      return 0;
+    }
+    return kMaxVectorBits / t.bits();
+  }
+
+  bool IsPackable(const DataType &t) const {
+    if (t.lanes() != 1 || t.bits() < 8) {
+      return false;
+    }
+    if (t.is_float16() || t.is_bfloat16()) {
+      return target_.allow_half;
+    }
+    return t.is_float() || t.is_int() || t.is_uint();
+  }
+
+  /*! \brief Whether a vector access starting at base is lane aligned. */
+  bool IsAligned(const PrimExpr &base, int lanes) {
+    arith::ModularSet m = analyzer_.modular_set(base);
+    return m->coeff % lanes == 0 && m->base % lanes == 0;
+  }
+
+  /*! \brief Constant value of b - a, if any. */
+  Optional<IntImm> ConstDiff(const PrimExpr &a, const PrimExpr &b) {
+    PrimExpr diff = analyzer_.Simplify(b - a);
+    if (const auto *imm = diff.as<IntImmNode>()) {
+      return GetRef<IntImm>(imm);
+    }
+    return NullOpt;
+  }
+
+  /*!
+   * \brief The index of a vector access whose lane t accesses indices[t]:
+   * a ramp for consecutive elements, or nothing if the lanes are irregular.
+   * broadcast is set when every lane accesses the same element.
+   */
+  Optional<PrimExpr> PackIndex(const std::vector<PrimExpr> &indices,
+                               bool *broadcast) {
+    int lanes = static_cast<int>(indices.size());
+    bool same = true, consecutive = true;
+    for (int t = 1; t < lanes; ++t) {
+      Optional<IntImm> diff = ConstDiff(indices[0], indices[t]);
+      if (!diff.defined()) {
+        return NullOpt;
+      }
+      same = same && diff.value()->value == 0;
+      consecutive = consecutive && diff.value()->value == t;
+    }
+    *broadcast = same;
+    if (same) {
+      return indices[0];
+    }
+    if (!consecutive || !IsAligned(indices[0], lanes)) {
+      return NullOpt;
+    }
+    return Ramp(indices[0], make_const(indices[0].dtype(), 1), lanes);
+  }
+
+  Optional<Stmt> Pack(const std::vector<BufferStore> &stores) {
+    int lanes = static_cast<int>(stores.size());
+    const BufferStore &first = stores[0];
+    std::vector<PrimExpr> indices, values;
+    for (const BufferStore &store : stores) {
+      if (!store->buffer->data.same_as(first->buffer->data) ||
+          store->buffer->dtype != first->buffer->dtype ||
+          store->indices.size() != 1 || store->predicate.defined() ||
+          store->value.dtype() != first->value.dtype()) {
+        return NullOpt;
+      }
+      indices.push_back(store->indices[0]);
+      values.push_back(store->value);
+    }
+    bool broadcast = false;
+    Optional<PrimExpr> index = PackIndex(indices, &broadcast);
+    if (!index.defined() || broadcast || !Independent(stores)) {
+      return NullOpt;
+    }
+    Optional<PrimExpr> value = PackExpr(values);
+    if (!value.defined()) {
+      return NullOpt;
+    }
+    ICHECK_EQ(value.value().dtype().lanes(), lanes);
+    return BufferStore(first->buffer, value.value(), {index.value()});
+  }
+
+  /*!
+   * \brief Whether no lane reads an element that an earlier lane of the run
+   * writes, so that all loads may happen before all stores. Distinct buffers
+   * are assumed not to alias, as the generated kernels declare them restrict.
+   */
+  bool Independent(const std::vector<BufferStore> &stores) {
+    const VarNode *data = stores[0]->buffer->data.get();
+    for (size_t t = 0; t < stores.size(); ++t) {
+      bool independent = true;
+      PostOrderVisit(stores[t]->value, [&](const ObjectRef &obj) {
+        const auto *load = obj.as<BufferLoadNode>();
+        if (!independent || !load || load->buffer->data.get() != data) {
+          return;
+        }
+        if (load->indices.size() != 1) {
+          independent = false;
+          return;
+        }
+        for (size_t s = 0; s < t; ++s) {
+          Optional<IntImm> diff =
+              ConstDiff(stores[s]->indices[0], load->indices[0]);
+          if (!diff.defined() || diff.value()->value == 0) {
+            independent = false;
+            return;
+          }
+        }
+      });
+      if (!independent) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*! \brief The vector expression whose lane t computes exprs[t]. */
+  Optional<PrimExpr> PackExpr(const std::vector<PrimExpr> &exprs) {
+    int lanes = static_cast<int>(exprs.size());
+    const PrimExpr &first = exprs[0];
+    if (first.dtype().lanes() != 1 ||
+        first.dtype().bits() * lanes > kMaxVectorBits) {
+      return NullOpt;
+    }
+    bool uniform = true;
+    for (int t = 1; t < lanes && uniform; ++t) {
+      uniform = StructuralEqual()(first, exprs[t]);
+    }
+    if (uniform && IsBroadcastable(first)) {
+      return Broadcast(first, lanes);
+    }
+    for (const PrimExpr &expr : exprs) {
+      if (expr->type_index() != first->type_index() ||
+          expr.dtype() != first.dtype()) {
+        return NullOpt;
+      }
+    }
+    if (!IsPackable(first.dtype())) {
+      return NullOpt;
+    }
+    DataType vtype = first.dtype().with_lanes(lanes);
+
+    if (first->IsInstance<BufferLoadNode>()) {
+      std::vector<PrimExpr> indices;
+      const auto *load0 = first.as<BufferLoadNode>();
+      for (const PrimExpr &expr : exprs) {
+        const auto *load = expr.as<BufferLoadNode>();
+        if (!load->buffer->data.same_as(load0->buffer->data) ||
+            load->indices.size() != 1 || load->predicate.defined()) {
+          return NullOpt;
+        }
+        indices.push_back(load->indices[0]);
+      }
+      bool broadcast = false;
+      Optional<PrimExpr> index = PackIndex(indices, &broadcast);
+      if (!index.defined()) {
+        return NullOpt;
+      }
+      if (broadcast) {
+        return Broadcast(first, lanes);
+      }
+      return BufferLoad(load0->buffer, {index.value()});
+    }
+
+    if (const auto *cast = first.as<CastNode>()) {
+      if (!target_.allow_cast || !IsPackable(cast->value.dtype())) {
+        return NullOpt;
+      }
+      std::vector<PrimExpr> values;
+      for (const PrimExpr &expr : exprs) {
+        values.push_back(expr.as<CastNode>()->value);
+      }
+      Optional<PrimExpr> value = PackExpr(values);
+      if (!value.defined()) {
+        return NullOpt;
+      }
+      return Cast(vtype, value.value());
+    }
+
+    if (first->IsInstance<AddNode>()) {
+      return PackBinary<AddNode, Add>(exprs);
+    }
+    if (first->IsInstance<SubNode>()) {
+      return PackBinary<SubNode, Sub>(exprs);
+    }
+    if (first->IsInstance<MulNode>()) {
+      return PackBinary<MulNode, Mul>(exprs);
+    }
+    if (first->IsInstance<DivNode>()) {
+      return PackBinary<DivNode, Div>(exprs);
+    }
+    if (first->IsInstance<MinNode>() && target_.allow_min_max) {
+      return PackBinary<MinNode, Min>(exprs);
+    }
+    if (first->IsInstance<MaxNode>() && target_.allow_min_max) {
+      return PackBinary<MaxNode, Max>(exprs);
+    }
+
+    // Calls, selects and integer division with flooring stay scalar: the C
+    // and CUDA code generators print them one scalar at a time.
+    return NullOpt;
+  }
+
+  template <typename Node, typename Ref>
+  Optional<PrimExpr> PackBinary(const std::vector<PrimExpr> &exprs) {
+    std::vector<PrimExpr> lhs, rhs;
+    for (const PrimExpr &expr : exprs) {
+      lhs.push_back(expr.as<Node>()->a);
+      rhs.push_back(expr.as<Node>()->b);
+    }
+    Optional<PrimExpr> a = PackExpr(lhs);
+    if (!a.defined()) {
+      return NullOpt;
+    }
+    Optional<PrimExpr> b = PackExpr(rhs);
+    if (!b.defined()) {
+      return NullOpt;
+    }
+    return Ref(a.value(), b.value());
+  }
+
+  /*! \brief Whether a scalar is the same in every lane and cheap to splat. */
+  bool IsBroadcastable(const PrimExpr &expr) const {
+    bool ok = true;
+    PostOrderVisit(expr, [&](const ObjectRef &obj) {
+      if (obj->IsInstance<CallNode>() || obj->IsInstance<LetNode>()) {
+        ok = false;
+      }
+    });
+    return ok && IsPackable(expr.dtype());
+  }
+
+  VectorTarget target_;
+  arith::Analyzer analyzer_;
+};
+
+} // namespace
+
+tvm::transform::Pass SLPVectorize() {
+  using namespace tir::transform;
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    if (ctx->GetConfig<Bool>(kDisableSLPVectorize, Bool(false)).value() ||
+        ctx->GetConfig<Bool>("tir.disable_vectorize", Bool(false)).value()) {
+      return f;
+    }
+    // LLVM runs its own SLP vectorizer.
+    Optional<Target> target = f->GetAttr<Target>(tvm::attr::kTarget);
+    if (!target.defined()) {
+      return f;
+    }
+    std::string kind = target.value()->kind->name;
+    VectorTarget vector_target;
+    if (kind == "cuda" || kind == "hip") {
+      vector_target = {true, true, true};
+    } else if (kind == "c") {
+      vector_target = {false, false, false};
+    } else {
+      return f;
+    }
+    auto *n = f.CopyOnWrite();
+    n->body = SLPVectorizer(vector_target)(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tl.SLPVectorize", {});
+}
+
+TVM_REGISTER_GLOBAL("tl.transform.SLPVectorize").set_body_typed(SLPVectorize);
+
+} // namespace tl
+} // namespace tvm
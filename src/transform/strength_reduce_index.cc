@@ -0,0 +1,260 @@
+/*!
+ * \file strength_reduce_index.cc
+ * \brief Hoist the loop invariant part of flattened buffer indices.
+ *
+ * After FlattenBuffer every access in a loop nest recomputes its whole
+ * row-major offset, e.g.
+ *
+ *   for i in range(16):
+ *     for j in range(16):
+ *       B[by * 256 + i * 16 + j] = A[by * 256 + i * 16 + j + 1]
+ *
+ * For every serial loop, innermost first, this pass splits each affine index
+ * into the loop variable times a constant stride and an invariant remainder,
+ * binds the remainder to a variable before the loop and shares it between the
+ * accesses whose remainders differ by a constant only:
+ *
+ *   A_base: int32 = by * 256
+ *   for i in range(16):
+ *     A_base_1: int32 = A_base + i * 16
+ *     for j in range(16):
+ *       B[A_base_1 + j] = A[A_base_1 + j + 1]
+ *
+ * The bases of inner loops are bound inside the outer loops and are themselves
+ * reduced there, so every loop only adds its own stride to one base.
+ */
+
+#include <tvm/arith/analyzer.h>
+#include <tvm/arith/pattern.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <unordered_set>
+
+#include "../op/builtin.h"
+
+namespace tvm {
+namespace tl {
+
+using namespace tir;
+
+namespace {
+
+using VarSet = std::unordered_set<const VarNode *>;
+
+/*! \brief Variables bound anywhere in a statement. */
+VarSet DefinedVars(const Stmt &stmt) {
+  VarSet defined;
+  PostOrderVisit(stmt, [&](const ObjectRef &obj) {
+    if (const auto *loop = obj.as<ForNode>()) {
+      defined.insert(loop->loop_var.get());
+    } else if (const auto *let = obj.as<LetStmtNode>()) {
+      defined.insert(let->var.get());
+    } else if (const auto *let = obj.as<LetNode>()) {
+      defined.insert(let->var.get());
+    } else if (const auto *alloc = obj.as<AllocateNode>()) {
+      defined.insert(alloc->buffer_var.get());
+    }
+  });
+  return defined;
+}
+
+/*!
+ * \brief Whether an invariant remainder is worth a variable and safe to
+ * evaluate before the loop, which may run zero times.
+ */
+bool IsHoistable(const PrimExpr &expr) {
+  if (expr->IsInstance<IntImmNode>() || expr->IsInstance<VarNode>()) {
+    return false;
+  }
+  bool hoistable = true;
+  PostOrderVisit(expr, [&](const ObjectRef &obj) {
+    if (obj->IsInstance<BufferLoadNode>() || obj->IsInstance<CallNode>()) {
+      hoistable = false;
+    }
+    PrimExpr divisor;
+    if (const auto *div = obj.as<DivNode>()) {
+      divisor = div->b;
+    } else if (const auto *mod = obj.as<ModNode>()) {
+      divisor = mod->b;
+    } else if (const auto *div = obj.as<FloorDivNode>()) {
+      divisor = div->b;
+    } else if (const auto *mod = obj.as<FloorModNode>()) {
+      divisor = mod->b;
+    }
+    if (divisor.defined() && (!is_const_int(divisor) || is_zero(divisor))) {
+      hoistable = false;
+    }
+  });
+  return hoistable;
+}
+
+/*! \brief Rewrite the indices in the body of one loop onto hoisted bases. */
+class LoopIndexReducer : public StmtExprMutator {
+public:
+  LoopIndexReducer(Var loop_var, VarSet defined, VarSet *base_vars)
+      : loop_var_(std::move(loop_var)), defined_(std::move(defined)),
+        base_vars_(base_vars) {}
+
+  // Bases to bind before the loop, in order of creation.
+  std::vector<std::pair<Var, PrimExpr>> bases;
+
+private:
+  PrimExpr VisitExpr_(const BufferLoadNode *op) final {
+    auto load = Downcast<BufferLoad>(StmtExprMutator::VisitExpr_(op));
+    Array<PrimExpr> indices = ReduceIndices(load->indices, load->buffer->name);
+    if (indices.same_as(load->indices)) {
+      return load;
+    }
+    load.CopyOnWrite()->indices = indices;
+    return load;
+  }
+
+  Stmt VisitStmt_(const BufferStoreNode *op) final {
+    auto store = Downcast<BufferStore>(StmtExprMutator::VisitStmt_(op));
+    Array<PrimExpr> indices =
+        ReduceIndices(store->indices, store->buffer->name);
+    if (indices.same_as(store->indices)) {
+      return store;
+    }
+    store.CopyOnWrite()->indices = indices;
+    return store;
+  }
+
+  // Bases of inner loops are reduced along this loop as well.
+  Stmt VisitStmt_(const LetStmtNode *op) final {
+    auto let = Downcast<LetStmt>(StmtExprMutator::VisitStmt_(op));
+    if (!base_vars_->count(op->var.get())) {
+      return let;
+    }
+    PrimExpr value = Reduce(let->value, op->var->name_hint);
+    if (value.same_as(let->value)) {
+      return let;
+    }
+    let.CopyOnWrite()->value = value;
+    return let;
+  }
+
+  Array<PrimExpr> ReduceIndices(const Array<PrimExpr> &indices,
+                                const std::string &name) {
+    return indices.Map(
+        [&](const PrimExpr &index) { return Reduce(index, name + "_base"); });
+  }
+
+  PrimExpr Reduce(const PrimExpr &index, const std::string &name) {
+    if (const auto *ramp = index.as<RampNode>()) {
+      PrimExpr base = Reduce(ramp->base, name);
+      return base.same_as(ramp->base)
+                 ? index
+                 : Ramp(base, ramp->stride, ramp->lanes);
+    }
+    if (index.dtype().lanes() != 1 || !index.dtype().is_int()) {
+      return index;
+    }
+    Array<PrimExpr> coeffs = arith::DetectLinearEquation(index, {loop_var_});
+    if (coeffs.empty()) {
+      return index;
+    }
+    PrimExpr stride = coeffs[0], rest = coeffs[1];
+    auto variant = [&](const PrimExpr &expr) {
+      return UsesVar(expr, [&](const VarNode *v) {
+        return v == loop_var_.get() || defined_.count(v) > 0;
+      });
+    };
+    if (variant(stride)) {
+      return index;
+    }
+    // Remainders differing by a constant share a base.
+    PrimExpr key = rest;
+    int64_t offset = 0;
+    if (const auto *add = rest.as<AddNode>()) {
+      if (const auto *imm = add->b.as<IntImmNode>()) {
+        key = add->a;
+        offset = imm->value;
+      }
+    }
+    if (variant(key) || !IsHoistable(key)) {
+      return index;
+    }
+    Var base;
+    for (const auto &[var, value] : bases) {
+      if (StructuralEqual()(value, key)) {
+        base = var;
+        break;
+      }
+    }
+    if (!base.defined()) {
+      base = Var(name, key.dtype());
+      bases.emplace_back(base, key);
+      base_vars_->insert(base.get());
+    }
+    PrimExpr result = base;
+    if (!is_zero(stride)) {
+      result = result + stride * cast(index.dtype(), loop_var_);
+    }
+    if (offset != 0) {
+      result = result + make_const(index.dtype(), offset);
+    }
+    return result;
+  }
+
+  Var loop_var_;
+  VarSet defined_;
+  VarSet *base_vars_;
+};
+
+class IndexStrengthReducer : public StmtExprMutator {
+private:
+  Stmt VisitStmt_(const ForNode *op) final {
+    auto loop = Downcast<For>(StmtExprMutator::VisitStmt_(op));
+    if (loop->kind != ForKind::kSerial && loop->kind != ForKind::kUnrolled) {
+      return loop;
+    }
+    LoopIndexReducer reducer(loop->loop_var, DefinedVars(loop->body),
+                             &base_vars_);
+    Stmt body = reducer(loop->body);
+    if (reducer.bases.empty()) {
+      return loop;
+    }
+    loop.CopyOnWrite()->body = body;
+    Stmt result = loop;
+    for (auto it = reducer.bases.rbegin(); it != reducer.bases.rend(); ++it) {
+      result = LetStmt(it->first, it->second, result);
+    }
+    return result;
+  }
+
+  VarSet base_vars_;
+};
+
+} // namespace
+
+tvm::transform::Pass StrengthReduceIndex() {
+  using namespace tir::transform;
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    if (ctx->GetConfig<Bool>(kDisableStrengthReduction, Bool(false))
+            .value()) {
+      return f;
+    }
+    // LLVM runs its own loop strength reduction.
+    Optional<Target> target = f->GetAttr<Target>(tvm::attr::kTarget);
+    if (!target.defined()) {
+      return f;
+    }
+    std::string kind = target.value()->kind->name;
+    if (kind != "cuda" && kind != "hip" && kind != "c") {
+      return f;
+    }
+    auto *n = f.CopyOnWrite();
+    n->body = IndexStrengthReducer()(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tl.StrengthReduceIndex", {});
+}
+
+TVM_REGISTER_GLOBAL("tl.transform.StrengthReduceIndex")
+    .set_body_typed(StrengthReduceIndex);
+
+} // namespace tl
+} // namespace tvm
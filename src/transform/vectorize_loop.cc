@@ -22,7 +22,9 @@
  */
 // Loop vectorizer as in Halide pipeline.
 #include <tvm/arith/analyzer.h>
+#include <tvm/arith/pattern.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/target/target.h>
 #include <tvm/tir/analysis.h>
 #include <tvm/tir/builtin.h>
 #include <tvm/tir/expr.h>
@@ -32,8 +34,10 @@
 #include <tvm/tir/transform.h>
 
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "../op/builtin.h"
 #include "arith/scalable_expression.h"
 #include "tir/analysis/check_contains.h"
 
@@ -206,16 +210,31 @@ public:
   using ExprFunctor::VisitExpr;
   using StmtMutator::operator();
 
-  TLVectorizer(Var var, PrimExpr var_lanes) : var_(var), var_lanes_(var_lanes) {
+  TLVectorizer(Var var, PrimExpr var_lanes, bool version_guards = false,
+               bool native_predication = false)
+      : var_(var), var_lanes_(var_lanes),
+        version_guards_(version_guards && var_lanes.as<IntImmNode>()),
+        native_predication_(native_predication) {
     ramp_ = Ramp(IntImm(var->dtype, 0), IntImm(var->dtype, 1), var_lanes);
   }
 
   Stmt VisitStmt(const Stmt &stmt) final {
     ICHECK(!need_scalarize_);
+    // VersionGuarded visits the statement again, with the lets it binds unset.
+    std::unordered_map<Var, PrimExpr, ObjectPtrHash, ObjectPtrEqual>
+        let_binding;
+    if (version_guards_ && guard_mode_ == GuardMode::kVersion) {
+      let_binding = let_binding_;
+    }
     Stmt ret = StmtMutator::VisitStmt(stmt);
     if (need_scalarize_) {
       need_scalarize_ = false;
+      need_version_ = false;
       return Scalarize(stmt);
+    } else if (need_version_) {
+      need_version_ = false;
+      let_binding_ = std::move(let_binding);
+      return VersionGuarded(stmt);
     } else {
       return ret;
     }
@@ -407,7 +426,16 @@ public:
   PrimExpr MutateIfThenElseExpr_(const CallNode *op) {
     PrimExpr cond = this->VisitExpr(op->args[0]);
     if (cond.dtype().is_scalable_or_fixed_length_vector()) {
-      need_scalarize_ = true;
+      if (guard_mode_ == GuardMode::kAssumeTrue &&
+          assumed_guards_.count(op->args[0].get())) {
+        return this->VisitExpr(op->args[1]);
+      } else if (guard_mode_ == GuardMode::kMasked) {
+        return MaskedSelect(op, cond);
+      } else if (guard_mode_ == GuardMode::kVersion && version_guards_) {
+        need_version_ = true;
+      } else {
+        need_scalarize_ = true;
+      }
       return GetRef<PrimExpr>(op);
     }
     PrimExpr t = this->VisitExpr(op->args[1]);
@@ -515,6 +543,9 @@ public:
       writer->indices = indices;
       // writer->LegalizeDType();
       LegalizeBufferLoadDType(writer);
+      if (predicate_.defined()) {
+        writer->predicate = AccessPredicate(indices.back());
+      }
     }
 
     return std::move(load);
@@ -522,6 +553,7 @@ public:
   // Let
   PrimExpr VisitExpr_(const LetNode *op) final {
     PrimExpr value = this->VisitExpr(op->value);
+    let_value_[op->var] = op->value;
     // Weaker SSA condition
     // A single var can be binded in multiple lets
     // but they have to bind to the same value.
@@ -600,6 +632,9 @@ public:
       auto writer = store.CopyOnWrite();
       writer->indices = indices;
       writer->value = BroadcastTo(value, total_lanes, is_last_index_scalable);
+      if (predicate_.defined()) {
+        writer->predicate = AccessPredicate(indices.back());
+      }
     }
 
     return std::move(store);
@@ -628,6 +663,18 @@ public:
     ICHECK(!op->condition.dtype().is_scalable_or_fixed_length_vector());
     PrimExpr condition = this->VisitExpr(op->condition);
     if (condition.dtype().is_scalable_or_fixed_length_vector()) {
+      if (op->else_case) {
+        return Scalarize(GetRef<Stmt>(op));
+      } else if (guard_mode_ == GuardMode::kAssumeTrue &&
+                 assumed_guards_.count(op->condition.get())) {
+        return this->VisitStmt(op->then_case);
+      } else if (guard_mode_ == GuardMode::kMasked) {
+        return WithPredicate(condition,
+                             [&]() { return this->VisitStmt(op->then_case); });
+      } else if (guard_mode_ == GuardMode::kVersion && version_guards_) {
+        need_version_ = true;
+        return GetRef<Stmt>(op);
+      }
       return Scalarize(GetRef<Stmt>(op));
     }
     Stmt then_case = this->VisitStmt(op->then_case);
@@ -652,6 +699,7 @@ public:
     ICHECK(!let_binding_.count(op->var))
         << "SSA violation, a single var is binded twice";
     let_binding_[op->var] = value;
+    let_value_[op->var] = op->value;
 
     if (value.dtype().get_lanes_or_vscale_factor() !=
         op->value.dtype().get_lanes_or_vscale_factor()) {
@@ -684,6 +732,7 @@ public:
 
   // scalarize the statment
   Stmt Scalarize(Stmt stmt) {
+    ++num_scalarized_;
     Var idx(var_->name_hint + ".s", var_->dtype);
     stmt = Substitute(stmt, {{var_, idx}});
     return For(idx, IntImm(var_->dtype, 0), var_lanes_, ForKind::kSerial, stmt);
@@ -694,6 +743,175 @@ public:
   }
 
 private:
+  // How guards whose condition depends on the lane are vectorized. kVersion
+  // requests VersionGuarded, which revisits the statement under kAssumeTrue
+  // for the full vector path and under kMasked for the predicated tail.
+  enum class GuardMode { kVersion, kAssumeTrue, kMasked };
+
+  /*!
+   * \brief Vectorize a statement whose guards became vector conditions.
+   *
+   * Instead of running it lane by lane, the statement runs as full vectors
+   * with the guards folded away when they hold for every lane. The other
+   * iterations, the edge tiles of a bounds checked loop, run with predicated
+   * loads and stores on the LLVM target, which lowers them to masked vector
+   * instructions. Other targets, the C backend and CUDA among them, run the
+   * edge tiles lane by lane.
+   */
+  Stmt VersionGuarded(const Stmt &stmt) {
+    std::vector<PrimExpr> guards;
+    PostOrderVisit(stmt, [&](const ObjectRef &node) {
+      if (const auto *op = node.as<IfThenElseNode>()) {
+        if (!op->else_case && DependsOnLane(op->condition)) {
+          guards.push_back(op->condition);
+        }
+      } else if (const auto *op = node.as<CallNode>()) {
+        if (op->op.same_as(builtin::if_then_else()) &&
+            DependsOnLane(op->args[0])) {
+          guards.push_back(op->args[0]);
+        }
+      }
+    });
+    PrimExpr all_lanes = const_true();
+    for (const PrimExpr &guard : guards) {
+      all_lanes = all_lanes && AllLanes(InlineLets(guard));
+    }
+    all_lanes = analyzer_.Simplify(all_lanes);
+
+    auto let_binding = let_binding_;
+    auto assumed_guards = assumed_guards_;
+    for (const PrimExpr &guard : guards) {
+      assumed_guards_.insert(guard.get());
+    }
+    int num_scalarized = num_scalarized_;
+    guard_mode_ = GuardMode::kAssumeTrue;
+    Stmt full = this->VisitStmt(stmt);
+    guard_mode_ = GuardMode::kVersion;
+    assumed_guards_ = std::move(assumed_guards);
+    let_binding_ = let_binding;
+    if (num_scalarized_ != num_scalarized || is_zero(all_lanes)) {
+      return Scalarize(stmt);
+    }
+    if (is_one(all_lanes)) {
+      return full;
+    }
+
+    Stmt tail;
+    if (native_predication_) {
+      num_scalarized = num_scalarized_;
+      guard_mode_ = GuardMode::kMasked;
+      tail = this->VisitStmt(stmt);
+      guard_mode_ = GuardMode::kVersion;
+      let_binding_ = std::move(let_binding);
+      // A part scalarized in the tail, e.g. a strided access under a guard,
+      // would lose the guards around it: run the whole tail lane by lane.
+      if (num_scalarized_ != num_scalarized) {
+        tail = Scalarize(stmt);
+      }
+    } else {
+      tail = Scalarize(stmt);
+    }
+    return IfThenElse(all_lanes, full, tail);
+  }
+
+  bool DependsOnLane(const PrimExpr &expr) const {
+    return UsesVar(expr, [this](const VarNode *v) {
+      if (v == var_.get()) {
+        return true;
+      }
+      auto it = let_binding_.find(GetRef<Var>(v));
+      return it != let_binding_.end() &&
+             it->second.dtype().is_scalable_or_fixed_length_vector();
+    });
+  }
+
+  // The guard with the lets of the loop body inlined. A let var is rebound
+  // to a vector, or bound inside the versioned statement, so it cannot appear
+  // in the scalar condition that selects between the two paths.
+  PrimExpr InlineLets(PrimExpr expr) const {
+    while (true) {
+      Map<Var, PrimExpr> vmap;
+      PostOrderVisit(expr, [&](const ObjectRef &node) {
+        if (const auto *v = node.as<VarNode>()) {
+          auto it = let_value_.find(GetRef<Var>(v));
+          if (it != let_value_.end()) {
+            vmap.Set(it->first, it->second);
+          }
+        }
+      });
+      if (vmap.empty()) {
+        return expr;
+      }
+      expr = Substitute(expr, vmap);
+    }
+  }
+
+  // A scalar condition that holds iff the guard holds for every lane.
+  PrimExpr AllLanes(const PrimExpr &guard) {
+    if (const auto *op = guard.as<AndNode>()) {
+      return AllLanes(op->a) && AllLanes(op->b);
+    }
+    int lanes = static_cast<int>(Downcast<IntImm>(var_lanes_)->value);
+    auto at = [&](int lane) {
+      return Substitute(guard, {{var_, IntImm(var_->dtype, lane)}});
+    };
+    // A comparison of expressions linear in the lane holds for every lane iff
+    // it holds for the first and the last one.
+    PrimExpr diff;
+    if (const auto *op = guard.as<LTNode>()) {
+      diff = op->a - op->b;
+    } else if (const auto *op = guard.as<LENode>()) {
+      diff = op->a - op->b;
+    } else if (const auto *op = guard.as<GTNode>()) {
+      diff = op->a - op->b;
+    } else if (const auto *op = guard.as<GENode>()) {
+      diff = op->a - op->b;
+    }
+    if (diff.defined() && !arith::DetectLinearEquation(diff, {var_}).empty()) {
+      return at(0) && at(lanes - 1);
+    }
+    PrimExpr result = at(0);
+    for (int lane = 1; lane < lanes; ++lane) {
+      result = result && at(lane);
+    }
+    return result;
+  }
+
+  template <typename FVisit>
+  auto WithPredicate(const PrimExpr &cond, FVisit fvisit) {
+    PrimExpr saved = predicate_;
+    predicate_ = saved.defined() ? And(saved, cond) : cond;
+    auto result = fvisit();
+    predicate_ = saved;
+    return result;
+  }
+
+  // if_then_else(c, t, f) with the loads of t predicated on c and those of f
+  // on !c, so that no lane reads what the scalar code would not.
+  PrimExpr MaskedSelect(const CallNode *op, const PrimExpr &cond) {
+    PrimExpr t =
+        WithPredicate(cond, [&]() { return this->VisitExpr(op->args[1]); });
+    PrimExpr f = WithPredicate(
+        Not(cond), [&]() { return this->VisitExpr(op->args[2]); });
+    int lanes = std::max({cond.dtype().lanes(), t.dtype().lanes(),
+                          f.dtype().lanes()});
+    return Select(BroadcastTo(cond, lanes, false), BroadcastTo(t, lanes, false),
+                  BroadcastTo(f, lanes, false));
+  }
+
+  // The predicate of a masked access at `index`. Only contiguous accesses as
+  // wide as the predicate lower to masked memory operations, others fall
+  // back to the lane by lane tail.
+  Optional<PrimExpr> AccessPredicate(const PrimExpr &index) {
+    const auto *ramp = index.as<RampNode>();
+    if (ramp && is_one(ramp->stride) &&
+        ramp->dtype.lanes() == predicate_.dtype().lanes()) {
+      return predicate_;
+    }
+    need_scalarize_ = true;
+    return NullOpt;
+  }
+
   // analyzer
   arith::Analyzer analyzer_;
   // deep equal
@@ -706,8 +924,22 @@ private:
   PrimExpr ramp_;
   // flag to mark requirment of scalarization.
   bool need_scalarize_{false};
+  // flag to mark a statement for VersionGuarded.
+  bool need_version_{false};
+  // whether lane dependent guards are versioned rather than scalarized.
+  bool version_guards_;
+  // whether the target lowers predicated loads and stores natively.
+  bool native_predication_;
+  GuardMode guard_mode_{GuardMode::kVersion};
+  // guards folded to true on the full vector path.
+  std::unordered_set<const Object *> assumed_guards_;
+  // conjunction of the vector guards around the current access in kMasked.
+  PrimExpr predicate_;
+  int num_scalarized_{0};
   // Let binding
   std::unordered_map<Var, PrimExpr, ObjectPtrHash, ObjectPtrEqual> let_binding_;
+  // Scalar values of the lets in the loop body, inlined into guards.
+  std::unordered_map<Var, PrimExpr, ObjectPtrHash, ObjectPtrEqual> let_value_;
   // vectorizable property
   OpAttrMap<TVectorizable> op_vectorizable_ =
       Op::GetAttrMap<TVectorizable>("TVectorizable");
@@ -789,6 +1021,10 @@ private:
 
 class LoopVectorizer : public StmtMutator {
 public:
+  LoopVectorizer(bool version_guards = false, bool native_predication = false)
+      : version_guards_(version_guards),
+        native_predication_(native_predication) {}
+
   Stmt VisitStmt_(const ForNode *op) final {
     if (op->kind == ForKind::kVectorized) {
       auto *extent_as_int = op->extent.as<IntImmNode>();
@@ -801,11 +1037,16 @@ public:
             << " for target " << Target::Current();
       }
       ICHECK(is_zero(op->min));
-      return TLVectorizer(op->loop_var, op->extent)(op->body);
+      return TLVectorizer(op->loop_var, op->extent, version_guards_,
+                          native_predication_)(op->body);
     } else {
       return StmtMutator::VisitStmt_(op);
     }
   }
+
+private:
+  bool version_guards_;
+  bool native_predication_;
 };
 
 class VectorizeSkipper : public StmtMutator {
@@ -826,9 +1067,20 @@ Stmt SkipVectorize(Stmt stmt) { return VectorizeSkipper()(std::move(stmt)); }
 tvm::transform::Pass VectorizeLoop(bool enable_vectorize = true) {
   using namespace tir::transform;
   auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    bool version_guards =
+        !ctx->GetConfig<Bool>(kDisableMaskedVectorize, Bool(false)).value();
+    Optional<Target> target = f->GetAttr<Target>(tvm::attr::kTarget);
+    if (!target.defined()) {
+      target = Target::Current(true);
+    }
+    // LLVM lowers predicated vector memory access to masked instructions,
+    // the C backend has no predicated loads and stores.
+    bool native_predication =
+        target.defined() && target.value()->kind->name == "llvm";
     auto *n = f.CopyOnWrite();
     if (enable_vectorize) {
-      n->body = tvm::tl::LoopVectorizer()(std::move(n->body));
+      n->body = tvm::tl::LoopVectorizer(version_guards, native_predication)(
+          std::move(n->body));
     } else {
       n->body = tvm::tl::VectorizeSkipper()(std::move(n->body));
     }
@@ -0,0 +1,138 @@
+import itertools
+import tilelang
+import tilelang.testing
+from tilelang import tvm as tvm
+from tilelang.jit.symbolic import SymbolicProgramCache
+import tilelang.language as T
+
+
+def matmul(M, N, K, block_M, block_N, block_K, num_stages=2, threads=128, dtype="float16"):
+    accum_dtype = "float"
+
+    @T.prim_func
+    def main(
+            A: T.Tensor((M, K), dtype),
+            B: T.Tensor((N, K), dtype),
+            C: T.Tensor((M, N), dtype),
+    ):
+        with T.Kernel(T.ceildiv(N, block_N), T.ceildiv(M, block_M), threads=threads) as (bx, by):
+            A_shared = T.alloc_shared((block_M, block_K), dtype)
+            B_shared = T.alloc_shared((block_N, block_K), dtype)
+            C_local = T.alloc_fragment((block_M, block_N), accum_dtype)
+            T.clear(C_local)
+            for k in T.Pipelined(T.ceildiv(K, block_K), num_stages=num_stages):
+                T.copy(A[by * block_M, k * block_K], A_shared)
+                T.copy(B[bx * block_N, k * block_K], B_shared)
+                T.gemm(A_shared, B_shared, C_local, transpose_B=True)
+            T.copy(C_local, C[by * block_M, bx * block_N])
+
+    return main
+
+
+def python_level_tile(M, N, block_M):
+    # The tile size steers Python control flow, so it cannot be a placeholder
+    if block_M > 64:
+        block_M = 64
+
+    @T.prim_func
+    def main(A: T.Tensor((M, N), "float32"), B: T.Tensor((M, N), "float32")):
+        with T.Kernel(T.ceildiv(M, block_M), threads=128) as bx:
+            for i, j in T.Parallel(block_M, N):
+                B[bx * block_M + i, j] = A[bx * block_M + i, j]
+
+    return main
+
+
+def get_configs():
+    return [{
+        "block_M": block_M,
+        "block_N": block_N,
+        "block_K": block_K,
+    } for block_M, block_N, block_K in itertools.product([64, 128], [64, 128], [32])]
+
+
+def shared_shapes(func):
+    shapes = {}
+
+    def visit(node):
+        if isinstance(node, tvm.tir.Block):
+            for buffer in node.alloc_buffers:
+                shapes[buffer.name] = [int(s) for s in buffer.shape]
+
+    tvm.tir.stmt_functor.post_order_visit(func.body, visit)
+    return shapes
+
+
+def test_parse_once_across_configs():
+    cache = SymbolicProgramCache(matmul, ["block_M", "block_N", "block_K"])
+    for config in get_configs():
+        func = cache(256, 256, 256, **config)
+        shapes = shared_shapes(func)
+        assert shapes["A_shared"] == [config["block_M"], config["block_K"]]
+        assert shapes["B_shared"] == [config["block_N"], config["block_K"]]
+        assert shapes["C_local"] == [config["block_M"], config["block_N"]]
+        assert "block_M" not in func.script()
+    assert cache.num_parses == 1
+
+
+def test_non_symbolic_params_key_the_parse():
+    cache = SymbolicProgramCache(matmul, ["block_M", "block_N", "block_K"])
+    for num_stages in [1, 2, 3]:
+        for config in get_configs():
+            func = cache(256, 256, 256, **config, num_stages=num_stages)
+            assert f"num_stages\": {num_stages}" in func.script()
+    assert cache.num_parses == 3
+
+
+def test_bound_program_matches_direct_parse():
+    cache = SymbolicProgramCache(matmul, ["block_M", "block_N", "block_K"])
+    bound = cache(256, 256, 256, block_M=128, block_N=64, block_K=32)
+    assert cache.num_parses == 1
+    # The launch extents ceildiv(N, block_N) and ceildiv(M, block_M) are
+    # folded in the thread IterVars as well
+    extents = {}
+    tvm.tir.stmt_functor.post_order_visit(
+        bound.body, lambda n: extents.update({n.node.thread_tag: n.node.dom.extent})
+        if isinstance(n, tvm.tir.AttrStmt) and n.attr_key == "thread_extent" else None)
+    assert extents["blockIdx.x"] == 4 and extents["blockIdx.y"] == 2, extents
+    bound = tilelang.transform.Simplify()(tvm.IRModule({"main": bound}))
+    direct = tilelang.transform.Simplify()(tvm.IRModule({"main": matmul(256, 256, 256, 128, 64, 32)}))
+    tvm.ir.assert_structural_equal(bound["main"], direct["main"], map_free_vars=True)
+
+
+def test_python_level_params_fall_back():
+    cache = SymbolicProgramCache(python_level_tile, ["block_M"])
+    for block_M in [32, 64, 128]:
+        func = cache(256, 64, block_M=block_M)
+        assert shared_shapes(func) == {}
+    assert cache.num_parses == 4
+
+
+def test_unhashable_args_fall_back():
+
+    def tile_copy(shape, block_M):
+        return python_level_tile(shape[0], shape[1], block_M)
+
+    cache = SymbolicProgramCache(tile_copy, ["block_M"])
+    for block_M in [32, 64]:
+        cache([256, 64], block_M=block_M)
+    assert cache.num_parses == 2
+
+
+@tilelang.testing.requires_cuda
+def test_autotune_symbolic_params():
+
+    @tilelang.autotune(configs=get_configs(), symbolic_params=["block_M", "block_N", "block_K"])
+    @tilelang.jit(out_idx=[-1])
+    def tuned_matmul(M, N, K, block_M=64, block_N=64, block_K=32):
+        return matmul(M, N, K, block_M, block_N, block_K)
+
+    import torch
+    kernel = tuned_matmul(512, 512, 512)
+    a = torch.randn(512, 512, dtype=torch.float16).cuda()
+    b = torch.randn(512, 512, dtype=torch.float16).cuda()
+    torch.testing.assert_close(kernel(a, b), a @ b.T, rtol=1e-2, atol=1e-2)
+
+
+if __name__ == "__main__":
+    tilelang.testing.main()
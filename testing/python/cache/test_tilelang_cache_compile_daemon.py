@@ -0,0 +1,102 @@
+import os
+import tempfile
+import threading
+import time
+
+import tilelang
+import tilelang.testing
+import tilelang.language as T
+from tilelang.cache import compile_daemon
+import torch
+
+
+def vector_add(N, block_N, dtype="float32"):
+
+    @T.prim_func
+    def main(A: T.Tensor((N,), dtype), B: T.Tensor((N,), dtype), C: T.Tensor((N,), dtype)):
+        with T.Kernel(T.ceildiv(N, block_N), is_cpu=True) as bx:
+            for i in T.serial(block_N):
+                C[bx * block_N + i] = A[bx * block_N + i] + B[bx * block_N + i]
+
+    return main
+
+
+def test_in_flight_requests_are_deduplicated():
+    with tempfile.TemporaryDirectory() as tmp:
+        socket_path = os.path.join(tmp, "daemon.sock")
+        daemon = compile_daemon.CompileDaemon(socket_path, num_workers=2, cache_dir=tmp)
+        built = []
+
+        def slow_build(request):
+            time.sleep(0.5)
+            built.append(request["key"])
+
+        daemon._build = slow_build
+        server = threading.Thread(target=daemon.serve_forever, daemon=True)
+        server.start()
+        while not os.path.exists(socket_path):
+            time.sleep(0.01)
+
+        results = []
+
+        def request(key):
+            results.append(
+                compile_daemon.request_build(
+                    key, tmp, func=None, out_idx=None, target="c", target_host=None,
+                    execution_backend="ctypes", verbose=False, pass_configs=None))
+
+        compile_daemon.enable_compile_daemon(socket_path)
+        try:
+            clients = [threading.Thread(target=request, args=("same",)) for _ in range(8)]
+            clients.append(threading.Thread(target=request, args=("other",)))
+            for client in clients:
+                client.start()
+            for client in clients:
+                client.join()
+            stats = compile_daemon.compile_daemon_stats(socket_path)
+        finally:
+            compile_daemon.disable_compile_daemon()
+            compile_daemon.stop_compile_daemon(socket_path)
+            server.join(timeout=10)
+
+        assert all(results)
+        assert sorted(built) == ["other", "same"]
+        assert stats["builds"] == 2
+        assert stats["deduplicated"] == 7
+
+
+def test_unreachable_daemon_falls_back():
+    with tempfile.TemporaryDirectory() as tmp:
+        compile_daemon.enable_compile_daemon(os.path.join(tmp, "missing.sock"))
+        try:
+            assert not compile_daemon.request_build("key", tmp)
+        finally:
+            compile_daemon.disable_compile_daemon()
+
+
+def test_kernel_built_by_daemon():
+    with tempfile.TemporaryDirectory() as tmp:
+        previous_cache_dir = tilelang.cache.get_cache_dir()
+        socket_path = os.path.join(tmp, "daemon.sock")
+        process = compile_daemon.start_compile_daemon(socket_path, num_workers=2, cache_dir=tmp)
+        tilelang.cache.set_cache_dir(tmp)
+        compile_daemon.enable_compile_daemon(socket_path)
+        try:
+            kernel = tilelang.compile(vector_add(1024, 128), target="c", execution_backend="ctypes")
+            assert compile_daemon.compile_daemon_stats(socket_path)["builds"] == 1
+            assert any(not name.endswith(".sock") for name in os.listdir(tmp))
+
+            a = torch.randn(1024)
+            b = torch.randn(1024)
+            c = torch.empty(1024)
+            kernel(a, b, c)
+            torch.testing.assert_close(c, a + b)
+        finally:
+            compile_daemon.disable_compile_daemon()
+            tilelang.cache.set_cache_dir(str(previous_cache_dir))
+            compile_daemon.stop_compile_daemon(socket_path)
+            process.wait(timeout=30)
+
+
+if __name__ == "__main__":
+    tilelang.testing.main()
@@ -0,0 +1,84 @@
+import os
+import tempfile
+
+import tilelang
+import tilelang.testing
+import tilelang.language as T
+from tilelang.cache import kernel_cache
+import torch
+
+
+def vector_scale(N, block_N, dtype="float16"):
+
+    @T.prim_func
+    def main(A: T.Tensor((N,), dtype), B: T.Tensor((N,), dtype)):
+        with T.Kernel(T.ceildiv(N, block_N), threads=128) as bx:
+            for i in T.Parallel(block_N):
+                B[bx * block_N + i] = A[bx * block_N + i] * 2
+
+    return main
+
+
+def test_cross_compile_without_device_library():
+    with tempfile.TemporaryDirectory() as tmp:
+        previous_cache_dir = tilelang.cache.get_cache_dir()
+        tilelang.cache.set_cache_dir(tmp)
+        try:
+            # An explicit architecture, so neither a GPU nor a driver is probed
+            key = tilelang.cache.cross_compile(
+                vector_scale(1024, 256), [1], target="cuda -arch=sm_80")
+        finally:
+            tilelang.cache.set_cache_dir(previous_cache_dir)
+        files = os.listdir(os.path.join(tmp, key))
+        assert sorted(files) == [
+            kernel_cache.KERNEL_PATH, kernel_cache.PARAMS_PATH, kernel_cache.WRAPPED_KERNEL_PATH
+        ]
+        with open(os.path.join(tmp, key, kernel_cache.KERNEL_PATH)) as f:
+            assert "__global__" in f.read()
+
+
+def test_cross_compile_rejects_auto_target():
+    with tempfile.TemporaryDirectory() as tmp:
+        previous_cache_dir = tilelang.cache.get_cache_dir()
+        tilelang.cache.set_cache_dir(tmp)
+        try:
+            tilelang.cache.cross_compile(vector_scale(1024, 256), [1], target="auto")
+        except ValueError:
+            pass
+        else:
+            raise AssertionError("cross-compilation needs an explicit target")
+        finally:
+            tilelang.cache.set_cache_dir(previous_cache_dir)
+
+
+@tilelang.testing.requires_cuda
+def test_deferred_device_library_is_built_on_load():
+    target = "cuda -arch=sm_" + "".join(
+        str(v) for v in torch.cuda.get_device_capability())
+    func = vector_scale(1024, 256)
+    compile_lib = kernel_cache.LibraryGenerator.compile_lib
+    lock_held = []
+
+    def watched_compile_lib(self, *args, **kwargs):
+        lock_held.append(kernel_cache.KernelCache._lock.locked())
+        return compile_lib(self, *args, **kwargs)
+
+    with tempfile.TemporaryDirectory() as tmp:
+        previous_cache_dir = tilelang.cache.get_cache_dir()
+        tilelang.cache.set_cache_dir(tmp)
+        try:
+            key = tilelang.cache.cross_compile(func, [1], target=target)
+            kernel_cache.LibraryGenerator.compile_lib = watched_compile_lib
+            kernel = tilelang.cache.cached(func, [1], target=target)
+        finally:
+            kernel_cache.LibraryGenerator.compile_lib = compile_lib
+            tilelang.cache.set_cache_dir(previous_cache_dir)
+        # The library is built once, without holding the cache lock
+        assert lock_held == [False]
+        assert os.path.exists(os.path.join(tmp, key, kernel_cache.KERNEL_LIB_PATH))
+        a = torch.randn(1024, dtype=torch.float16, device="cuda")
+        torch.testing.assert_close(kernel(a), a * 2)
+
+
+if __name__ == "__main__":
+    tilelang.testing.main()
@@ -102,5 +102,47 @@ def test_general_matmul_matmul_emit_configs():
     run_general_matmul_matmul_emit_configs(128, 128, 128)
 
 
+def run_fused_gemm_softmax_gemm_emit_configs(M, N, K, D, topk: int = 10):
+    arch = auto_infer_current_arch()
+
+    def gemm(M, N, K, name):
+        A = te.placeholder((M, K), name='A', dtype='float16')
+        B = te.placeholder((N, K), name='B', dtype='float16')
+        k = te.reduce_axis((0, K), name='k')
+        C = te.compute((M, N), lambda i, j: te.sum(A[i, k] * B[j, k], axis=[k]), name=name)
+        return te.create_prim_func([A, B, C])
+
+    def exp(M, N):
+        A = te.placeholder((M, N), name='A', dtype='float16')
+        B = te.compute((M, N), lambda i, j: te.exp(A[i, j]), name='E')
+        return te.create_prim_func([A, B])
+
+    qk = PrimFuncNode(gemm(M, N, K, "S"), name="qk")
+    softmax = PrimFuncNode(exp(M, N), name="exp")
+    pv = PrimFuncNode(gemm(M, D, N, "O"), name="pv")
+    for src, dst in [(qk, softmax), (softmax, pv)]:
+        edge = Edge(src, dst, 0, 0)
+        src._out_edges.append(edge)
+        dst.set_inputs(0, edge)
+
+    policy = carver.DefaultPolicy.from_output_nodes([OutputNode(pv)], arch=arch)
+    hints = policy.emit_config(topk=topk)
+    assert len(hints) > 0, "Hints length is zero"
+
+    for hint in hints:
+        print({node.name: config for node, config in hint.items()})
+        # producers are tiled by one reduction step of the consumer gemm
+        assert hint[qk].block[-1] == hint[pv].rstep[0] == hint[softmax].block[-1]
+        assert hint[qk].block[0] == hint[pv].block[0]
+        # the scores stay in registers for the elementwise consumer, the gemm
+        # operand goes through shared memory
+        assert hint[qk].intermediate_scopes == {"S": "local"}
+        assert hint[softmax].intermediate_scopes == {"E": "shared"}
+
+
+def test_fused_gemm_softmax_gemm_emit_configs():
+    run_fused_gemm_softmax_gemm_emit_configs(1024, 1024, 64, 64)
+
+
 if __name__ == "__main__":
     tilelang.testing.main()
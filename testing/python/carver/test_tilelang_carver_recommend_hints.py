@@ -1,6 +1,7 @@
 import tilelang.testing
 from tilelang import carver
 from tilelang.carver.arch import auto_infer_current_arch
+from tilelang.carver.roller.policy import DefaultPolicy
 from typing import List
 
 
@@ -144,5 +145,27 @@ def test_fmha_recommend_hints():
     run_fmha_recommend_hints(4, 32, 512, 512, 128, "int8", "int32", "int32")
 
 
+def test_roller_enumeration_is_memoised():
+    arch = auto_infer_current_arch()
+    func = carver.ElementwiseTemplate(shape=[4096, 4096], dtype="float16").with_arch(
+        arch).equivalent_function()
+    policy = DefaultPolicy.from_prim_func(func=func, arch=arch)
+
+    hints = policy.emit_config(20)
+    stats = policy.get_enumeration_stats()
+    assert len(hints) > 0
+    assert stats["tile_dicts"] > 0
+    assert stats["valid_tiles"] <= stats["tile_dicts"]
+    assert stats["propagate_hits"] > 0
+
+    # A second enumeration is served from the caches
+    rerun = policy.emit_config(20)
+    stats = policy.get_enumeration_stats()
+    assert [hint.block for hint in rerun] == [hint.block for hint in hints]
+    assert stats["tile_dicts"] == 0
+    assert stats["tile_dict_hits"] > 0
+    assert stats["propagate_misses"] == 0
+
+
 if __name__ == "__main__":
     tilelang.testing.main()
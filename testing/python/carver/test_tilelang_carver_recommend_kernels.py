@@ -0,0 +1,88 @@
+import torch
+import tilelang.testing
+from tvm import tir
+from tvm.target import Target
+from tilelang import carver
+from tilelang.carver.arch import CPU, auto_infer_current_arch
+
+
+def run_cpu_matmul_recommend_kernels(M=128, N=128, K=64, topk=4):
+    carve_template = carver.MatmulTemplate(
+        M=M,
+        N=N,
+        K=K,
+        trans_B=False,
+        in_dtype="float32",
+        out_dtype="float32",
+        accum_dtype="float32",
+    ).with_arch(CPU(Target("llvm")))
+
+    results = carve_template.recommend_kernels(topk=topk)
+    assert len(results) > 0, "No kernel compiled"
+    latencies = [result.latency for result in results]
+    assert latencies == sorted(latencies)
+
+    a = torch.randn(M, K)
+    b = torch.randn(K, N)
+    c = torch.zeros(M, N)
+    results[0].kernel(a, b, c)
+    torch.testing.assert_close(c, a @ b, rtol=1e-4, atol=1e-4)
+
+
+def test_cpu_matmul_recommend_kernels():
+    run_cpu_matmul_recommend_kernels()
+
+
+def test_cpu_reduction_recommend_kernels():
+    carve_template = carver.GeneralReductionTemplate(
+        structure="SR", shape=[64, 256], dtype="float32").with_arch(CPU(Target("llvm")))
+    results = carve_template.recommend_kernels(topk=3)
+    assert len(results) > 0, "No kernel compiled"
+
+    a = torch.randn(64, 256)
+    c = torch.zeros(64)
+    results[0].kernel(a, c)
+    torch.testing.assert_close(c, a.sum(dim=1), rtol=1e-4, atol=1e-4)
+
+
+def test_cpu_elementwise_broadcast_recommend_kernels():
+    carve_template = carver.ElementwiseTemplate(
+        shape=[64, 256],
+        dtype="float32",
+        compute=lambda x, bias: tir.max(x + bias, tir.const(0, "float32")),
+        input_shapes=[[64, 256], [256]],
+    ).with_arch(CPU(Target("llvm")))
+    assert carve_template.vector_width() == 16
+    assert carve_template.bytes_moved() == (2 * 64 * 256 + 256) * 4
+
+    results = carve_template.recommend_kernels(topk=3)
+    assert len(results) > 0, "No kernel compiled"
+
+    x = torch.randn(64, 256)
+    bias = torch.randn(256)
+    out = torch.zeros(64, 256)
+    results[0].kernel(x, bias, out)
+    torch.testing.assert_close(out, torch.relu(x + bias))
+
+
+@tilelang.testing.requires_cuda
+def test_cuda_matmul_recommend_kernels():
+    carve_template = carver.MatmulTemplate(
+        M=1024,
+        N=1024,
+        K=1024,
+        in_dtype="float16",
+        out_dtype="float16",
+        accum_dtype="float",
+    ).with_arch(auto_infer_current_arch())
+    results = carve_template.recommend_kernels(topk=4)
+    assert len(results) > 0, "No kernel compiled"
+    a = torch.randn(1024, 1024, dtype=torch.float16, device="cuda")
+    b = torch.randn(1024, 1024, dtype=torch.float16, device="cuda")
+    c = torch.empty(1024, 1024, dtype=torch.float16, device="cuda")
+    results[0].kernel(a, b, c)
+    torch.testing.assert_close(c, (a.float() @ b.float().T).half(), rtol=1e-2, atol=1e-2)
+
+
+if __name__ == "__main__":
+    tilelang.testing.main()
@@ -0,0 +1,153 @@
+import os
+
+import tilelang
+import tilelang.testing
+import tilelang.language as T
+from tilelang.quantize import (compress_ternary_lut, general_compress, uint_decoder,
+                               ternary_decoder, fp4_decoder)
+import torch
+
+tilelang.disable_cache()
+
+
+def cpu_gemm_dequant(M, N, K, block_M, block_N, block_K, decoder, in_dtype, accum_dtype):
+    per_byte = decoder.elems_per_byte
+    group_size = decoder.group_size if decoder.group_size > 0 else K
+    S_shape = (N, K // group_size)
+
+    def gemm_tile(A_local, B, Scale, Zeros, C_local, bx, ko):
+        scale = Scale[bx * block_N, ko * block_K // group_size]
+        zeros = Zeros[bx * block_N, ko * block_K // group_size]
+        return T.gemm_dequant(
+            A_local,
+            B[bx * block_N, ko * block_K // per_byte],
+            C_local,
+            decoder,
+            scale=scale if decoder.with_scaling else None,
+            zeros=zeros if decoder.with_zeros else None)
+
+    @T.prim_func
+    def main(
+            A: T.Tensor((M, K), in_dtype),
+            B: T.Tensor((N, K // per_byte), "int8"),
+            Scale: T.Tensor(S_shape, accum_dtype),
+            Zeros: T.Tensor(S_shape, accum_dtype),
+            C: T.Tensor((M, N), accum_dtype),
+    ):
+        with T.Kernel(
+                T.ceildiv(N, block_N), T.ceildiv(M, block_M), is_cpu=True,
+                parallel=True) as (bx, by):
+            A_local = T.alloc_local((block_M, block_K), in_dtype)
+            C_local = T.alloc_local((block_M, block_N), accum_dtype)
+            T.clear(C_local)
+            for ko in T.Pipelined(T.ceildiv(K, block_K), num_stages=0):
+                T.copy(A[by * block_M, ko * block_K], A_local)
+                gemm_tile(A_local, B, Scale, Zeros, C_local, bx, ko)
+            T.copy(C_local, C[by * block_M, bx * block_N])
+
+    return main
+
+
+def cpu_gemv_lut(M, N, K, block_N, block_K):
+    decoder = ternary_decoder(lut=True)
+
+    @T.prim_func
+    def main(
+            A: T.Tensor((M, K), "int8"),
+            B: T.Tensor((N // 32, K // 2, 16), "int8"),
+            C: T.Tensor((M, N), "int32"),
+    ):
+        with T.Kernel(T.ceildiv(N, block_N), is_cpu=True, parallel=True) as bx:
+            A_local = T.alloc_local((M, block_K), "int8")
+            C_local = T.alloc_local((M, block_N), "int32")
+            T.clear(C_local)
+            for ko in T.Pipelined(T.ceildiv(K, block_K), num_stages=0):
+                T.copy(A[0, ko * block_K], A_local)
+                T.gemm_dequant(A_local, B[bx * block_N // 32, ko * block_K // 2, 0], C_local,
+                               decoder)
+            T.copy(C_local, C[0, bx * block_N])
+
+    return main
+
+
+def run_gemm_dequant(M, N, K, block_M, block_N, block_K, decoder, in_dtype="float32"):
+    accum_dtype = "int32" if in_dtype == "int8" else "float32"
+    kernel = tilelang.compile(
+        cpu_gemm_dequant(M, N, K, block_M, block_N, block_K, decoder, in_dtype, accum_dtype),
+        target="c",
+        execution_backend="ctypes")
+    assert "tl::gemm_cpu_dequant" in kernel.get_kernel_source()
+
+    group_size = decoder.group_size if decoder.group_size > 0 else K
+    q = torch.randint(0, 1 << decoder.num_bits, (N, K), dtype=torch.int8)
+    if decoder.kind == "ternary":
+        q = q.clamp(max=2)
+    b = general_compress(q, source_bits=decoder.num_bits)
+    w = decoder.unpack(b)
+    scale = torch.rand(N, K // group_size)
+    zeros = torch.randint(0, 1 << decoder.num_bits, (N, K // group_size)).float()
+    if decoder.with_zeros:
+        w = w - zeros.repeat_interleave(group_size, dim=1)
+    if decoder.with_scaling:
+        w = w * scale.repeat_interleave(group_size, dim=1)
+
+    if in_dtype == "int8":
+        a = torch.randint(-128, 128, (M, K), dtype=torch.int8)
+        c = torch.zeros(M, N, dtype=torch.int32)
+        kernel(a, b, scale.int(), zeros.int(), c)
+        torch.testing.assert_close(c, (a.double() @ w.double().T).to(torch.int32))
+    else:
+        a = torch.randn(M, K)
+        c = torch.zeros(M, N)
+        kernel(a, b, scale, zeros, c)
+        torch.testing.assert_close(c, a @ w.T, rtol=1e-4, atol=1e-3)
+
+
+def test_uint4_gemm_dequant_scale_zeros():
+    run_gemm_dequant(64, 64, 256, 16, 32, 64,
+                     uint_decoder(4, with_scaling=True, with_zeros=True, group_size=32))
+
+
+def test_uint4_gemm_dequant_group_spans_tiles():
+    run_gemm_dequant(32, 64, 256, 16, 32, 32,
+                     uint_decoder(4, with_scaling=True, group_size=128))
+
+
+def test_fp4_gemm_dequant():
+    run_gemm_dequant(32, 64, 128, 16, 32, 64, fp4_decoder(with_scaling=True))
+
+
+def test_ternary_int8_gemm_dequant():
+    # BitNet 1.58: int8 activations x 2-bit ternary weights on the int8 kernels
+    run_gemm_dequant(64, 48, 256, 32, 24, 128, ternary_decoder(), in_dtype="int8")
+
+
+def run_gemv_lut(M, N, K, block_N, block_K):
+    kernel = tilelang.compile(
+        cpu_gemv_lut(M, N, K, block_N, block_K), target="c", execution_backend="ctypes")
+    assert "TernaryLUT" in kernel.get_kernel_source()
+    w = torch.randint(-1, 2, (N, K), dtype=torch.int8)
+    b = compress_ternary_lut(w)
+    torch.testing.assert_close(ternary_decoder(lut=True).unpack(b), w.float())
+    a = torch.randint(-128, 128, (M, K), dtype=torch.int8)
+    c = torch.zeros(M, N, dtype=torch.int32)
+    kernel(a, b, c)
+    torch.testing.assert_close(c, (a.double() @ w.double().T).to(torch.int32))
+
+
+def test_ternary_lut_gemv():
+    run_gemv_lut(1, 256, 512, 64, 256)
+    # k tiles longer than the int16 flush interval
+    run_gemv_lut(2, 128, 1024, 32, 1024)
+
+
+def test_ternary_lut_gemv_portable_kernel():
+    os.environ["TL_CPU_LUT_KERNEL"] = "portable"
+    try:
+        run_gemv_lut(1, 128, 256, 64, 128)
+    finally:
+        del os.environ["TL_CPU_LUT_KERNEL"]
+
+
+if __name__ == "__main__":
+    tilelang.testing.main()
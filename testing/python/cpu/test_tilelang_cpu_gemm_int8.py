@@ -0,0 +1,116 @@
+import os
+
+import tilelang
+import tilelang.testing
+import tilelang.language as T
+import torch
+
+tilelang.disable_cache()
+
+
+def cpu_gemm(M, N, K, block_M, block_N, block_K, in_dtype, accum_dtype, trans_B=False):
+    B_shape = (N, K) if trans_B else (K, N)
+    B_tile = (block_N, block_K) if trans_B else (block_K, block_N)
+
+    @T.prim_func
+    def main(
+            A: T.Tensor((M, K), in_dtype),
+            B: T.Tensor(B_shape, in_dtype),
+            C: T.Tensor((M, N), accum_dtype),
+    ):
+        with T.Kernel(
+                T.ceildiv(N, block_N), T.ceildiv(M, block_M), is_cpu=True,
+                parallel=True) as (bx, by):
+            A_local = T.alloc_local((block_M, block_K), in_dtype)
+            B_local = T.alloc_local(B_tile, in_dtype)
+            C_local = T.alloc_local((block_M, block_N), accum_dtype)
+            T.clear(C_local)
+            for ko in T.Pipelined(T.ceildiv(K, block_K), num_stages=0):
+                T.copy(A[by * block_M, ko * block_K], A_local)
+                if trans_B:
+                    T.copy(B[bx * block_N, ko * block_K], B_local)
+                else:
+                    T.copy(B[ko * block_K, bx * block_N], B_local)
+                T.gemm(A_local, B_local, C_local, transpose_B=trans_B)
+            T.copy(C_local, C[by * block_M, bx * block_N])
+
+    return main
+
+
+def dp4a_gemv(N, K):
+
+    @T.prim_func
+    def main(A: T.Tensor((K,), "int8"), B: T.Tensor((N, K), "int8"), C: T.Tensor((N,), "int32")):
+        with T.Kernel(N, is_cpu=True) as n:
+            acc = T.alloc_local((1,), "int32")
+            acc[0] = 0
+            for k in T.serial(K // 4):
+                T.dp4a(A[k * 4], B[n, k * 4], acc[0])
+            C[n] = acc[0]
+
+    return main
+
+
+def run_int8_gemm(M, N, K, block_M, block_N, block_K, trans_B=False, in_dtype="int8"):
+    kernel = tilelang.compile(
+        cpu_gemm(M, N, K, block_M, block_N, block_K, in_dtype, "int32", trans_B),
+        target="c",
+        execution_backend="ctypes")
+    assert "tl::gemm_cpu" in kernel.get_kernel_source()
+
+    low, high = (-128, 128) if in_dtype == "int8" else (0, 256)
+    torch_dtype = getattr(torch, in_dtype)
+    a = torch.randint(low, high, (M, K), dtype=torch_dtype)
+    b = torch.randint(low, high, (N, K) if trans_B else (K, N), dtype=torch_dtype)
+    c = torch.zeros(M, N, dtype=torch.int32)
+    kernel(a, b, c)
+    b_ref = b.double().T if trans_B else b.double()
+    torch.testing.assert_close(c, (a.double() @ b_ref).to(torch.int32))
+
+
+def test_int8_gemm():
+    run_int8_gemm(128, 128, 256, 32, 32, 64)
+
+
+def test_int8_gemm_transposed_tail():
+    # N tile not a multiple of the vector width, K tile not a multiple of four
+    run_int8_gemm(96, 72, 90, 32, 24, 30, trans_B=True)
+
+
+def test_uint8_gemm():
+    run_int8_gemm(64, 64, 128, 32, 32, 32, in_dtype="uint8")
+
+
+def test_int8_gemm_portable_kernel():
+    os.environ["TL_CPU_INT8_KERNEL"] = "portable"
+    try:
+        run_int8_gemm(64, 64, 128, 32, 32, 32)
+    finally:
+        del os.environ["TL_CPU_INT8_KERNEL"]
+
+
+def test_float_gemm():
+    M, N, K = 64, 64, 128
+    kernel = tilelang.compile(
+        cpu_gemm(M, N, K, 32, 32, 32, "float32", "float32"),
+        target="c",
+        execution_backend="ctypes")
+    a = torch.randn(M, K)
+    b = torch.randn(K, N)
+    c = torch.zeros(M, N)
+    kernel(a, b, c)
+    torch.testing.assert_close(c, a @ b, rtol=1e-4, atol=1e-4)
+
+
+def test_dp4a():
+    N, K = 16, 64
+    kernel = tilelang.compile(dp4a_gemv(N, K), target="c", execution_backend="ctypes")
+    a = torch.randint(-128, 128, (K,), dtype=torch.int8)
+    b = torch.randint(-128, 128, (N, K), dtype=torch.int8)
+    c = torch.zeros(N, dtype=torch.int32)
+    kernel(a, b, c)
+    torch.testing.assert_close(c, (b.double() @ a.double()).to(torch.int32))
+
+
+if __name__ == "__main__":
+    tilelang.testing.main()
@@ -0,0 +1,117 @@
+import tilelang
+import tilelang.testing
+import tilelang.language as T
+import torch
+
+
+def persistent_scale(M, N, block_M, block_N, num_workers, order):
+
+    @T.prim_func
+    def main(
+            A: T.Tensor((M, N), "float32"),
+            B: T.Tensor((M, N), "float32"),
+    ):
+        with T.Kernel(num_workers, is_cpu=True, parallel=True) as worker:
+            for bx, by in T.Persistent(
+                [T.ceildiv(M, block_M), T.ceildiv(N, block_N)], num_workers, worker, order=order):
+                for i, j in T.grid(block_M, block_N):
+                    B[bx * block_M + i, by * block_N + j] = A[bx * block_M + i,
+                                                              by * block_N + j] * 2.0
+
+    return main
+
+
+def persistent_scale_dynamic(M, N, block_M, block_N, num_workers, order):
+
+    @T.prim_func
+    def main(
+            A: T.Tensor((M, N), "float32"),
+            Counter: T.Tensor((1,), "int32"),
+            B: T.Tensor((M, N), "float32"),
+    ):
+        with T.Kernel(num_workers, is_cpu=True, parallel=True) as worker:
+            for bx, by in T.Persistent(
+                [T.ceildiv(M, block_M), T.ceildiv(N, block_N)],
+                    num_workers,
+                    worker,
+                    order=order,
+                    counter=Counter):
+                for i, j in T.grid(block_M, block_N):
+                    B[bx * block_M + i, by * block_N + j] = A[bx * block_M + i,
+                                                              by * block_N + j] * 2.0
+
+    return main
+
+
+def stream_k_matmul(M, N, K, block_M, block_N, block_K, num_workers):
+
+    @T.prim_func
+    def main(
+            A: T.Tensor((M, K), "float32"),
+            B: T.Tensor((K, N), "float32"),
+            C: T.Tensor((M, N), "float32"),
+    ):
+        with T.Kernel(num_workers, is_cpu=True, parallel=True) as worker:
+            C_local = T.alloc_local((block_M, block_N), "float32")
+            for bx, by, k_begin, k_end in T.StreamK([M // block_M, N // block_N], K // block_K,
+                                                    num_workers, worker):
+                T.clear(C_local)
+                for ko in T.serial(k_end - k_begin):
+                    for i, j, k in T.grid(block_M, block_N, block_K):
+                        C_local[i, j] += A[bx * block_M + i, (k_begin + ko) * block_K + k] * B[
+                            (k_begin + ko) * block_K + k, by * block_N + j]
+                for i, j in T.grid(block_M, block_N):
+                    T.atomic_add(C[bx * block_M + i, by * block_N + j], C_local[i, j])
+
+    return main
+
+
+def run_persistent_scale(order, M=256, N=192, block_M=32, block_N=64, num_workers=5):
+    func = persistent_scale(M, N, block_M, block_N, num_workers, order)
+    kernel = tilelang.compile(func, out_idx=[1], target="c", execution_backend="ctypes")
+    assert "tl::cpu::parallel_for" in kernel.get_kernel_source()
+
+    A = torch.randn(M, N, dtype=torch.float32)
+    B = kernel(A)
+    torch.testing.assert_close(B, A * 2.0)
+
+
+def run_persistent_scale_dynamic(order, M=256, N=192, block_M=32, block_N=64, num_workers=5):
+    func = persistent_scale_dynamic(M, N, block_M, block_N, num_workers, order)
+    kernel = tilelang.compile(func, out_idx=[2], target="c", execution_backend="ctypes")
+    assert "tl::persistent_fetch_tile" in kernel.get_kernel_source()
+
+    A = torch.randn(M, N, dtype=torch.float32)
+    counter = torch.zeros(1, dtype=torch.int32)
+    B = kernel(A, counter)
+    torch.testing.assert_close(B, A * 2.0)
+    # every worker fetches one past the last tile before it stops
+    num_tiles = (M // block_M) * (N // block_N)
+    assert counter.item() == num_tiles + num_workers
+
+
+def test_persistent_static_schedule():
+    run_persistent_scale("row")
+    run_persistent_scale("column")
+    run_persistent_scale("swizzle")
+
+
+def test_persistent_dynamic_schedule():
+    run_persistent_scale_dynamic("row")
+    run_persistent_scale_dynamic("swizzle")
+
+
+def test_stream_k_matmul():
+    M, N, K = 128, 128, 256
+    func = stream_k_matmul(M, N, K, 32, 32, 32, num_workers=7)
+    kernel = tilelang.compile(func, target="c", execution_backend="ctypes")
+
+    A = torch.randn(M, K, dtype=torch.float32)
+    B = torch.randn(K, N, dtype=torch.float32)
+    C = torch.zeros(M, N, dtype=torch.float32)
+    kernel(A, B, C)
+    torch.testing.assert_close(C, A @ B, atol=1e-3, rtol=1e-3)
+
+
+if __name__ == "__main__":
+    tilelang.testing.main()
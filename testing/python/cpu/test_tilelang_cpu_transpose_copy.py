@@ -0,0 +1,53 @@
+import tilelang
+import tilelang.testing
+import tilelang.language as T
+import torch
+
+tilelang.disable_cache()
+
+
+def transpose(M, N, block_M, block_N, dtype):
+
+    @T.prim_func
+    def main(A: T.Tensor((M, N), dtype), B: T.Tensor((N, M), dtype)):
+        with T.Kernel(
+                T.ceildiv(N, block_N), T.ceildiv(M, block_M), is_cpu=True,
+                parallel=True) as (bx, by):
+            A_local = T.alloc_local((block_N, block_M), dtype)
+            for j, i in T.Parallel(block_N, block_M):
+                A_local[j, i] = A[by * block_M + i, bx * block_N + j]
+            T.copy(A_local, B[bx * block_N, by * block_M])
+
+    return main
+
+
+def run_transpose(M, N, block_M, block_N, dtype, torch_dtype):
+    kernel = tilelang.compile(
+        transpose(M, N, block_M, block_N, dtype), target="c", execution_backend="ctypes")
+    assert "tl::cpu::transpose_block" in kernel.get_kernel_source()
+    if torch_dtype.is_floating_point:
+        a = torch.randn(M, N).to(torch_dtype)
+    else:
+        a = torch.randint(-128, 128, (M, N), dtype=torch_dtype)
+    b = torch.zeros(N, M, dtype=torch_dtype)
+    kernel(a, b)
+    torch.testing.assert_close(b, a.T.contiguous())
+
+
+def test_transpose_copy_float32():
+    # 4x4 blocks of 32-bit elements
+    run_transpose(128, 64, 32, 16, "float32", torch.float32)
+
+
+def test_transpose_copy_float16():
+    # 8x8 blocks of 16-bit elements
+    run_transpose(64, 128, 32, 64, "float16", torch.float16)
+
+
+def test_transpose_copy_int8():
+    # 16x16 blocks of 8-bit elements
+    run_transpose(64, 64, 32, 32, "int8", torch.int8)
+
+
+if __name__ == "__main__":
+    tilelang.testing.main()
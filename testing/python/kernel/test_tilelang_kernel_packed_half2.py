@@ -0,0 +1,45 @@
+import tilelang
+import tilelang.testing
+from tilelang import tvm as tvm
+import tilelang.language as T
+
+
+def scale_residual(M, N, block_M, block_N, dtype, threads=128):
+
+    @T.prim_func
+    def main(A: T.Tensor((M, N), dtype), B: T.Tensor((M, N), dtype)):
+        with T.Kernel(T.ceildiv(N, block_N), T.ceildiv(M, block_M), threads=threads) as (bx, by):
+            A_frag = T.alloc_fragment((block_M, block_N), dtype)
+            acc = T.alloc_fragment((block_M, block_N), "float32")
+            B_frag = T.alloc_fragment((block_M, block_N), dtype)
+            T.copy(A[by * block_M, bx * block_N], A_frag)
+            for i, j in T.Parallel(block_M, block_N):
+                acc[i, j] = T.Cast("float32", A_frag[i, j]) * 0.5
+            for i, j in T.Parallel(block_M, block_N):
+                B_frag[i, j] = T.Cast(dtype, acc[i, j]) * A_frag[i, j] + A_frag[i, j]
+            T.copy(B_frag, B[by * block_M, bx * block_N])
+
+    return main
+
+
+def lower_to_cuda(func):
+    # Only generates the source, no device or nvcc needed
+    return tilelang.lower(func, target=tvm.target.Target("cuda -arch=sm_80")).kernel_source
+
+
+def test_packed_half2():
+    source = lower_to_cuda(scale_residual(256, 256, 64, 64, "float16"))
+    assert "__half22float2(" in source
+    assert "__float22half2_rn(" in source
+    assert "__hfma2(" in source
+
+
+def test_packed_bfloat162():
+    source = lower_to_cuda(scale_residual(256, 256, 64, 64, "bfloat16"))
+    assert "__bfloat1622float2(" in source
+    assert "__float22bfloat162_rn(" in source
+    assert "__hfma2(" in source
+
+
+if __name__ == "__main__":
+    tilelang.testing.main()
@@ -0,0 +1,74 @@
+import tilelang
+import tilelang.testing
+from tilelang import tvm as tvm
+import tilelang.language as T
+
+
+def scale(extent):
+
+    @T.prim_func
+    def main(A: T.Tensor((extent,), "float32"), B: T.Tensor((extent,), "float32"),
+             scale: T.float32):
+        # the per-thread loop as LoopPragmaUnroll leaves it
+        for i in T.unroll(extent, annotations={"pragma_unroll_explicit": T.bool(False)}):
+            B[i] = A[i] * scale
+
+    return main
+
+
+def unroll(func, target="cuda"):
+    return tilelang.testing.run_transform(func, tilelang.transform.CostBasedUnroll(), target)
+
+
+def loops(func):
+    return tilelang.testing.collect(func.body, tvm.tir.For)
+
+
+def test_unroll_small_loop_fully():
+    for target in ["cuda", "c"]:
+        _, unrolled = unroll(scale(8), target)
+        loop, = loops(unrolled)
+        assert loop.kind == tvm.tir.ForKind.UNROLLED
+        assert "pragma_unroll_explicit" not in loop.annotations
+        assert "unroll fully" in str(unrolled.attrs["tl.unroll_decisions"][0])
+
+
+def test_unroll_long_loop_partially():
+    _, unrolled = unroll(scale(256), "c")
+    inner, outer = loops(unrolled)
+    assert outer.kind == tvm.tir.ForKind.SERIAL and outer.extent == 32
+    assert inner.kind == tvm.tir.ForKind.UNROLLED and inner.extent == 8
+    assert "unroll by 8" in str(unrolled.attrs["tl.unroll_decisions"][0])
+
+
+def test_unroll_by_a_divisor_of_the_extent():
+    # 8 iterations fit the budget but do not divide 100, 4 do
+    _, unrolled = unroll(scale(100), "c")
+    inner, outer = loops(unrolled)
+    assert outer.extent == 25 and inner.extent == 4
+    assert "unroll by 4" in str(unrolled.attrs["tl.unroll_decisions"][0])
+
+
+def test_prime_extent_keeps_pragma():
+    func, unrolled = unroll(scale(97), "c")
+    tvm.ir.assert_structural_equal(unrolled.body, func.body)
+    assert "keep" in str(unrolled.attrs["tl.unroll_decisions"][0])
+
+
+def test_long_gpu_loop_keeps_pragma():
+    # A serial outer loop would index fragments at runtime
+    func, unrolled = unroll(scale(256))
+    tvm.ir.assert_structural_equal(unrolled.body, func.body)
+    assert "keep" in str(unrolled.attrs["tl.unroll_decisions"][0])
+
+
+def test_disabled_is_untouched():
+    tilelang.testing.assert_transform_untouched(
+        scale(8),
+        tilelang.transform.CostBasedUnroll(),
+        target="cuda",
+        config={tilelang.PassConfigKey.TL_DISABLE_COST_BASED_UNROLL: True})
+
+
+if __name__ == "__main__":
+    tilelang.testing.main()
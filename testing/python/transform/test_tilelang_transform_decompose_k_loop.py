@@ -0,0 +1,123 @@
+import tilelang
+import tilelang.testing
+from tilelang import tvm as tvm
+import tilelang.language as T
+import torch
+
+tilelang.disable_cache()
+
+
+def gpu_matmul(M, N, K, block_M, block_N, block_K, epilogue="copy"):
+
+    @T.prim_func
+    def main(
+            A: T.Tensor((M, K), "float16"),
+            B: T.Tensor((K, N), "float16"),
+            C: T.Tensor((M, N), "float"),
+    ):
+        with T.Kernel(T.ceildiv(N, block_N), T.ceildiv(M, block_M), threads=128) as (bx, by):
+            A_shared = T.alloc_shared((block_M, block_K), "float16")
+            B_shared = T.alloc_shared((block_K, block_N), "float16")
+            C_local = T.alloc_fragment((block_M, block_N), "float")
+            T.clear(C_local)
+            for ko in T.Pipelined(T.ceildiv(K, block_K), num_stages=2):
+                T.copy(A[by * block_M, ko * block_K], A_shared)
+                T.copy(B[ko * block_K, bx * block_N], B_shared)
+                T.gemm(A_shared, B_shared, C_local)
+            if epilogue == "relu":
+                for i, j in T.Parallel(block_M, block_N):
+                    C_local[i, j] = T.max(C_local[i, j], 0)
+            T.copy(C_local, C[by * block_M, bx * block_N])
+
+    return main
+
+
+def cpu_matmul(M, N, K, block_M, block_N, block_K):
+
+    @T.prim_func
+    def main(
+            A: T.Tensor((M, K), "float32"),
+            B: T.Tensor((K, N), "float32"),
+            C: T.Tensor((M, N), "float32"),
+    ):
+        with T.Kernel(
+                T.ceildiv(N, block_N), T.ceildiv(M, block_M), is_cpu=True,
+                parallel=True) as (bx, by):
+            C_local = T.alloc_local((block_M, block_N), "float32")
+            T.clear(C_local)
+            for ko in T.Pipelined(K // block_K, num_stages=0):
+                for i, j, k in T.grid(block_M, block_N, block_K):
+                    C_local[i, j] += A[by * block_M + i, ko * block_K + k] * B[ko * block_K + k,
+                                                                               bx * block_N + j]
+            T.copy(C_local, C[by * block_M, bx * block_N])
+
+    return main
+
+
+def decompose(func, config):
+    mod = tvm.IRModule.from_expr(func.with_attr("global_symbol", "main"))
+    with tvm.transform.PassContext(config=config):
+        mod = tilelang.transform.DecomposeKLoop()(mod)
+    return mod["main"]
+
+
+def test_split_k_rewrite():
+    func = gpu_matmul(256, 256, 512, 64, 64, 32)
+    script = decompose(func, {"tl.split_k": 4}).script()
+    assert "T.launch_thread(\"blockIdx.x\", 16)" in script, script
+    assert "AtomicAdd" in script, script
+    assert "num_stages" in script, script
+    assert [int(i) for i in decompose(func, {"tl.split_k": 4}).attrs["tl.atomic_outputs"]] == [2]
+
+
+def test_stream_k_rewrite():
+    func = gpu_matmul(256, 256, 512, 64, 64, 32)
+    script = decompose(func, {"tl.stream_k_workers": 6}).script()
+    assert "T.launch_thread(\"blockIdx.x\", 6)" in script, script
+    assert "T.launch_thread(\"blockIdx.y\", 1)" in script, script
+    assert "AtomicAdd" in script, script
+
+
+def test_nonlinear_epilogue_is_kept():
+    func = gpu_matmul(256, 256, 512, 64, 64, 32, epilogue="relu")
+    script = decompose(func, {"tl.split_k": 4}).script()
+    assert "AtomicAdd" not in script, script
+    assert "T.launch_thread(\"blockIdx.x\", 4)" in script, script
+
+
+def run_cpu_decomposed_matmul(config, M=128, N=128, K=256, block_M=32, block_N=32, block_K=16):
+    func = cpu_matmul(M, N, K, block_M, block_N, block_K)
+    kernel = tilelang.compile(
+        func, target="c", execution_backend="ctypes", pass_configs=config)
+    assert "AtomicAdd" in kernel.get_kernel_source()
+
+    a = torch.randn(M, K, dtype=torch.float32)
+    b = torch.randn(K, N, dtype=torch.float32)
+    c = torch.zeros(M, N, dtype=torch.float32)
+    kernel(a, b, c)
+    torch.testing.assert_close(c, a @ b, rtol=1e-3, atol=1e-3)
+
+
+def test_cpu_split_k():
+    run_cpu_decomposed_matmul({"tl.split_k": 4})
+
+
+def test_cpu_stream_k():
+    run_cpu_decomposed_matmul({"tl.stream_k_workers": 5})
+
+
+def test_atomic_output_is_rejected_as_out_idx():
+    # out_idx outputs are allocated uninitialized, the atomic epilogue needs zeros
+    func = cpu_matmul(128, 128, 256, 32, 32, 16)
+    for config in [{"tl.split_k": 4}, {"tl.stream_k_workers": 5}]:
+        try:
+            tilelang.compile(
+                func, out_idx=[2], target="c", execution_backend="ctypes", pass_configs=config)
+        except ValueError:
+            pass
+        else:
+            raise AssertionError("an atomically reduced output must not be in out_idx")
+
+
+if __name__ == "__main__":
+    tilelang.testing.main()
@@ -0,0 +1,93 @@
+import tilelang
+import tilelang.testing
+from tilelang import tvm as tvm
+import tilelang.language as T
+
+
+def matmul(M, N, K, block_M, block_N, block_K, dtype="float16", read_before_copy=False):
+    accum_dtype = "float"
+
+    @T.prim_func
+    def main(
+            A: T.Tensor((M, K), dtype),
+            B: T.Tensor((K, N), dtype),
+            C: T.Tensor((M, N), dtype),
+    ):
+        with T.Kernel(T.ceildiv(N, block_N), T.ceildiv(M, block_M), threads=128) as (bx, by):
+            A_shared = T.alloc_shared((block_M, block_K), dtype)
+            B_shared = T.alloc_shared((block_K, block_N), dtype)
+            C_local = T.alloc_fragment((block_M, block_N), accum_dtype)
+            T.fill(A_shared, 0)
+            if read_before_copy:
+                T.copy(A_shared, C[by * block_M, bx * block_N])
+            T.copy(A[by * block_M, 0], A_shared)
+            T.copy(B[0, bx * block_N], B_shared)
+            T.clear(C_local)
+            T.gemm(A_shared, B_shared, C_local)
+            T.copy(C_local, C[by * block_M, bx * block_N])
+
+    return main
+
+
+def eliminate(func, **kwargs):
+    return tilelang.testing.run_transform(
+        func,
+        tilelang.transform.EliminateDeadTileWrites(),
+        prepare=[tilelang.transform.FrontendLegalize()],
+        **kwargs)
+
+
+def tile_ops(func, name):
+    return [
+        call for call in tilelang.testing.collect(func.body, tvm.tir.Call)
+        if isinstance(call.op, tvm.ir.Op) and call.op.name == name
+    ]
+
+
+def test_drop_overwritten_fill_and_fold_clear():
+    _, eliminated = eliminate(matmul(128, 128, 32, 64, 64, 32))
+    # the shared fill is overwritten by the copy, the clear folds into the gemm
+    assert not tile_ops(eliminated, "tl.fill")
+    gemm = tile_ops(eliminated, "tl.gemm")[0]
+    assert bool(gemm.args[9])
+
+
+def test_fill_read_before_overwrite_is_kept():
+    _, eliminated = eliminate(matmul(128, 128, 32, 64, 64, 32, read_before_copy=True))
+    fills = tile_ops(eliminated, "tl.fill")
+    assert len(fills) == 1
+    assert "A_shared" in str(fills[0].args[0])
+
+
+def padded_tile(tile):
+
+    @T.prim_func
+    def main(A: T.Tensor((64, 64), "float16"), B: T.Tensor((64, 64), "float16")):
+        with T.Kernel(2, threads=128) as bx:
+            A_shared = T.alloc_shared((32, 32), "float16")
+            T.fill(A_shared, 0)
+            T.copy(A[bx * tile:bx * tile + tile, 0:tile], A_shared)
+            T.copy(A_shared, B[bx * 32, 0])
+
+    return main
+
+
+def test_fill_padding_smaller_copy_is_kept():
+    # a 30x30 tile padded to 32x32, the border keeps the fill
+    _, eliminated = eliminate(padded_tile(30))
+    assert len(tile_ops(eliminated, "tl.fill")) == 1
+    # a source slice covering the whole tile overwrites it
+    _, eliminated = eliminate(padded_tile(32))
+    assert not tile_ops(eliminated, "tl.fill")
+
+
+def test_disabled_is_untouched():
+    tilelang.testing.assert_transform_untouched(
+        matmul(128, 128, 32, 64, 64, 32),
+        tilelang.transform.EliminateDeadTileWrites(),
+        prepare=[tilelang.transform.FrontendLegalize()],
+        config={tilelang.PassConfigKey.TL_DISABLE_DEAD_TILE_WRITE_ELIMINATION: True})
+
+
+if __name__ == "__main__":
+    tilelang.testing.main()
@@ -0,0 +1,114 @@
+import tilelang
+import tilelang.testing
+from tilelang import tvm as tvm
+import tilelang.language as T
+import torch
+
+
+def attention_like(seq_len=256, dim=64, block_M=64, block_N=64, dtype="float16", p_dtype=None):
+    accum_dtype = "float"
+    p_dtype = p_dtype or dtype
+
+    @T.prim_func
+    def main(
+            Q: T.Tensor((seq_len, dim), dtype),
+            K: T.Tensor((seq_len, dim), dtype),
+            V: T.Tensor((seq_len, dim), dtype),
+            Output: T.Tensor((seq_len, dim), dtype),
+    ):
+        with T.Kernel(T.ceildiv(seq_len, block_M), threads=128) as bx:
+            Q_shared = T.alloc_shared((block_M, dim), dtype)
+            K_shared = T.alloc_shared((block_N, dim), dtype)
+            V_shared = T.alloc_shared((block_N, dim), dtype)
+            P_shared = T.alloc_shared((block_M, block_N), p_dtype)
+            acc_s = T.alloc_fragment((block_M, block_N), accum_dtype)
+            acc_s_cast = T.alloc_fragment((block_M, block_N), p_dtype)
+            acc_o = T.alloc_fragment((block_M, dim), accum_dtype)
+            T.clear(acc_o)
+            for k in T.Pipelined(T.ceildiv(seq_len, block_N), num_stages=1):
+                T.copy(Q[bx * block_M, 0], Q_shared)
+                T.copy(K[k * block_N, 0], K_shared)
+                T.clear(acc_s)
+                T.gemm(Q_shared, K_shared, acc_s, transpose_B=True)
+                T.copy(acc_s, acc_s_cast)
+                T.copy(acc_s_cast, P_shared)
+                T.copy(V[k * block_N, 0], V_shared)
+                T.gemm(P_shared, V_shared, acc_o)
+            T.copy(acc_o, Output[bx * block_M, 0])
+
+    return main
+
+
+def forward(func, config=None):
+    mod = tvm.IRModule.from_expr(func.with_attr("global_symbol", "main"))
+    with tvm.transform.PassContext(config=config or {}):
+        mod = tilelang.transform.FrontendLegalize()(mod)
+        mod = tilelang.transform.ForwardStagingBuffers()(mod)
+    return mod["main"]
+
+
+FORWARD_FRAGMENTS = {"tl.enable_fragment_forwarding": True}
+
+
+def test_fragment_staging_kept_by_default():
+    # The round trip may be a layout conversion, only forwarded on request
+    script = forward(attention_like()).script()
+    assert "P_shared" in script, script
+
+
+def test_forward_fragment_to_gemm():
+    script = forward(attention_like(), FORWARD_FRAGMENTS).script()
+    assert "P_shared" not in script, script
+    assert "acc_s_cast.data" in script, script
+
+
+def pipelined_loop(func):
+    loops = []
+    tvm.tir.stmt_functor.post_order_visit(
+        func.body, lambda n: loops.append(n)
+        if isinstance(n, tvm.tir.For) and "num_stages" in n.annotations else None)
+    assert len(loops) == 1
+    return loops[0]
+
+
+def test_hoist_invariant_load():
+    loop = pipelined_loop(forward(attention_like()))
+    assert "Q_shared" not in loop.body.script()
+    assert "K_shared" in loop.body.script()
+
+
+def test_hoist_guards_loop_that_may_not_run():
+    # The loop runs ceildiv(seq_len, 64) times, which may be zero
+    func = forward(attention_like(seq_len=T.symbolic("seq_len")))
+    guards = []
+    tvm.tir.stmt_functor.post_order_visit(
+        func.body, lambda n: guards.append(n) if isinstance(n, tvm.tir.IfThenElse) else None)
+    assert len(guards) == 1
+    assert "Q_shared" in guards[0].then_case.script()
+
+
+def test_mismatched_operand_is_not_forwarded():
+    # A float32 fragment cannot be the register operand of a gemm with float16 B
+    script = forward(attention_like(p_dtype="float"), FORWARD_FRAGMENTS).script()
+    assert "P_shared" in script, script
+
+
+def test_disable_forwarding():
+    config = {"tl.disable_staging_forwarding": True, **FORWARD_FRAGMENTS}
+    func = forward(attention_like(), config)
+    assert "P_shared" in func.script()
+    assert "Q_shared" in pipelined_loop(func).body.script()
+
+
+@tilelang.testing.requires_cuda
+def test_forwarded_attention_lowers_to_gemm_rs():
+    kernel = tilelang.compile(attention_like(), out_idx=[3], pass_configs=FORWARD_FRAGMENTS)
+    assert "gemm_rs" in kernel.get_kernel_source()
+
+    q, k, v = (torch.randn(256, 64, dtype=torch.float16, device="cuda") for _ in range(3))
+    ref = ((q.float() @ k.float().T).half().float() @ v.float()).half()
+    torch.testing.assert_close(kernel(q, k, v), ref, rtol=1e-2, atol=1e-1)
+
+
+if __name__ == "__main__":
+    tilelang.testing.main()
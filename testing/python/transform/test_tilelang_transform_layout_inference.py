@@ -89,6 +89,74 @@ def test_loop_tail_split(block_M, block_N, block_K, threads, vec_load_b, dtype):
     # tvm.ir.assert_structural_equal(mod, ref_mod)
 
 
+def scale_tile(M, N):
+
+    @T.prim_func
+    def main(A: T.Tensor((M, N), "float32"), B: T.Tensor((M, N), "float32")):
+        with T.Kernel(1, threads=128):
+            A_local = T.alloc_fragment((M, N), "float32")
+            B_local = T.alloc_fragment((M, N), "float16")
+            T.copy(A, A_local)
+            for i, j in T.Parallel(M, N):
+                B_local[i, j] = A_local[i, j] * 2
+            T.copy(B_local, B)
+
+    return main
+
+
+def scale_row_max(M, N):
+
+    @T.prim_func
+    def main(A: T.Tensor((M, N), "float32"), B: T.Tensor((M, N), "float32"),
+             C: T.Tensor((M,), "float32")):
+        with T.Kernel(1, threads=128):
+            A_local = T.alloc_fragment((M, N), "float32")
+            B_local = T.alloc_fragment((M,), "float32")
+            C_local = T.alloc_fragment((M,), "float32")
+            T.copy(A, A_local)
+            T.reduce_max(A_local, B_local, dim=1)
+            # B_local is replicated over the threads of a row, C_local inherits
+            # that unless the loop spreads the replicas over its iterations
+            for i in T.Parallel(M):
+                C_local[i] = B_local[i] * 2
+            T.copy(A_local, B)
+            T.copy(C_local, C)
+
+    return main
+
+
+def register_footprint(main, budget=None):
+    config = {} if budget is None else {"tl.register_budget": budget}
+    mod = tvm.IRModule.from_expr(main.with_attr("global_symbol", "main"))
+    with tvm.transform.PassContext(config=config):
+        mod = tvm.tir.transform.BindTarget(tvm.target.Target("cuda -arch=sm_80"))(mod)
+        mod = tl.transform.FrontendLegalize()(mod)
+        mod = tl.transform.LayoutInference()(mod)
+    return mod["main"].attrs["tl.register_footprint"]
+
+
+def test_register_footprint():
+    footprint = register_footprint(scale_tile(128, 128))
+    # 128x128 fp32 and 128x128 fp16 over 128 threads, both live at the parallel loop
+    assert footprint["peak_registers"] == 128 + 64, footprint
+    assert footprint["register_budget"] == 255, footprint
+    assert any("A_local" in str(entry) for entry in footprint["decisions"]), footprint
+
+    footprint = register_footprint(scale_tile(128, 128), budget=96)
+    assert footprint["register_budget"] == 96, footprint
+
+
+def test_register_footprint_over_budget():
+    unconstrained = register_footprint(scale_row_max(128, 128))
+    assert not any("fall back" in str(entry) for entry in unconstrained["decisions"])
+    # Over budget, inference retries with less replicated layouts and keeps them
+    # since they need fewer registers
+    footprint = register_footprint(scale_row_max(128, 128), budget=96)
+    assert footprint["peak_registers"] < unconstrained["peak_registers"], footprint
+    assert any("fall back to less replicated layouts" in str(entry)
+               for entry in footprint["decisions"]), footprint
+
+
 if __name__ == "__main__":
     # tilelang.testing.main()
     test_loop_tail_split(64, 64, 32, 128, 8, "float16")
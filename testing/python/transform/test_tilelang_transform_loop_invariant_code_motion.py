@@ -0,0 +1,79 @@
+import tilelang
+import tilelang.testing
+from tilelang import tvm as tvm
+import tilelang.language as T
+
+
+def scaled_rows(clobber=None):
+
+    @T.prim_func
+    def main(A: T.Tensor((64, 128), "float32"), Scale: T.Tensor((64,), "float32"),
+             B: T.Tensor((64, 128), "float32"), n: T.int32, m: T.int32):
+        for i in T.serial(64):
+            for k in T.serial(n):
+                if i * 2 < m:
+                    B[i, k] = A[i, k]
+                B[i, k] = B[i, k] * Scale[i]
+                if clobber == "store":
+                    Scale[0] = A[i, k]
+                if clobber == "address":
+                    T.evaluate(T.call_extern("handle", "consume", T.address_of(Scale[0])))
+
+    return main
+
+
+def scaled_tiles():
+
+    @T.prim_func
+    def main(A: T.Tensor((128,), "float32"), Scale: T.Tensor((4,), "float32"),
+             B: T.Tensor((128,), "float32"), n: T.int32, bx: T.int32):
+        for k in T.serial(n):
+            for j in T.serial(4):
+                B[k * 4 + j] = A[k * 4 + j] * Scale[bx]
+
+    return main
+
+
+def hoist(func):
+    return tilelang.testing.run_transform(func, tilelang.transform.LoopInvariantCodeMotion())
+
+
+collect = tilelang.testing.collect
+
+
+def loop(func, name):
+    return [f for f in collect(func.body, tvm.tir.For) if f.loop_var.name == name][0]
+
+
+def test_hoist_load_and_predicate():
+    _, hoisted = hoist(scaled_rows())
+    lets = {let.var.name: let.value for let in collect(hoisted.body, tvm.tir.LetStmt)}
+    assert set(lets) == {"cond_inv", "Scale_inv"}
+    # n may be zero, so the hoisted load is guarded by the trip count
+    assert isinstance(lets["Scale_inv"], tvm.tir.Call)
+    k_loop = loop(hoisted, "k")
+    assert "Scale" not in {load.buffer.name for load in collect(k_loop.body, tvm.tir.BufferLoad)}
+    assert isinstance(collect(k_loop.body, tvm.tir.IfThenElse)[0].condition, tvm.tir.Var)
+
+
+def test_bindings_move_out_of_outer_loops():
+    _, hoisted = hoist(scaled_tiles())
+    # hoisted out of j unguarded, then out of k guarded by n > 0
+    assert isinstance(hoisted.body, tvm.tir.LetStmt)
+    assert hoisted.body.var.name == "Scale_inv"
+    assert isinstance(hoisted.body.body, tvm.tir.For)
+    assert not collect(loop(hoisted, "k").body, tvm.tir.LetStmt)
+
+
+def test_written_escaped_or_disabled_are_untouched():
+    for clobber in ["store", "address"]:
+        _, hoisted = hoist(scaled_rows(clobber))
+        assert "Scale_inv" not in {let.var.name for let in collect(hoisted.body, tvm.tir.LetStmt)}
+    tilelang.testing.assert_transform_untouched(
+        scaled_rows(),
+        tilelang.transform.LoopInvariantCodeMotion(),
+        config={tilelang.PassConfigKey.TL_DISABLE_LOOP_INVARIANT_CODE_MOTION: True})
+
+
+if __name__ == "__main__":
+    tilelang.testing.main()
@@ -0,0 +1,130 @@
+import tilelang
+import tilelang.testing
+from tilelang import tvm as tvm
+import tilelang.language as T
+import torch
+
+tilelang.disable_cache()
+
+
+def grid_gemm(M, N, K):
+
+    @T.prim_func
+    def main(
+            A: T.Tensor((M, K), "float32"),
+            B: T.Tensor((K, N), "float32"),
+            C: T.Tensor((M, N), "float32"),
+    ):
+        for i, j, k in T.grid(M, N, K):
+            C[i, j] += A[i, k] * B[k, j]
+
+    return main
+
+
+def grid_transpose(M, N):
+
+    @T.prim_func
+    def main(A: T.Tensor((M, N), "float32"), B: T.Tensor((N, M), "float32")):
+        for j, i in T.grid(N, M):
+            A[i, j] = B[j, i] + A[i, j]
+
+    return main
+
+
+def grid_shift(M, N):
+
+    @T.prim_func
+    def main(A: T.Tensor((M, N + 1), "float32")):
+        for j, i in T.grid(N, M):
+            A[i, j + 1] = A[i, j]
+
+    return main
+
+
+def optimize(func, target="c"):
+    _, optimized = tilelang.testing.run_transform(
+        func, tilelang.transform.OptimizeCPULoopNest(), target=target)
+    return optimized
+
+
+def loop_nest(func):
+    """(name, kind, extent) of the loops of a single nest, outermost first."""
+    loops = tilelang.testing.collect(func.body, tvm.tir.For)
+    return [(loop.loop_var.name, loop.kind, int(loop.extent)) for loop in loops[::-1]]
+
+
+def test_gemm_interchange_and_unroll_and_jam():
+    serial, unrolled = tvm.tir.ForKind.SERIAL, tvm.tir.ForKind.UNROLLED
+    # 128-bit vectors of the C backend: 2 vectors of 4 lanes by 4 jammed rows
+    assert loop_nest(optimize(grid_gemm(64, 64, 32))) == [
+        ("i_outer", serial, 16),
+        ("j_outer", serial, 8),
+        ("k", serial, 32),
+        ("j_inner", serial, 8),
+        ("i_inner", unrolled, 4),
+    ]
+    # AVX-512: 16 lanes, the 32 registers leave room for 8 rows
+    nest = loop_nest(optimize(grid_gemm(64, 64, 32), target="llvm -mcpu=skylake-avx512"))
+    assert [(name, extent) for name, _, extent in nest] == [
+        ("i_outer", 8),
+        ("j_outer", 2),
+        ("k", 32),
+        ("j_inner", 32),
+        ("i_inner", 8),
+    ]
+
+
+def test_interchange_for_unit_stride():
+    nest = loop_nest(optimize(grid_transpose(64, 32)))
+    assert [name for name, _, _ in nest] == ["i", "j"]
+
+
+def test_dependent_gpu_or_disabled_are_untouched():
+    for func, target, config in [
+        # a loop carried dependence forbids the interchange
+        (grid_shift(64, 32), "c", None),
+        (grid_gemm(64, 64, 32), "cuda", None),
+        (grid_gemm(64, 64, 32), "c", {tilelang.PassConfigKey.TL_DISABLE_LOOP_NEST_OPTIMIZE: True}),
+    ]:
+        tilelang.testing.assert_transform_untouched(
+            func, tilelang.transform.OptimizeCPULoopNest(), target=target, config=config)
+
+
+def cpu_grid_matmul(M, N, K, block_M, block_N, block_K):
+
+    @T.prim_func
+    def main(
+            A: T.Tensor((M, K), "float32"),
+            B: T.Tensor((K, N), "float32"),
+            C: T.Tensor((M, N), "float32"),
+    ):
+        with T.Kernel(
+                T.ceildiv(N, block_N), T.ceildiv(M, block_M), is_cpu=True,
+                parallel=True) as (bx, by):
+            A_local = T.alloc_local((block_M, block_K), "float32")
+            B_local = T.alloc_local((block_K, block_N), "float32")
+            C_local = T.alloc_local((block_M, block_N), "float32")
+            T.clear(C_local)
+            for ko in T.Pipelined(K // block_K, num_stages=0):
+                T.copy(A[by * block_M, ko * block_K], A_local)
+                T.copy(B[ko * block_K, bx * block_N], B_local)
+                for i, j, k in T.grid(block_M, block_N, block_K):
+                    C_local[i, j] += A_local[i, k] * B_local[k, j]
+            T.copy(C_local, C[by * block_M, bx * block_N])
+
+    return main
+
+
+def test_cpu_grid_matmul():
+    M, N, K = 128, 128, 128
+    kernel = tilelang.compile(
+        cpu_grid_matmul(M, N, K, 32, 32, 32), target="c", execution_backend="ctypes")
+    a = torch.randn(M, K)
+    b = torch.randn(K, N)
+    c = torch.zeros(M, N)
+    kernel(a, b, c)
+    torch.testing.assert_close(c, a @ b, rtol=1e-4, atol=1e-4)
+
+
+if __name__ == "__main__":
+    tilelang.testing.main()
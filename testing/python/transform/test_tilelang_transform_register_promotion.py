@@ -0,0 +1,73 @@
+import tilelang
+import tilelang.testing
+from tilelang import tvm as tvm
+import tilelang.language as T
+
+
+def local_gemm(M, N, K, escape=False):
+
+    @T.prim_func
+    def main(
+            A: T.Tensor((M, K), "float32"),
+            B: T.Tensor((K, N), "float32"),
+            C: T.Tensor((M, N), "float32"),
+    ):
+        C_local = T.alloc_local((M, N), "float32")
+        for i, j in T.grid(M, N):
+            C_local[i, j] = 0
+        for i in T.serial(M):
+            for k in T.serial(K):
+                for j in T.serial(N):
+                    C_local[i, j] += A[i, k] * B[k, j]
+                if escape:
+                    T.evaluate(T.call_extern("handle", "consume", T.address_of(C_local[i, 0])))
+        for i, j in T.grid(M, N):
+            C[i, j] = C_local[i, j]
+
+    return main
+
+
+def promote(func):
+    return tilelang.testing.run_transform(
+        func,
+        tilelang.transform.RegisterPromotion(),
+        prepare=[tvm.tir.transform.LowerOpaqueBlock()])
+
+
+def allocations(func):
+    return {
+        alloc.buffer_var.name: [int(e) for e in alloc.extents]
+        for alloc in tilelang.testing.collect(func.body, tvm.tir.Allocate)
+    }
+
+
+def buffers_in_loop(func, loop_var):
+    loop, = [
+        node for node in tilelang.testing.collect(func.body, tvm.tir.For)
+        if node.loop_var.name == loop_var
+    ]
+    accesses = tilelang.testing.collect(loop.body, (tvm.tir.BufferLoad, tvm.tir.BufferStore))
+    return {access.buffer.name for access in accesses}
+
+
+def test_promote_accumulator_row():
+    _, promoted = promote(local_gemm(16, 8, 32))
+    # The row of C_local updated by the k loop lives in registers across it
+    assert allocations(promoted)["C_local_reg"] == [1, 8]
+    assert buffers_in_loop(promoted, "k") == {"A", "B", "C_local_reg"}
+
+
+def test_escaped_or_disabled_are_untouched():
+    for func, config in [
+        (local_gemm(16, 8, 32, escape=True), None),
+        (local_gemm(16, 8, 32), {tilelang.PassConfigKey.TL_DISABLE_REGISTER_PROMOTION: True}),
+    ]:
+        tilelang.testing.assert_transform_untouched(
+            func,
+            tilelang.transform.RegisterPromotion(),
+            prepare=[tvm.tir.transform.LowerOpaqueBlock()],
+            config=config)
+
+
+if __name__ == "__main__":
+    tilelang.testing.main()
@@ -0,0 +1,99 @@
+import tilelang
+import tilelang.testing
+from tilelang import tvm as tvm
+import tilelang.language as T
+import torch
+
+
+def scale_fragment(dtype="float16"):
+
+    @T.prim_func
+    def main(A: T.Tensor((64,), dtype), B: T.Tensor((64,), dtype), scale: T.float32):
+        A_local = T.alloc_local((8,), dtype)
+        for i in T.unroll(8):
+            A_local[i] = A[i]
+        for i in T.unroll(8):
+            B[i] = T.Cast(dtype, T.Cast("float32", A_local[i]) * scale)
+
+    return main
+
+
+def prefix_sum():
+
+    @T.prim_func
+    def main(A: T.Tensor((64,), "float32")):
+        A_local = T.alloc_local((9,), "float32")
+        for i in T.unroll(8):
+            A_local[i + 1] = A_local[i] + A[i]
+        for i in T.unroll(8):
+            A[i] = A_local[i]
+
+    return main
+
+
+def slp(func, target="cuda", **kwargs):
+    return tilelang.testing.run_transform(
+        func,
+        tilelang.transform.SLPVectorize(),
+        target=target,
+        prepare=[tvm.tir.transform.LowerOpaqueBlock(), tvm.tir.transform.UnrollLoop()],
+        **kwargs)
+
+
+def stores(func):
+    return tilelang.testing.collect(func.body, tvm.tir.BufferStore)
+
+
+def test_pack_unrolled_fragment():
+    _, packed = slp(scale_fragment())
+    # eight halves fill a 128-bit vector, four once widened to float
+    assert [(s.buffer.name, s.value.dtype) for s in stores(packed)] == [
+        ("A_local", "float16x8"),
+        ("B", "float16x4"),
+        ("B", "float16x4"),
+    ]
+    for store in stores(packed):
+        assert isinstance(store.indices[0], tvm.tir.Ramp)
+
+
+def test_dependent_lanes_stay_scalar():
+    _, packed = slp(prefix_sum())
+    values = [s.value.dtype for s in stores(packed)]
+    # the running sum reads what the previous lane wrote, the copy-out packs
+    assert values == ["float32"] * 8 + ["float32x4"] * 2
+
+
+def test_llvm_and_disabled_are_untouched():
+    for target, config in [
+        ("llvm", None),
+        ("cuda", {tilelang.PassConfigKey.TL_DISABLE_SLP_VECTORIZE: True}),
+    ]:
+        original, packed = slp(scale_fragment(), target=target, config=config)
+        tvm.ir.assert_structural_equal(packed, original)
+
+
+def scale_kernel(N, block):
+
+    @T.prim_func
+    def main(A: T.Tensor((N,), "float32"), B: T.Tensor((N,), "float32")):
+        with T.Kernel(T.ceildiv(N, block), is_cpu=True) as bx:
+            A_local = T.alloc_local((block,), "float32")
+            for i in T.unroll(block):
+                A_local[i] = A[bx * block + i]
+            for i in T.unroll(block):
+                B[bx * block + i] = A_local[i] * 2.0 + 1.0
+
+    return main
+
+
+def test_pack_c_kernel():
+    kernel = tilelang.compile(scale_kernel(256, 8), target="c", execution_backend="ctypes")
+    assert "float4" in kernel.get_kernel_source()
+    a = torch.randn(256)
+    b = torch.zeros(256)
+    kernel(a, b)
+    torch.testing.assert_close(b, a * 2 + 1)
+
+
+if __name__ == "__main__":
+    tilelang.testing.main()
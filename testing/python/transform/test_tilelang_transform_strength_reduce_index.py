@@ -0,0 +1,51 @@
+import tilelang
+import tilelang.testing
+from tilelang import tvm as tvm
+import tilelang.language as T
+
+
+def flat_stencil():
+
+    @T.prim_func
+    def main(A: T.Tensor((4097,), "float32"), B: T.Tensor((4096,), "float32"), by: T.int32):
+        for i in T.serial(16):
+            for j in T.serial(16):
+                B[by * 256 + i * 16 + j] = A[by * 256 + i * 16 + j] + A[by * 256 + i * 16 + j + 1]
+
+    return main
+
+
+def reduce(func):
+    return tilelang.testing.run_transform(
+        func, tilelang.transform.StrengthReduceIndex(), target="c")
+
+
+collect = tilelang.testing.collect
+
+
+def test_bases_hoisted_per_loop():
+    _, reduced = reduce(flat_stencil())
+    lets = collect(reduced.body, tvm.tir.LetStmt)
+    # by * 256 before the i loop, base + i * 16 before the j loop
+    assert len(lets) == 2
+    inner = [loop for loop in collect(reduced.body, tvm.tir.For) if loop.loop_var.name == "j"][0]
+    accesses = collect(inner.body, tvm.tir.BufferLoad) + collect(inner.body, tvm.tir.BufferStore)
+    assert len(accesses) == 3
+    for access in accesses:
+        # the base bound before the j loop plus j and a constant, no multiplies
+        index = access.indices[0]
+        assert not collect(index, tvm.tir.Mul)
+        assert {v.name for v in collect(index, tvm.tir.Var)} == {lets[0].var.name, "j"}
+
+
+def test_llvm_and_disabled_are_untouched():
+    for target, config in [
+        ("llvm", None),
+        ("c", {tilelang.PassConfigKey.TL_DISABLE_STRENGTH_REDUCTION: True}),
+    ]:
+        tilelang.testing.assert_transform_untouched(
+            flat_stencil(), tilelang.transform.StrengthReduceIndex(), target=target, config=config)
+
+
+if __name__ == "__main__":
+    tilelang.testing.main()
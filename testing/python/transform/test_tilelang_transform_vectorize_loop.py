@@ -11,6 +11,10 @@ simple_target = tvm.target.Target("llvm -mtriple=x86_64-linux-gnu")
 sve_target = tvm.target.Target("llvm -device=arm_cpu -mtriple=aarch64-linux-gnu -mattr=+v8.2a,+sve")
 
 
+def scalarize_guards():
+    return tvm.transform.PassContext(config={"tl.disable_masked_vectorize": True})
+
+
 @tilelang.testing.requires_llvm
 @pytest.mark.parametrize("extent, target", [(4, simple_target), (T.vscale() * 4, sve_target)])
 def test_vectorize_loop(extent, target):
@@ -156,7 +160,7 @@ def test_vectorize_with_if(extent, target):
                     if i_s < n:
                         A[i_s] = T.float32(2)
 
-    with tvm.target.Target(target):
+    with tvm.target.Target(target), scalarize_guards():
         mod = tilelang.transform.VectorizeLoop()(Before)
         tvm.ir.assert_structural_equal(mod, After)
 
@@ -211,7 +215,7 @@ def test_vectorize_with_le_cond(extent, target):
 
     mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc([A, n], stmt))
 
-    with tvm.target.Target(target):
+    with tvm.target.Target(target), scalarize_guards():
         stmt = tilelang.transform.VectorizeLoop()(mod)["main"].body
 
         # Check that the loop wasn't vectorised
@@ -231,7 +235,7 @@ def test_vectorize_with_ge_cond(extent, target):
 
     mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc([A, n], stmt))
 
-    with tvm.target.Target(target):
+    with tvm.target.Target(target), scalarize_guards():
         stmt = tilelang.transform.VectorizeLoop()(mod)["main"].body
 
         # Check that the loop wasn't vectorised
@@ -258,7 +262,7 @@ def test_vectorize_if_then_else_scalarize(extent, target):
             for i_s in range(extent):
                 A[i_s] = T.if_then_else(i_s > 0, A[i_s] + T.float32(1), A[i_s])
 
-    with tvm.target.Target(target):
+    with tvm.target.Target(target), scalarize_guards():
         mod = tilelang.transform.VectorizeLoop()(Before)
         tvm.ir.assert_structural_equal(mod, After)
 
@@ -291,6 +295,124 @@ def test_vectorize_if_then_else_vector(extent, target):
         tvm.ir.assert_structural_equal(mod, After)
 
 
+def vectorize_guarded_store(target):
+
+    @I.ir_module
+    class Module:
+
+        @T.prim_func
+        def main(A: T.Tensor((25,), "float32"), B: T.Tensor((25,), "float32"), n: T.int32):
+            for i in range(7):
+                for j in T.vectorized(4):
+                    if i * 4 + j < n:
+                        A[i * 4 + j] = B[i * 4 + j] + T.float32(1)
+
+    with tvm.target.Target(target):
+        return tilelang.transform.VectorizeLoop()(Module)["main"].body.body
+
+
+@tilelang.testing.requires_llvm
+def test_vectorize_guarded_store_masked_tail():
+    stmt = vectorize_guarded_store(simple_target)
+    # Full vectors where the guard holds for all four lanes
+    assert isinstance(stmt, tvm.tir.IfThenElse)
+    full, tail = stmt.then_case, stmt.else_case
+    assert isinstance(full, tvm.tir.BufferStore) and full.predicate is None
+    assert isinstance(full.indices[0], tvm.tir.Ramp)
+    # and masked vectors on the edge tile
+    assert isinstance(tail, tvm.tir.BufferStore) and tail.predicate is not None
+    assert isinstance(tail.indices[0], tvm.tir.Ramp)
+    assert tail.value.a.predicate is not None
+
+
+def test_vectorize_guarded_store_lane_tail():
+    # Targets without predicated vector memory access keep a per-lane tail
+    stmt = vectorize_guarded_store(tvm.target.Target("cuda"))
+    assert isinstance(stmt, tvm.tir.IfThenElse)
+    assert isinstance(stmt.then_case, tvm.tir.BufferStore)
+    assert isinstance(stmt.else_case, tvm.tir.For)
+    assert isinstance(stmt.else_case.body, tvm.tir.IfThenElse)
+
+
+@tilelang.testing.requires_llvm
+def test_vectorize_let_guarded_store():
+
+    @I.ir_module
+    class Module:
+
+        @T.prim_func
+        def main(A: T.Tensor((25,), "float32"), B: T.Tensor((25,), "float32"), n: T.int32):
+            for i in range(7):
+                for j in T.vectorized(4):
+                    x: T.int32 = i * 4 + j
+                    if x < n:
+                        A[x] = B[x] + T.float32(1)
+
+    with tvm.target.Target(simple_target):
+        stmt = tilelang.transform.VectorizeLoop()(Module)["main"].body.body
+    # x is rebound to a vector, the version guard reads its scalar value instead
+    assert isinstance(stmt, tvm.tir.LetStmt) and stmt.var.dtype == "int32x4"
+    guard = stmt.body
+    assert isinstance(guard, tvm.tir.IfThenElse)
+    names = set()
+    tvm.tir.stmt_functor.post_order_visit(
+        guard.condition, lambda node: names.add(node.name)
+        if isinstance(node, tvm.tir.Var) else None)
+    assert names == {"i", "n"}
+
+
+@tilelang.testing.requires_llvm
+def test_vectorize_strided_guarded_store_lane_tail():
+
+    @I.ir_module
+    class Module:
+
+        @T.prim_func
+        def main(A: T.Tensor((50,), "float32"), B: T.Tensor((25,), "float32"), n: T.int32):
+            for i in range(7):
+                for j in T.vectorized(4):
+                    if i * 4 + j < n:
+                        A[(i * 4 + j) * 2] = B[i * 4 + j]
+
+    with tvm.target.Target(simple_target):
+        stmt = tilelang.transform.VectorizeLoop()(Module)["main"].body.body
+    assert isinstance(stmt, tvm.tir.IfThenElse)
+    # A strided store has no masked form, the edge tile keeps the guard per lane
+    assert isinstance(stmt.else_case, tvm.tir.For)
+    assert isinstance(stmt.else_case.body, tvm.tir.IfThenElse)
+
+
+@tilelang.testing.requires_llvm
+def test_vectorize_if_then_else_masked_tail():
+
+    @I.ir_module
+    class Module:
+
+        @T.prim_func
+        def main(A: T.Tensor((25,), "float32"), B: T.Tensor((25,), "float32"), n: T.int32):
+            for i in range(7):
+                for j in T.vectorized(4):
+                    A[i * 4 + j] = T.if_then_else(i * 4 + j < n, B[i * 4 + j], T.float32(0))
+
+    with tvm.target.Target(simple_target):
+        stmt = tilelang.transform.VectorizeLoop()(Module)["main"].body.body
+    assert isinstance(stmt, tvm.tir.IfThenElse)
+    # The guard folds away on full vectors
+    assert isinstance(stmt.then_case.value, tvm.tir.BufferLoad)
+    assert stmt.then_case.value.predicate is None
+    # and selects between masked loads and the default on the edge
+    select = stmt.else_case.value
+    assert isinstance(select, tvm.tir.Select)
+    assert select.true_value.predicate is not None
+
+
+@tilelang.testing.requires_llvm
+def test_vectorize_guarded_store_scalarize_config():
+    with scalarize_guards():
+        stmt = vectorize_guarded_store(simple_target)
+    assert isinstance(stmt, tvm.tir.For)
+
+
 @tilelang.testing.requires_llvm
 def test_vectorize_while_fail():
     """A while loop inside a vectorized loop should fail."""
@@ -55,5 +55,100 @@ def test_gemm_codegen():
     assert_gemm_codegen(1024, 1024, 1024, 16, 16, 16)
 
 
+def test_gemm_workgroup_memory_merged():
+    func = matmul(1024, 1024, 1024, 16, 16, 16)
+    src_code = tilelang.lower(func, target="webgpu").kernel_source
+    # A_shared and B_shared share one typed workgroup array
+    assert src_code.count("var<workgroup>") == 1, src_code
+    assert "array<f16" in src_code, src_code
+    assert "array<u8" not in src_code, src_code
+
+
+def elementwise_add(M, N, block_M, block_N, dtype="float32"):
+
+    @T.prim_func
+    def main(
+            A: T.Tensor((M, N), dtype),
+            B: T.Tensor((M, N), dtype),
+            C: T.Tensor((M, N), dtype),
+    ):
+        with T.Kernel(T.ceildiv(N, block_N), T.ceildiv(M, block_M), threads=128) as (bx, by):
+            for i, j in T.Parallel(block_M, block_N):
+                C[by * block_M + i, bx * block_N + j] = A[by * block_M + i, bx * block_N +
+                                                          j] + B[by * block_M + i, bx * block_N + j]
+
+    return main
+
+
+def test_elementwise_vectorized_storage():
+    func = elementwise_add(1024, 1024, 32, 32)
+    src_code = tilelang.lower(func, target="webgpu").kernel_source
+    assert "array<vec4<f32>>" in src_code, src_code
+
+
+def row_max(M, N, block_M, dtype="float32"):
+
+    @T.prim_func
+    def main(A: T.Tensor((M, N), dtype), B: T.Tensor((M,), dtype)):
+        with T.Kernel(T.ceildiv(M, block_M), threads=128) as bx:
+            A_local = T.alloc_fragment((block_M, N), dtype)
+            B_local = T.alloc_fragment((block_M,), dtype)
+            T.copy(A[bx * block_M, 0], A_local)
+            T.reduce_max(A_local, B_local, dim=1)
+            T.copy(B_local, B[bx * block_M])
+
+    return main
+
+
+def test_reduce_through_workgroup_memory():
+    func = row_max(1024, 64, 32)
+    src_code = tilelang.lower(func, target="webgpu").kernel_source
+    # Without subgroups, threads exchange partial results in workgroup memory
+    assert "AllReduce" not in src_code, src_code
+    assert "subgroup" not in src_code, src_code
+    assert "var<workgroup>" in src_code, src_code
+    assert "workgroupBarrier()" in src_code, src_code
+    assert "^" in src_code, src_code
+
+
+def test_reduce_with_subgroups():
+    func = row_max(1024, 64, 32)
+    target = tvm.target.Target({
+        "kind": "webgpu",
+        "supports_subgroups": True,
+        "thread_warp_size": 32,
+    })
+    src_code = tilelang.lower(func, target=target).kernel_source
+    assert "enable subgroups;" in src_code, src_code
+    assert "subgroupShuffleXor(" in src_code, src_code
+    assert "workgroupBarrier()" not in src_code, src_code
+
+
+def gather_scale(N, block_N):
+
+    @T.prim_func
+    def main(A: T.Tensor((N,), "float32"), B: T.Tensor((N,), "int32"), C: T.Tensor(
+        (N,), "float32")):
+        with T.Kernel(T.ceildiv(N, block_N), threads=128) as bx:
+            A_shared = T.alloc_shared((block_N,), "float32")
+            B_shared = T.alloc_shared((block_N,), "int32")
+            T.copy(A[bx * block_N], A_shared)
+            T.copy(B[bx * block_N], B_shared)
+            for i in T.Parallel(block_N):
+                C[bx * block_N + i] = A_shared[i] * B_shared[i]
+
+    return main
+
+
+def test_mixed_32bit_workgroup_memory_as_u32():
+    func = gather_scale(1024, 128)
+    src_code = tilelang.lower(func, target="webgpu").kernel_source
+    # f32 and i32 tiles share one u32 array, accessed through bitcasts
+    assert src_code.count("var<workgroup>") == 1, src_code
+    assert "array<u32" in src_code, src_code
+    assert "bitcast<f32>" in src_code or "bitcast<vec" in src_code, src_code
+    assert "array<u8" not in src_code, src_code
+
+
 if __name__ == "__main__":
     tilelang.testing.main()
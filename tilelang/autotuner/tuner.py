@@ -35,6 +35,7 @@ from tilelang.env import (
 from tilelang.autotuner.param import CompileArgs, ProfileArgs, AutotuneResult
 from tilelang.autotuner.capture import get_autotune_inputs
 from tilelang.jit.param import _P, _RProg
+from tilelang.jit.symbolic import SymbolicProgramCache
 from tilelang.version import __version__
 
 
@@ -109,6 +110,7 @@ class AutoTuner:
     profile_args = ProfileArgs()
 
     _kernel_parameters: Optional[Tuple[str, ...]] = None
+    symbolic_params: Optional[Tuple[str, ...]] = None
     _lock = threading.Lock()  # For thread safety
     _memory_cache = {}  # In-memory cache dictionary
     cache_dir: Path = Path(TILELANG_CACHE_DIR) / "autotuner"
@@ -227,6 +229,22 @@ class AutoTuner:
 
         return self
 
+    def set_symbolic_params(self, symbolic_params: Optional[List[str]] = None):
+        """Parse the program once with the given tuning parameters as symbolic
+        placeholders and derive each configuration by binding them.
+
+        Args:
+            symbolic_params: Names of the integer tuning parameters that are only
+                used as TIR values (tile sizes, loop extents). Parameters the
+                program inspects at Python level fall back to one parse per
+                configuration.
+
+        Returns:
+            AutoTuner: Self for method chaining.
+        """
+        self.symbolic_params = tuple(symbolic_params) if symbolic_params else None
+        return self
+
     def set_kernel_parameters(self, parameters: Tuple[str, ...]):
         # for cache key generation
         self._kernel_parameters = parameters
@@ -303,9 +321,13 @@ class AutoTuner:
         best_config: Optional[Dict[str, Any]] = None
         best_kernel: Optional[tilelang.JITKernel] = None
 
+        program_factory = self.fn
+        if self.symbolic_params:
+            program_factory = SymbolicProgramCache(self.fn, self.symbolic_params)
+
         def _compile(**config_arg) -> tilelang.JITKernel:
             compile_args = self.compile_args
-            return compile_args.compile_program(self.fn(**config_arg))
+            return compile_args.compile_program(program_factory(**config_arg))
 
         if self.jit_compile is None:
             self.jit_compile = _compile
@@ -576,6 +598,7 @@ class _AutoTunerImplementation:
     skip_check: bool = False
     manual_check_prog: Callable = None
     cache_input_tensors: bool = False
+    symbolic_params: Optional[List[str]] = None
 
     def __init__(self,
                  configs: Union[Dict, Callable],
@@ -590,7 +613,8 @@ class _AutoTunerImplementation:
                  max_mismatched_ratio: float = 0.01,
                  skip_check: bool = False,
                  manual_check_prog: Callable = None,
-                 cache_input_tensors: bool = False) -> None:
+                 cache_input_tensors: bool = False,
+                 symbolic_params: Optional[List[str]] = None) -> None:
         """Initialize the AutoTunerImplementation.
 
         Args:
@@ -607,6 +631,7 @@ class _AutoTunerImplementation:
             skip_check: Bypass validation against reference implementation
             manual_check_prog: Custom validation function
             cache_input_tensors: Reuse input tensors across trials
+            symbolic_params: Tuning parameters parsed once as symbolic placeholders
         """
         # Configuration and benchmarking parameters
         self.configs = configs  # Search space of tuning configurations
@@ -626,6 +651,7 @@ class _AutoTunerImplementation:
         self.skip_check = skip_check  # Bypass accuracy verification
         self.manual_check_prog = manual_check_prog  # Custom validation
         self.cache_input_tensors = cache_input_tensors  # Reuse inputs
+        self.symbolic_params = symbolic_params  # Parsed once as placeholders
 
         # Cache for storing tuned kernel implementations
         self._tuner_cache: Dict[tuple, tilelang.JITKernel] = {}  # (args, kwargs) -> compiled kernel
@@ -656,7 +682,11 @@ class _AutoTunerImplementation:
             if key not in self._tuner_cache:
 
                 def jit_compile(**config_arg):
-                    return fn(*args, **kwargs, __tune_params=config_arg)
+                    return fn(
+                        *args,
+                        **kwargs,
+                        __tune_params=config_arg,
+                        __symbolic_params=self.symbolic_params)
 
                 compile_arguments = fn(__return_compile_arguments=True)
 
@@ -712,6 +742,7 @@ def autotune(  # This is the new public interface
     skip_check: bool = False,
     manual_check_prog: Callable = None,
     cache_input_tensors: bool = False,
+    symbolic_params: Optional[List[str]] = None,
 ):
     """
     Just-In-Time (JIT) compiler decorator for TileLang functions.
@@ -754,6 +785,12 @@ def autotune(  # This is the new public interface
         Configurations for TVM's pass context. Defaults to None.
     debug_root_path : Optional[str], optional
         Directory to save compiled kernel source for debugging. Defaults to None.
+    symbolic_params : Optional[List[str]], optional
+        Integer tuning parameters (e.g. ``["block_M", "block_N", "block_K"]``) that
+        are parsed once as symbolic placeholders; each configuration binds them
+        to constants instead of re-running the TVMScript parser. Parameters used
+        in Python-level control flow, ``T.Pipelined(num_stages=...)`` or
+        ``T.Kernel(threads=...)`` must stay concrete. Defaults to None.
 
     Returns
     -------
@@ -786,5 +823,6 @@ def autotune(  # This is the new public interface
             skip_check=skip_check,
             manual_check_prog=manual_check_prog,
             cache_input_tensors=cache_input_tensors,
+            symbolic_params=symbolic_params,
         )
         return configured_decorator
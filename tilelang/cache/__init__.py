@@ -6,6 +6,10 @@ from tvm.target import Target
 from tvm.tir import PrimFunc
 from tilelang.jit import JITKernel
 from .kernel_cache import KernelCache
+from .compile_daemon import (  # noqa: F401
+    start_compile_daemon, stop_compile_daemon, enable_compile_daemon, disable_compile_daemon,
+    compile_daemon_stats,
+)
 from tilelang.env import TILELANG_CLEAR_CACHE
 
 # Create singleton instance of KernelCache
@@ -37,6 +41,35 @@ def cached(
     )
 
 
+def cross_compile(
+    func: PrimFunc = None,
+    out_idx: List[int] = None,
+    *args,
+    target: Union[str, Target],
+    target_host: Union[str, Target] = None,
+    execution_backend: Optional[Literal["ctypes", "cython"]] = "cython",
+    pass_configs: Optional[dict] = None,
+    compile_device: Optional[bool] = False,
+) -> str:
+    """
+    Generates a CUDA or HIP kernel into the disk cache on a host without a GPU
+    (using KernelCache class). GPU nodes calling `cached` with the same arguments
+    load it from the shared cache directory.
+    Example:
+        >>> tilelang.cache.cross_compile(func, [2], target="cuda -arch=sm_90")
+    """
+    return _kernel_cache_instance.cross_compile(
+        func,
+        out_idx,
+        *args,
+        target=target,
+        target_host=target_host,
+        execution_backend=execution_backend,
+        pass_configs=pass_configs,
+        compile_device=compile_device,
+    )
+
+
 def get_cache_dir() -> Path:
     """
     Gets the cache directory for the kernel cache.
@@ -0,0 +1,280 @@
+"""Node-local compile daemon shared by the processes of a job.
+
+In multi-rank jobs every rank compiles the same kernels, and KernelCache only
+deduplicates within one process, so a node builds each kernel once per rank.
+The daemon serves compile requests from all processes over a Unix socket:
+
+    - in-flight requests with the same cache key are built once, every
+      requester waits for that build;
+    - builds run on a bounded worker pool;
+    - artifacts are published to the shared disk cache, from which the
+      requesting processes then load the kernel.
+
+Start one daemon per node, either from a shell
+
+    python -m tilelang.cache.compile_daemon [--socket PATH] [--workers N]
+
+or with `tilelang.cache.start_compile_daemon()`, and set
+TILELANG_COMPILE_DAEMON=1 in the ranks (or call `enable_compile_daemon()`).
+A process that cannot reach the daemon compiles in process as before.
+
+Requests are pickled, so the socket is created accessible to its owner only.
+"""
+
+import argparse
+import concurrent.futures
+import logging
+import os
+import pickle
+import socket
+import socketserver
+import struct
+import subprocess
+import sys
+import threading
+import time
+from typing import Any, Dict, Optional
+
+from tilelang.env import (
+    TILELANG_CACHE_DIR,
+    TILELANG_COMPILE_DAEMON,
+    TILELANG_COMPILE_DAEMON_SOCKET,
+)
+
+logger = logging.getLogger(__name__)
+
+_HEADER = struct.Struct("!Q")
+
+
+class _ClientState:
+    """Whether cache misses of this process are sent to the daemon."""
+    socket_path: Optional[str] = (
+        TILELANG_COMPILE_DAEMON_SOCKET
+        if TILELANG_COMPILE_DAEMON.lower() in ("1", "true", "yes", "on") else None)
+    # Set in the daemon process, whose own builds must not call back into it
+    serving: bool = False
+
+
+def enable_compile_daemon(socket_path: Optional[str] = None):
+    """Send kernel cache misses of this process to the daemon at `socket_path`."""
+    _ClientState.socket_path = socket_path or TILELANG_COMPILE_DAEMON_SOCKET
+
+
+def disable_compile_daemon():
+    """Compile kernel cache misses of this process in process."""
+    _ClientState.socket_path = None
+
+
+def is_compile_daemon_enabled() -> bool:
+    return _ClientState.socket_path is not None and not _ClientState.serving
+
+
+def _send(sock: socket.socket, message: Dict[str, Any]):
+    data = pickle.dumps(message)
+    sock.sendall(_HEADER.pack(len(data)) + data)
+
+
+def _recv_exact(sock: socket.socket, size: int) -> bytes:
+    data = bytearray()
+    while len(data) < size:
+        chunk = sock.recv(size - len(data))
+        if not chunk:
+            raise ConnectionError("compile daemon connection closed")
+        data += chunk
+    return bytes(data)
+
+
+def _recv(sock: socket.socket) -> Dict[str, Any]:
+    (size,) = _HEADER.unpack(_recv_exact(sock, _HEADER.size))
+    return pickle.loads(_recv_exact(sock, size))
+
+
+def _request(message: Dict[str, Any], socket_path: Optional[str] = None) -> Dict[str, Any]:
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock:
+        sock.connect(socket_path or _ClientState.socket_path)
+        _send(sock, message)
+        return _recv(sock)
+
+
+def request_build(key: str, cache_dir: str, **compile_args) -> bool:
+    """Ask the daemon to publish kernel `key` into the disk cache at `cache_dir`.
+
+    Blocks until the kernel is on disk. Returns False if the daemon cannot be
+    reached or the build failed, in which case the caller compiles in process.
+    """
+    try:
+        response = _request({
+            "op": "build",
+            "key": key,
+            "cache_dir": str(cache_dir),
+            **compile_args
+        })
+    except (OSError, ConnectionError, pickle.PickleError) as e:
+        logger.debug(f"Compile daemon unavailable, compiling in process: {e}")
+        return False
+    if response["status"] != "ok":
+        logger.warning(f"Compile daemon failed to build kernel {key}, compiling in process: "
+                       f"{response['message']}")
+        return False
+    return True
+
+
+def compile_daemon_stats(socket_path: Optional[str] = None) -> Dict[str, int]:
+    """Number of builds run and of requests served by an in-flight build."""
+    return _request({"op": "stats"}, socket_path)["stats"]
+
+
+def stop_compile_daemon(socket_path: Optional[str] = None):
+    _request({"op": "stop"}, socket_path or TILELANG_COMPILE_DAEMON_SOCKET)
+
+
+class CompileDaemon:
+    """Deduplicating compile server publishing into the kernel disk cache."""
+
+    def __init__(self, socket_path: str, num_workers: int, cache_dir: str = TILELANG_CACHE_DIR):
+        self.socket_path = socket_path
+        self.cache_dir = os.path.abspath(cache_dir)
+        self._pool = concurrent.futures.ThreadPoolExecutor(max_workers=num_workers)
+        self._in_flight: Dict[str, concurrent.futures.Future] = {}
+        self._lock = threading.Lock()
+        self._stats = {"builds": 0, "deduplicated": 0}
+        self._server: Optional[socketserver.ThreadingUnixStreamServer] = None
+
+    def submit(self, request: Dict[str, Any]) -> concurrent.futures.Future:
+        key = request["key"]
+        with self._lock:
+            future = self._in_flight.get(key)
+            if future is not None:
+                self._stats["deduplicated"] += 1
+                return future
+            self._stats["builds"] += 1
+            future = self._pool.submit(self._build, request)
+            self._in_flight[key] = future
+        future.add_done_callback(lambda _: self._finish(key))
+        return future
+
+    def _finish(self, key: str):
+        with self._lock:
+            self._in_flight.pop(key, None)
+
+    def _build(self, request: Dict[str, Any]):
+        from tilelang.cache import _kernel_cache_instance
+        _kernel_cache_instance.publish(
+            request["key"],
+            request["func"],
+            out_idx=request["out_idx"],
+            target=request["target"],
+            target_host=request["target_host"],
+            execution_backend=request["execution_backend"],
+            verbose=request["verbose"],
+            pass_configs=request["pass_configs"],
+        )
+
+    def handle(self, request: Dict[str, Any]) -> Dict[str, Any]:
+        op = request.get("op")
+        if op == "stats":
+            with self._lock:
+                return {"status": "ok", "stats": dict(self._stats)}
+        if op == "stop":
+            threading.Thread(target=self._server.shutdown, daemon=True).start()
+            return {"status": "ok"}
+        if op != "build":
+            return {"status": "error", "message": f"unknown request {op}"}
+        if os.path.abspath(request["cache_dir"]) != self.cache_dir:
+            return {
+                "status": "error",
+                "message": f"daemon publishes to {self.cache_dir}, not {request['cache_dir']}"
+            }
+        try:
+            self.submit(request).result()
+        except Exception as e:  # noqa: BLE001
+            return {"status": "error", "message": f"{type(e).__name__}: {e}"}
+        return {"status": "ok"}
+
+    def serve_forever(self):
+        if os.path.exists(self.socket_path):
+            try:
+                _request({"op": "stats"}, self.socket_path)
+            except (OSError, ConnectionError):
+                os.unlink(self.socket_path)  # left behind by a daemon that died
+            else:
+                raise RuntimeError(f"A compile daemon is already serving {self.socket_path}")
+        os.makedirs(os.path.dirname(os.path.abspath(self.socket_path)), exist_ok=True)
+
+        daemon = self
+
+        class Handler(socketserver.BaseRequestHandler):
+
+            def handle(self):
+                try:
+                    request = _recv(self.request)
+                except (OSError, ConnectionError, pickle.PickleError) as e:
+                    logger.debug(f"Dropping malformed compile request: {e}")
+                    return
+                _send(self.request, daemon.handle(request))
+
+        old_umask = os.umask(0o177)
+        try:
+            self._server = socketserver.ThreadingUnixStreamServer(self.socket_path, Handler)
+        finally:
+            os.umask(old_umask)
+        self._server.daemon_threads = True
+        logger.info(f"Compile daemon serving {self.socket_path}, publishing to {self.cache_dir}")
+        try:
+            self._server.serve_forever()
+        finally:
+            self._server.server_close()
+            self._pool.shutdown(wait=True)
+            if os.path.exists(self.socket_path):
+                os.unlink(self.socket_path)
+
+
+def start_compile_daemon(socket_path: Optional[str] = None,
+                         num_workers: Optional[int] = None,
+                         cache_dir: Optional[str] = None,
+                         timeout: float = 60.0) -> Optional[subprocess.Popen]:
+    """Start a compile daemon in the background unless one is already serving.
+
+    Returns the daemon process, or None if a daemon was already running.
+    """
+    socket_path = socket_path or TILELANG_COMPILE_DAEMON_SOCKET
+    try:
+        _request({"op": "stats"}, socket_path)
+        return None
+    except (OSError, ConnectionError):
+        pass
+    command = [sys.executable, "-m", "tilelang.cache.compile_daemon", "--socket", socket_path]
+    if num_workers is not None:
+        command += ["--workers", str(num_workers)]
+    if cache_dir is not None:
+        command += ["--cache-dir", str(cache_dir)]
+    process = subprocess.Popen(command, start_new_session=True)
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        if process.poll() is not None:
+            raise RuntimeError(f"Compile daemon exited with code {process.returncode}")
+        try:
+            _request({"op": "stats"}, socket_path)
+            return process
+        except (OSError, ConnectionError):
+            time.sleep(0.1)
+    process.kill()
+    raise TimeoutError(f"Compile daemon did not start serving {socket_path} in {timeout}s")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="TileLang node-local compile daemon")
+    parser.add_argument("--socket", default=TILELANG_COMPILE_DAEMON_SOCKET)
+    parser.add_argument("--workers", type=int, default=os.cpu_count() or 1)
+    parser.add_argument("--cache-dir", default=TILELANG_CACHE_DIR)
+    args = parser.parse_args()
+    logging.basicConfig(level=logging.INFO)
+    # Run as __main__, this module is not the one the kernel cache consults
+    from tilelang.cache import compile_daemon, set_cache_dir
+    compile_daemon._ClientState.serving = True
+    set_cache_dir(args.cache_dir)
+    CompileDaemon(args.socket, max(1, args.workers), args.cache_dir).serve_forever()
+
+
+if __name__ == "__main__":
+    main()
@@ -13,9 +13,15 @@ import cloudpickle
 from tvm.target import Target
 from tvm.tir import PrimFunc
 
+import tilelang
+from tilelang import tvm as tvm
+from tilelang.cache import compile_daemon
 from tilelang.engine.param import KernelParam
 from tilelang.env import TILELANG_CACHE_DIR, is_cache_enabled
 from tilelang.jit import JITKernel
+from tilelang.jit.adapter.libgen import LibraryGenerator
+from tilelang.jit.adapter.wrapper import TLWrapper
+from tilelang.utils.target import determine_target
 from tilelang.version import __version__
 
 KERNEL_PATH = "kernel.cu"
@@ -39,7 +45,6 @@ class KernelCache:
     _instance = None  # For implementing singleton pattern
     _lock = threading.Lock()  # For thread safety
     _memory_cache = {}  # In-memory cache dictionary
-    execution_backend: Literal["dlpack", "ctypes", "cython", "nvrtc"] = "cython"
 
     cache_dir: Path = Path(TILELANG_CACHE_DIR)
 
@@ -90,7 +95,6 @@ class KernelCache:
         Returns:
             str: SHA256 hash key for the kernel configuration.
         """
-        self.execution_backend = execution_backend
         func_binary = cloudpickle.dumps(func.script(show_meta=True))
         key_data = {
             "version": __version__,
@@ -160,6 +164,11 @@ class KernelCache:
                                     " consider using `@tilelang.jit` instead of direct kernel caching.")
                 return self._memory_cache[key]
 
+        # Cross-compiled kernels may come without the library. Build it outside the
+        # critical section, it is published by an atomic rename.
+        self._build_deferred_library(key, target, execution_backend, pass_configs)
+
+        with self._lock:
             if verbose:
                 self.logger.debug(f"Checking disk cache for kernel {func.attrs['global_symbol']}")
 
@@ -174,7 +183,140 @@ class KernelCache:
                 self._memory_cache[key] = kernel
                 return kernel
 
-        # Compile kernel if cache miss; leave critical section
+        # Compile kernel if cache miss; leave critical section.
+        # Processes sharing a compile daemon build each kernel once per node.
+        if execution_backend != "dlpack" and compile_daemon.is_compile_daemon_enabled():
+            built = compile_daemon.request_build(
+                key,
+                self.cache_dir,
+                func=func,
+                out_idx=out_idx,
+                target=str(target),
+                target_host=str(target_host) if target_host else None,
+                execution_backend=execution_backend,
+                verbose=verbose,
+                pass_configs=pass_configs,
+            )
+            if built:
+                with self._lock:
+                    kernel = self._load_kernel_from_disk(key, target, target_host, out_idx,
+                                                         execution_backend, pass_configs, func)
+                if kernel is not None:
+                    self._memory_cache[key] = kernel
+                    return kernel
+
+        kernel = self._compile_and_save(key, func, out_idx, target, target_host,
+                                        execution_backend, verbose, pass_configs)
+
+        # Store in memory cache after compilation
+        self._memory_cache[key] = kernel
+        return kernel
+
+    def publish(
+        self,
+        key: str,
+        func: PrimFunc,
+        out_idx: List[int] = None,
+        target: Union[str, Target] = "auto",
+        target_host: Union[str, Target] = None,
+        execution_backend: Literal["dlpack", "ctypes", "cython", "nvrtc"] = "cython",
+        verbose: bool = False,
+        pass_configs: dict = None,
+    ):
+        """
+        Compiles a kernel into the disk cache under `key` unless it is already there,
+        without keeping it in memory. Used by the compile daemon.
+        """
+        if os.path.exists(self._get_cache_path(key)):
+            return
+        self._compile_and_save(key, func, out_idx, target, target_host, execution_backend,
+                               verbose, pass_configs)
+
+    def cross_compile(
+        self,
+        func: PrimFunc,
+        out_idx: List[int] = None,
+        *args,
+        target: Union[str, Target],
+        target_host: Union[str, Target] = None,
+        execution_backend: Literal["ctypes", "cython"] = "cython",
+        pass_configs: dict = None,
+        compile_device: bool = False,
+    ) -> str:
+        """
+        Generates a CUDA or HIP kernel into the disk cache on a host without a GPU.
+
+        The kernel source, host wrapper and parameters are stored under the key that
+        `cached` computes for the same arguments, so GPU nodes sharing the cache directory
+        load the kernel instead of lowering it. The device library is built here only if
+        `compile_device` is set (which needs nvcc or hipcc, but no driver); otherwise the
+        first GPU node that loads the kernel builds it from the cached wrapper.
+
+        Args:
+            func: The PrimFunc to compile
+            out_idx: Indices specifying which outputs to return
+            *args: Arguments passed to func, as given to `cached`
+            target: An explicit target such as "cuda -arch=sm_90" or "hip -mcpu=gfx942",
+                the same value the GPU nodes pass to `cached`
+            target_host: Host target platform
+            execution_backend: The backend the GPU nodes run the kernel with
+            pass_configs: Configuration for compiler passes
+            compile_device: Whether to build the device library on this host as well
+
+        Returns:
+            str: The cache key of the kernel
+        """
+        if target == "auto":
+            raise ValueError("Cross-compilation needs an explicit target, "
+                             "e.g. 'cuda -arch=sm_90' or 'hip -mcpu=gfx942'.")
+        assert execution_backend in ("ctypes", "cython"), \
+            f"Cross-compilation does not support the {execution_backend} backend"
+        device_target = Target(determine_target(target))
+        if device_target.kind.name not in ("cuda", "hip"):
+            raise ValueError(f"Cross-compilation targets CUDA or HIP, got {target}")
+        if device_target.kind.name == "cuda" and not device_target.arch:
+            raise ValueError(f"Cross-compilation needs the architecture, e.g. "
+                             f"'{target} -arch=sm_90'")
+
+        key = self._generate_key(
+            func=func,
+            out_idx=out_idx,
+            execution_backend=execution_backend,
+            args=args,
+            target=target,
+            target_host=target_host,
+            pass_configs=pass_configs,
+        )
+        if os.path.exists(self._get_cache_path(key)):
+            return key
+
+        pass_configs = pass_configs or {}
+        with tvm.transform.PassContext(opt_level=3, config=pass_configs):
+            artifact = tilelang.lower(func, target=device_target, target_host=target_host)
+        artifact.check_outputs(out_idx)
+
+        wrapper = TLWrapper(device_target)
+        wrapper.assign_optimized_module(tvm.IRModule({func.attrs["global_symbol"]: func}))
+        wrapper.assign_pass_configs(pass_configs)
+        wrapper.assign_host_module(artifact.host_mod)
+        wrapper.assign_device_module(artifact.device_mod)
+        wrapped_source = wrapper.wrap(artifact.kernel_source)
+
+        lib_path = None
+        if compile_device:
+            lib_generator = LibraryGenerator(device_target)
+            lib_generator.assign_pass_configs(pass_configs)
+            lib_generator.update_lib_code(wrapped_source)
+            lib_generator.compile_lib()
+            lib_path = lib_generator.libpath
+
+        with self._lock:
+            self._write_kernel_files(key, artifact.kernel_source, wrapped_source, lib_path,
+                                     artifact.params, execution_backend)
+        return key
+
+    def _compile_and_save(self, key, func, out_idx, target, target_host, execution_backend,
+                          verbose, pass_configs) -> JITKernel:
         kernel = JITKernel(
             func,
             out_idx=out_idx,
@@ -189,10 +331,7 @@ class KernelCache:
         else:
             with self._lock:
                 if is_cache_enabled():
-                    self._save_kernel_to_disk(key, kernel, func)
-
-        # Store in memory cache after compilation
-        self._memory_cache[key] = kernel
+                    self._save_kernel_to_disk(key, kernel, func, execution_backend)
         return kernel
 
     def set_cache_dir(self, cache_dir: str):
@@ -227,7 +366,13 @@ class KernelCache:
         """
         return os.path.join(self.cache_dir, key)
 
-    def _save_kernel_to_disk(self, key: str, kernel: JITKernel, func: Callable = None):
+    def _save_kernel_to_disk(
+        self,
+        key: str,
+        kernel: JITKernel,
+        func: Callable = None,
+        execution_backend: Literal["ctypes", "cython", "nvrtc"] = "cython",
+    ):
         """
         Persists a compiled kernel to disk cache.
 
@@ -235,6 +380,7 @@ class KernelCache:
             key (str): The hash key identifying the kernel.
             kernel (JITKernel): The compiled kernel to be saved.
             func (Callable, optional): The original function.
+            execution_backend (Literal): Backend the kernel was compiled for.
 
         Note:
             Saves the following files:
@@ -242,16 +388,34 @@ class KernelCache:
             - wrapped_kernel.cu: The wrapped kernel source code
             - kernel_lib.so: The compiled kernel library
             - params.pkl: The serialized kernel parameters
+
+            The files are written to a staging directory that is renamed into place, so
+            other processes sharing the cache never load a partially written kernel.
         """
-        cache_path = self._get_cache_path(key)
+        self._write_kernel_files(key, kernel.artifact.kernel_source,
+                                 kernel.adapter.get_kernel_source(),
+                                 getattr(kernel.adapter, "libpath", None), kernel.params,
+                                 execution_backend)
+
+    def _write_kernel_files(self, key: str, kernel_source: Optional[str], wrapped_source: str,
+                            lib_path: Optional[str], params: List[KernelParam],
+                            execution_backend: Literal["ctypes", "cython", "nvrtc"]):
+        """
+        Writes the files of a kernel to the disk cache, see `_save_kernel_to_disk`.
+        The library is left out if `lib_path` is None.
+        """
+        published_path = self._get_cache_path(key)
+        if os.path.exists(published_path):
+            return
+        cache_path = f"{published_path}.tmp.{os.getpid()}.{threading.get_ident()}"
         os.makedirs(cache_path, exist_ok=True)  # Ensure directory exists
 
         # Save kernel source code
         try:
             kernel_path = os.path.join(cache_path, KERNEL_PATH)
-            if kernel.artifact.kernel_source is not None:
+            if kernel_source is not None:
                 with open(kernel_path, "w") as f:
-                    f.write(kernel.artifact.kernel_source)
+                    f.write(kernel_source)
         except Exception as e:
             self.logger.error(f"Error saving kernel source code to disk: {e}")
 
@@ -259,21 +423,21 @@ class KernelCache:
         try:
             wrapped_kernel_path = os.path.join(cache_path, WRAPPED_KERNEL_PATH)
             with open(wrapped_kernel_path, "w") as f:
-                f.write(kernel.adapter.get_kernel_source())
+                f.write(wrapped_source)
         except Exception as e:
             self.logger.error(f"Error saving wrapped kernel source code to disk: {e}")
 
         # Save kernel library
         try:
-            if self.execution_backend == "nvrtc":
-                kernel_lib_path = os.path.join(cache_path, KERNEL_CUBIN_PATH)
-            else:
-                kernel_lib_path = os.path.join(cache_path, KERNEL_LIB_PATH)
-            src_lib_path = kernel.adapter.libpath
-            shutil.copy(src_lib_path, kernel_lib_path)
-            if self.execution_backend == "nvrtc":
-                shutil.copy(
-                    src_lib_path.replace(".cubin", ".py"), os.path.join(cache_path, KERNEL_PY_PATH))
+            if lib_path is not None:
+                if execution_backend == "nvrtc":
+                    kernel_lib_path = os.path.join(cache_path, KERNEL_CUBIN_PATH)
+                else:
+                    kernel_lib_path = os.path.join(cache_path, KERNEL_LIB_PATH)
+                shutil.copy(lib_path, kernel_lib_path)
+                if execution_backend == "nvrtc":
+                    shutil.copy(
+                        lib_path.replace(".cubin", ".py"), os.path.join(cache_path, KERNEL_PY_PATH))
         except Exception as e:
             self.logger.error(f"Error saving kernel library to disk: {e}")
 
@@ -281,10 +445,16 @@ class KernelCache:
         try:
             params_path = os.path.join(cache_path, PARAMS_PATH)
             with open(params_path, "wb") as f:
-                cloudpickle.dump(kernel.params, f)
+                cloudpickle.dump(params, f)
         except Exception as e:
             self.logger.error(f"Error saving kernel parameters to disk: {e}")
 
+        try:
+            os.rename(cache_path, published_path)
+        except OSError:
+            # Published concurrently by another process
+            shutil.rmtree(cache_path, ignore_errors=True)
+
     def _load_kernel_from_disk(
         self,
         key: str,
@@ -324,7 +494,7 @@ class KernelCache:
         except Exception as e:
             self.logger.error(f"Error loading wrapped kernel source code from disk: {e}")
 
-        if self.execution_backend == "nvrtc":
+        if execution_backend == "nvrtc":
             kernel_lib_path = os.path.join(cache_path, KERNEL_CUBIN_PATH)
         else:
             kernel_lib_path = os.path.join(cache_path, KERNEL_LIB_PATH)
@@ -337,6 +507,10 @@ class KernelCache:
         except Exception as e:
             self.logger.error(f"Error loading kernel parameters from disk: {e}")
 
+        # The library of a cross-compiled kernel is built by `_build_deferred_library`
+        if execution_backend in ("ctypes", "cython") and not os.path.exists(kernel_lib_path):
+            return None
+
         if kernel_global_source and kernel_params:
             return JITKernel.from_database(
                 func=func,
@@ -352,6 +526,42 @@ class KernelCache:
         else:
             return None
 
+    def _build_deferred_library(self, key: str, target: Union[str, Target],
+                                execution_backend: str, pass_configs: dict) -> bool:
+        """
+        Builds the library of a kernel stored by `cross_compile` without one into the
+        disk cache. Runs the host compiler, so callers must not hold `_lock`.
+
+        Returns:
+            bool: Whether a library was built.
+        """
+        if execution_backend not in ("ctypes", "cython"):
+            return False
+        cache_path = self._get_cache_path(key)
+        kernel_lib_path = os.path.join(cache_path, KERNEL_LIB_PATH)
+        wrapped_kernel_path = os.path.join(cache_path, WRAPPED_KERNEL_PATH)
+        if not os.path.exists(wrapped_kernel_path) or os.path.exists(kernel_lib_path):
+            return False
+        try:
+            with open(wrapped_kernel_path, "r") as f:
+                wrapped_source = f.read()
+        except Exception as e:
+            self.logger.error(f"Error loading wrapped kernel source code from disk: {e}")
+            return False
+
+        lib_generator = LibraryGenerator(Target.canon_target(determine_target(target)))
+        lib_generator.assign_pass_configs(pass_configs or {})
+        lib_generator.update_lib_code(wrapped_source)
+        try:
+            lib_generator.compile_lib()
+            staged_path = f"{kernel_lib_path}.tmp.{os.getpid()}.{threading.get_ident()}"
+            shutil.copy(lib_generator.libpath, staged_path)
+            os.replace(staged_path, kernel_lib_path)
+        except Exception as e:
+            self.logger.error(f"Error building the library of a cross-compiled kernel: {e}")
+            return False
+        return True
+
     def _clear_disk_cache(self):
         """
         Removes all cached kernels from disk.
@@ -85,6 +85,9 @@ class TileDict:
         self.cached_tensors_map = {}
         self.output_strides_map = {}
         self.tensor_strides_map = {}
+        # fused graphs: tiles computed per block, memory level of intermediates
+        self.node_iters = {}
+        self.intermediate_scopes = {}
 
         # analysis
         self.traffic = -1
@@ -166,6 +169,8 @@ class Hint(object):
         self.reduce_thread = []
         self.rasterization_plan = NoRasterization()
         self.cached_tensors = []
+        # Memory level ("shared" or "local") of outputs consumed within a fused graph
+        self.intermediate_scopes: Dict[str, str] = {}
         self.output_strides = {}
         self.schedule_stages = None
         # Config for block reduction
@@ -215,6 +220,8 @@ class Hint(object):
             dic["pipeline_stage"] = self.pipeline_stage
         if self.block_reduction_depth is not None:
             dic["block_reduction_depth"] = self.block_reduction_depth
+        if self.intermediate_scopes:
+            dic["intermediate_scopes"] = self.intermediate_scopes
         return dic
 
     @classmethod
@@ -1,6 +1,9 @@
 """Policy for cuda core schedule"""
+import copy
 import functools
+import logging
 import math
+import time
 from queue import PriorityQueue
 from typing import Iterable, Dict, List, Optional
 
@@ -14,6 +17,8 @@ from .common import coalesced_factor, coalesced_tensor_shape, factorize, get_all
 from ..node import PrimFuncNode, OutputNode, find_topo_sort
 from ..rasterization import NoRasterization
 
+logger = logging.getLogger(__name__)
+
 
 class DefaultPolicy:
     """
@@ -33,6 +38,12 @@ class DefaultPolicy:
         self.arch = arch
         self.tags = tags
         self.rasterization = NoRasterization()
+        # Memoised analysis results, valid for the lifetime of the policy
+        self._tile_dict_cache: Dict = {}
+        self._propagate_cache: Dict = {}
+        self._footprint_cache: Dict = {}
+        self.enumeration_stats: Dict = {}
+        self._reset_enumeration_stats()
 
     @classmethod
     def from_prim_func(cls,
@@ -78,7 +89,34 @@ class DefaultPolicy:
                 self.output_nodes.append(node)
         return self
 
+    def _reset_enumeration_stats(self):
+        self.enumeration_stats = {
+            "tile_dicts": 0,
+            "tile_dict_hits": 0,
+            "valid_tiles": 0,
+            "pruned_tiles": 0,
+            "propagate_hits": 0,
+            "propagate_misses": 0,
+            "footprint_hits": 0,
+            "footprint_misses": 0,
+            "time": 0.0,
+        }
+
+    def get_enumeration_stats(self) -> Dict:
+        """Counters of the last emit_config call: tile dicts computed and served
+        from cache, candidates pruned by dominance, analysis cache hits, and the
+        wall time in seconds."""
+        return dict(self.enumeration_stats)
+
     def emit_config(self, topk: int) -> List[Hint]:
+        self._reset_enumeration_stats()
+        start = time.perf_counter()
+        results = self._emit_config(topk)
+        self.enumeration_stats["time"] = time.perf_counter() - start
+        logger.debug(f"Roller enumeration stats: {self.enumeration_stats}")
+        return results
+
+    def _emit_config(self, topk: int) -> List[Hint]:
         base_tile = self.get_base_tile()
         if base_tile is None:
             return []
@@ -90,7 +128,12 @@ class DefaultPolicy:
             if not self.check_tile_shape_isvalid(td):
                 continue
 
+            rstep_map = td.rstep_map
             self._expand_reduce_axis(td)
+            if not self._update_fused_tiles(td):
+                # the larger reduction steps grow fused producer tiles past capacity
+                td.rstep_map = rstep_map
+                self._update_fused_tiles(td)
             for codegen_dicts in self.assign_block_size(td):
                 if isinstance(codegen_dicts, dict) and len(codegen_dicts) == 1:
                     results.append(list(codegen_dicts.values())[0])
@@ -114,18 +157,35 @@ class DefaultPolicy:
             steps[i].extend(added)
             steps[i] = sorted(steps[i])
         visited_tiles = {}
+        # Minimal tiles found to exceed shared memory or register capacity.
+        # Both footprints grow with every tile dimension, so a tile dominating
+        # one of them cannot fit either and is pruned without analysis.
+        infeasible_tiles = []
         queue = PriorityQueue()
 
         def prio(td: TileDict):
             return (td.traffic + 1) * td.num_wave
 
+        def is_dominated(tile):
+            return any(all(t >= f for t, f in zip(tile, bound)) for bound in infeasible_tiles)
+
         def add_to_queue(tile):
             if tuple(tile) in visited_tiles:
                 return
+            if is_dominated(tile):
+                self.enumeration_stats["pruned_tiles"] += 1
+                return
             td = self.compute_tile_dict(tile, rstep_map)
             visited_tiles[tuple(tile)] = td
             if td.valid:
+                self.enumeration_stats["valid_tiles"] += 1
                 queue.put([prio(td), tile])
+            else:
+                infeasible_tiles[:] = [
+                    bound for bound in infeasible_tiles
+                    if not all(f >= t for f, t in zip(bound, tile))
+                ]
+                infeasible_tiles.append(tuple(tile))
 
         add_to_queue(init_tile)
         while not (queue.empty() or len(visited_tiles) > 2000):
@@ -204,7 +264,7 @@ class DefaultPolicy:
         num_item = int(np.prod(output_tile))
         for node in reversed(self.ordered_nodes):
             tile = op_tile_map[node]
-            dep = node.propagate_inputs(tile)
+            dep = self._propagate_inputs(node, tile)
             compute += int(np.prod(tile))
             for i, edge in enumerate(node.inputs):
                 op_tile_map[edge.src_node] = dep[i]
@@ -304,7 +364,7 @@ class DefaultPolicy:
         def _score(rstep_id):
             rstep = {k: all_steps[k][rstep_id[k]] for k in rstep_id}
             score = 0
-            shape = node.propagate_inputs(tile, rstep=rstep)
+            shape = self._propagate_inputs(node, tile, rstep)
             for i, input_buffer in enumerate(node.input_buffers):
                 read_transaction_elements = self.arch.transaction_size[1] // (
                     (node.get_buffer_dtype(input_buffer).bits + 7) // 8)
@@ -365,7 +425,7 @@ class DefaultPolicy:
             def _score(rstep_id):
                 rstep = {k.var.name: all_steps[k.var.name][rstep_id[k.var.name]] for k in node.raxis}
                 score = 0
-                shape = node.propagate_inputs(td.get_tile(node), rstep=rstep)
+                shape = self._propagate_inputs(node, td.get_tile(node), rstep)
                 for i, input_buffer in enumerate(node.input_buffers):
                     score += coalesced_factor(shape[i], input_buffer.shape)
                 return score
@@ -411,26 +471,42 @@ class DefaultPolicy:
         td.rstep_map = rstep_map
         td.smem_cost, td.cached_tensors_map = self._compute_shared_memory_usage(td)
 
-    def _compute_memory_traffic(self, output_tile):
+    def _compute_memory_traffic(self, output_tile, rstep_map: Optional[Dict] = None):
         """
         Computes the memory traffic for a given output tile configuration.
 
+        A producer whose output is reduced by its consumer is fused into the
+        consumer's reduction loop: its tile covers one reduction step of the
+        consumer and is computed once per step, while its inputs are still
+        charged once for the whole block.
+
         Parameters
         ----------
         output_tile : List[int]
             The output tile configuration.
+        rstep_map : Optional[Dict]
+            The reduction steps of each node. Without it, producers are tiled
+            over the full reduction of their consumers.
 
         Returns
         -------
-        Tuple[int, Dict]
-            The total memory traffic and a map of operation tiles.
+        Tuple[int, Dict, Dict]
+            The total memory traffic, a map of operation tiles and the number of
+            times each node's tile is computed per block.
         """
         op_tile_map = self._get_output_tile_map(output_tile)
+        step_tile_map = dict(op_tile_map)
+        node_iters = {node: 1 for node in op_tile_map}
         traffic = 0
         for node in reversed(self.ordered_nodes):
             tile = op_tile_map[node]
-            input_shapes = node.propagate_inputs(tile)
+            input_shapes = self._propagate_inputs(node, tile)
             output_shapes = node.propagate_outputs(tile)
+            step_tile = step_tile_map[node]
+            full_shapes = self._propagate_inputs(node, step_tile)
+            step_shapes = (
+                self._propagate_inputs(node, step_tile, rstep_map.get(node))
+                if rstep_map else full_shapes)
             for i, edge in enumerate(node.inputs):
                 op_tile_map[edge.src_node] = input_shapes[i]
                 if edge.src_node.is_placeholder():
@@ -438,6 +514,11 @@ class DefaultPolicy:
                     read_transaction_elements = self.arch.transaction_size[1] // nbytes
                     traffic += coalesced_tensor_shape(input_shapes[i], edge.src_node.get_shape(),
                                                       read_transaction_elements) * nbytes
+                else:
+                    step_tile_map[edge.src_node] = step_shapes[i]
+                    node_iters[edge.src_node] = node_iters[node] * int(
+                        np.prod([(full + step - 1) // step
+                                 for full, step in zip(full_shapes[i], step_shapes[i])]))
             for edge in node.outputs:
                 if edge.dst_node.is_output():
                     nbytes = (edge.src_node.get_dtype().bits + 7) // 8
@@ -446,7 +527,56 @@ class DefaultPolicy:
                                                       node.get_shape(edge.src_id),
                                                       write_transaction_elements) * nbytes
 
-        return traffic, op_tile_map
+        return traffic, step_tile_map, node_iters
+
+    def _is_fused_graph(self) -> bool:
+        """Whether some node consumes the output of another node."""
+        return any(not edge.src_node.is_placeholder()
+                   for node in self.ordered_nodes
+                   for edge in node.inputs)
+
+    def _update_fused_tiles(self, td: TileDict) -> bool:
+        """
+        Re-derives the tiles of fused producers after the reduction steps in the
+        TileDict changed, and reports whether the result still fits shared memory.
+        """
+        if not self._is_fused_graph():
+            return True
+        td.traffic, td.tile_map, td.node_iters = self._compute_memory_traffic(
+            td.output_tile, td.rstep_map)
+        td.smem_cost, td.cached_tensors_map = self._compute_shared_memory_usage(td)
+        return td.smem_cost <= self.arch.smem_cap
+
+    def _get_intermediate_scopes(self, td: TileDict, node: PrimFuncNode) -> Dict[str, str]:
+        """Memory level of each output of `node` that another node of the graph consumes."""
+        return {
+            node.output_buffers[out_id].name: scope
+            for (src, out_id), scope in td.intermediate_scopes.items()
+            if src is node
+        }
+
+    def _intermediate_scope(self, td: TileDict, node: PrimFuncNode, out_id: int) -> str:
+        """
+        Memory level of an intermediate tile produced by `node`.
+
+        The tile stays in registers when every consumer reads it elementwise
+        with the same tile shape. A consumer that reduces over it or broadcasts
+        it reads elements owned by other threads, which requires shared memory.
+        """
+        tile_elems = int(np.prod(td.get_tile(node)))
+        for edge in node.outputs:
+            if edge.src_id != out_id or edge.dst_node.is_output():
+                continue
+            consumer = edge.dst_node
+            consumer_tile = td.get_tile(consumer)
+            shape = self._propagate_inputs(consumer, consumer_tile)[edge.dst_id]
+            if len(consumer.raxis) > 0:
+                unit_step = {ax.var.name: 1 for ax in consumer.raxis}
+                if self._propagate_inputs(consumer, consumer_tile, unit_step)[edge.dst_id] != shape:
+                    return "shared"
+            if int(np.prod(shape)) != tile_elems or int(np.prod(consumer_tile)) != tile_elems:
+                return "shared"
+        return "local"
 
     def infer_node_smem_usage(self, td: TileDict, node: PrimFuncNode):
         """
@@ -464,7 +594,34 @@ class DefaultPolicy:
         int
             The estimated amount of shared memory used by the node.
         """
-        return node.footprint(td.get_tile(node), td.get_rstep(node), td.tensor_strides_map[node])
+        return self._node_footprint(node, td.get_tile(node), td.get_rstep(node),
+                                    td.tensor_strides_map[node])
+
+    def _propagate_inputs(self, node: PrimFuncNode, tile, rstep: Optional[Dict] = None):
+        """Memoised `node.propagate_inputs`, keyed by (node, tile, rstep)."""
+        key = (node, tuple(tile), tuple(sorted((rstep or {}).items())))
+        shapes = self._propagate_cache.get(key)
+        if shapes is None:
+            self.enumeration_stats["propagate_misses"] += 1
+            shapes = node.propagate_inputs(tile, rstep=rstep)
+            self._propagate_cache[key] = shapes
+        else:
+            self.enumeration_stats["propagate_hits"] += 1
+        return [list(shape) for shape in shapes]
+
+    def _node_footprint(self, node: PrimFuncNode, tile, rstep, stride_map: Optional[Dict] = None):
+        """Memoised `node.footprint`, keyed by (node, tile, rstep, strides)."""
+        strides = tuple(
+            sorted((name, stride.ax, stride.stride) for name, stride in (stride_map or {}).items()))
+        key = (node, tuple(tile), tuple(sorted(rstep.items())), strides)
+        result = self._footprint_cache.get(key)
+        if result is None:
+            self.enumeration_stats["footprint_misses"] += 1
+            result = node.footprint(tile, rstep, stride_map)
+            self._footprint_cache[key] = result
+        else:
+            self.enumeration_stats["footprint_hits"] += 1
+        return result[0], list(result[1])
 
     def _compute_shared_memory_usage(self, td: TileDict):
         """
@@ -487,6 +644,7 @@ class DefaultPolicy:
         block_map = {}
         processed = set()
         cached_tensors_map = {}
+        td.intermediate_scopes = {}
 
         def can_free(node, out_id):
             for edge in node.outputs:
@@ -502,10 +660,17 @@ class DefaultPolicy:
             processed.add(node)
             for edge in node.inputs:
                 if not edge.src_node.is_placeholder() and can_free(edge.src_node, edge.src_id):
-                    allocator.free(block_map.pop((edge.src_node, edge.src_id)))
-            # alloc outputs
+                    block = block_map.pop((edge.src_node, edge.src_id))
+                    if block is not None:
+                        allocator.free(block)
+            # alloc outputs, intermediates kept in registers take no shared memory
             for edge in node.outputs:
                 if not edge.dst_node.is_output() and (node, edge.src_id) not in block_map:
+                    scope = self._intermediate_scope(td, node, edge.src_id)
+                    td.intermediate_scopes[(node, edge.src_id)] = scope
+                    if scope == "local":
+                        block_map[(node, edge.src_id)] = None
+                        continue
                     dtype_bytes = (node.get_dtype(edge.src_id).bits + 7) // 8
                     stride = td.output_strides_map[node][len(node.inputs) + edge.src_id]
                     output_elem = stride.compute_elements_from_shape(td.get_tile(node))
@@ -574,9 +739,23 @@ class DefaultPolicy:
             A TileDict object containing the computed tile configuration, memory traffic, shared memory cost,
             grid size, and other related parameters.
         """
+        key = (tuple(output_tile),
+                tuple(tuple(sorted(rstep_map[node].items())) for node in self.ordered_nodes))
+        cached = self._tile_dict_cache.get(key)
+        if cached is not None:
+            self.enumeration_stats["tile_dict_hits"] += 1
+            # callers refine the returned tile dict in place
+            return copy.copy(cached)
+        self.enumeration_stats["tile_dicts"] += 1
+        td = self._compute_tile_dict(output_tile, rstep_map)
+        self._tile_dict_cache[key] = td
+        return copy.copy(td)
+
+    def _compute_tile_dict(self, output_tile: List[int], rstep_map) -> TileDict:
         td = TileDict(output_tile)
         td.rstep_map = rstep_map
-        td.traffic, td.tile_map = self._compute_memory_traffic(output_tile)
+        td.traffic, td.tile_map, td.node_iters = self._compute_memory_traffic(
+            output_tile, rstep_map)
         td.smem_cost, td.cached_tensors_map = self._compute_shared_memory_usage(td)
         if td.smem_cost > self.arch.smem_cap:
             td.valid = False
@@ -587,6 +766,12 @@ class DefaultPolicy:
         reg_usage = int(2 * max([
             np.prod(td.get_tile(node)) * node.get_dtype().bits / 32 for node in self.ordered_nodes
         ]))
+        # intermediates kept in registers stay live next to the consumer's tile
+        reg_usage += int(
+            sum(
+                np.prod(td.get_tile(node)) * node.get_dtype(out_id).bits / 32
+                for (node, out_id), scope in td.intermediate_scopes.items()
+                if scope == "local"))
         if reg_usage > self.arch.reg_cap:
             td.valid = False
             return td
@@ -614,7 +799,8 @@ class DefaultPolicy:
             node_grid_size = np.prod([
                 (y + x - 1) // x for x, y in zip(td.get_tile(node), node.get_space_dim())
             ])
-            if node_grid_size != td.grid_size:
+            # fused producers cover their consumer's tile over several reduction steps
+            if node_grid_size != td.grid_size * td.node_iters.get(node, 1):
                 return False
             if (hasattr(node, "reduce_op") and node.reduce_op is not None and
                     len(node.reduce_op.axis) == len(td.output_tile)):
@@ -726,7 +912,7 @@ class DefaultPolicy:
         def _score(node, thread):  # small is better
             score = 0
             block_tile = [int(np.ceil(tile[i] / thread[i])) for i in range(ndim)]
-            shape = node.propagate_inputs(block_tile)
+            shape = self._propagate_inputs(node, block_tile)
             for i, _ in enumerate(node.input_buffers):
                 score += np.prod(shape[i]) / self.arch.bandwidth[1]
             for buffer in node.output_buffers:
@@ -763,6 +949,7 @@ class DefaultPolicy:
         codegen_dict.rstep = [rsteps[ax.var.name] for ax in node.raxis]
         codegen_dict.reduce_thread = [reduce_thread[ax.var.name] for ax in node.raxis]
         codegen_dict.cached_tensors = td.cached_tensors_map[node]
+        codegen_dict.intermediate_scopes = self._get_intermediate_scopes(td, node)
         codegen_dict.rasterization_plan = self.plan_rasterization(td)
 
         if node.get_dtype().bits == 16:  # set step=2 for 16bit case to ensure coalesced access
@@ -127,8 +127,8 @@ class TensorCorePolicy(DefaultPolicy):
                     return rstep
 
                 def _shared_memory_usage(td: TileDict):
-                    return node.footprint(td.output_tile, new_rstep_map,
-                                          td.tensor_strides_map[node])
+                    return self._node_footprint(node, td.output_tile, new_rstep_map,
+                                                td.tensor_strides_map[node])
 
                 def _score(rstep_id):
                     rstep = {
@@ -313,6 +313,7 @@ class TensorCorePolicy(DefaultPolicy):
         codegen_dict.use_async = self.use_async_copy
         codegen_dict.rstep = [int(rsteps[ax.var.name]) for ax in node.raxis]
         codegen_dict.cached_tensors = td.cached_tensors_map[node]
+        codegen_dict.intermediate_scopes = self._get_intermediate_scopes(td, node)
         codegen_dict.rasterization_plan = self.plan_rasterization(td)
 
         intrin_info = node.get_tag("intrin_info")
@@ -1,6 +1,6 @@
 """Template for the TileLang Carver."""
 
-from .base import BaseTemplate  # noqa: F401
+from .base import BaseTemplate, CarvedKernel  # noqa: F401
 from .matmul import MatmulTemplate  # noqa: F401
 from .gemv import GEMVTemplate  # noqa: F401
 from .elementwise import ElementwiseTemplate  # noqa: F401
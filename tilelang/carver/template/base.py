@@ -2,11 +2,28 @@
 from abc import ABC, abstractmethod  # For defining abstract base classes
 from dataclasses import dataclass, field  # For defining data classes
 from ..arch import (  # Import architecture-related utilities and classes
-    TileDevice, is_volta_arch, is_ampere_arch, is_cdna_arch, auto_infer_current_arch)
+    TileDevice, is_volta_arch, is_ampere_arch, is_cdna_arch, is_cpu_arch,
+    auto_infer_current_arch)
 from ..roller.hint import Hint  # Import the Hint class
 from ..roller.node import OutputNode  # Import the OutputNode class
-from typing import List  # For type hinting
+from .kernel_utils import bench_cpu, compile_target  # Compile and time generated kernels
+from typing import Any, Dict, List, Optional  # For type hinting
 from tvm.tir import PrimFunc  # Import PrimFunc for handling tensor IR functions
+import concurrent.futures
+import logging
+
+logger = logging.getLogger(__name__)
+
+
+@dataclass
+class CarvedKernel:
+    """
+    A kernel generated from a hint together with its measured latency.
+    """
+
+    hint: Hint  # The hint the kernel was generated from
+    kernel: Any  # The compiled tilelang.JITKernel
+    latency: float  # Measured latency in milliseconds
 
 
 @dataclass
@@ -136,6 +153,35 @@ class BaseTemplate(ABC):
         self._output_nodes = output_nodes
         return self
 
+    def get_cpu_configs(self, topk: int = 10) -> List[Hint]:
+        """
+        Returns tile configurations for the CPU target, for which the roller
+        has no hardware model. Should be implemented by subclasses.
+
+        Args:
+            topk (int, optional): Number of top configurations to return. Defaults to 10.
+
+        Raises:
+            NotImplementedError: If not implemented in the subclass.
+        """
+        raise NotImplementedError(f"{self.__class__.__name__} has no CPU configurations")
+
+    def get_kernel(self, hint: Hint) -> PrimFunc:
+        """
+        Instantiates the canonical TileLang implementation of this template
+        with the tile sizes of the given hint. Should be implemented by subclasses.
+
+        Args:
+            hint (Hint): A configuration returned by `recommend_hints`.
+
+        Returns:
+            PrimFunc: The TileLang program, whose parameters follow `equivalent_function`.
+
+        Raises:
+            NotImplementedError: If not implemented in the subclass.
+        """
+        raise NotImplementedError(f"{self.__class__.__name__} has no kernel generator")
+
     def recommend_hints(self, topk: int = 10) -> List[Hint]:
         """
         Provides a list of recommended hardware-aware configurations.
@@ -146,8 +192,81 @@ class BaseTemplate(ABC):
         Returns:
             List[Hint]: A list of recommended configurations.
         """
+        if is_cpu_arch(self._arch):
+            return self.get_cpu_configs(topk)
         return self.get_hardware_aware_configs(self._arch, topk)
 
+    def recommend_kernels(self,
+                          topk: int = 10,
+                          num_workers: Optional[int] = None,
+                          warmup: int = 25,
+                          rep: int = 100,
+                          pass_configs: Optional[Dict[str, Any]] = None) -> List[CarvedKernel]:
+        """
+        Generates kernels for the top hints, compiles them in parallel and ranks
+        them by latency measured on the target of the architecture.
+
+        Hints whose kernel fails to generate, compile or run are dropped.
+
+        Args:
+            topk (int, optional): Number of hints to instantiate. Defaults to 10.
+            num_workers (int, optional): Number of parallel compilations.
+                Defaults to the number of available CPUs.
+            warmup (int, optional): Warmup time in ms for GPU targets.
+            rep (int, optional): Repetition time in ms for GPU targets. CPU kernels
+                are timed over a few host iterations instead.
+            pass_configs (dict, optional): Extra pass configurations for compilation.
+
+        Returns:
+            List[CarvedKernel]: The kernels, fastest first.
+        """
+        import tilelang
+        from tilelang.autotuner.tuner import get_available_cpu_count
+
+        programs = []
+        for hint in self.recommend_hints(topk) or []:
+            try:
+                programs.append((hint, self.get_kernel(hint)))
+            except NotImplementedError:
+                raise
+            except Exception as error:  # noqa: BLE001
+                logger.debug(f"Failed to generate a kernel for hint {hint}: {error}")
+
+        on_cpu = is_cpu_arch(self._arch)
+        target = compile_target(self._arch)
+
+        def _compile(hint, program):
+            configs = dict(hint.pass_context)
+            configs.update(pass_configs or {})
+            return tilelang.compile(
+                program,
+                target=target,
+                execution_backend="ctypes" if on_cpu else "cython",
+                pass_configs=configs)
+
+        num_workers = num_workers or get_available_cpu_count()
+        compiled = []
+        with concurrent.futures.ThreadPoolExecutor(max_workers=num_workers) as pool:
+            futures = {pool.submit(_compile, hint, program): hint for hint, program in programs}
+            for future in concurrent.futures.as_completed(futures):
+                try:
+                    compiled.append((futures[future], future.result()))
+                except Exception as error:  # noqa: BLE001
+                    logger.debug(f"Failed to compile hint {futures[future]}: {error}")
+
+        results = []
+        for hint, kernel in compiled:
+            try:
+                if on_cpu:
+                    latency = bench_cpu(kernel)
+                else:
+                    latency = kernel.get_profiler().do_bench(warmup=warmup, rep=rep)
+            except Exception as error:  # noqa: BLE001
+                logger.debug(f"Failed to benchmark hint {hint}: {error}")
+                continue
+            results.append(CarvedKernel(hint=hint, kernel=kernel, latency=latency))
+        return sorted(results, key=lambda result: result.latency)
+
     @property
     def arch(self) -> TileDevice:
         """
@@ -1,9 +1,13 @@
 from dataclasses import dataclass
 from .base import BaseTemplate
 from tvm import te, tir
+from tvm.tir import PrimFunc
+from ..arch import is_cpu_arch
 from ..roller import Hint
 from typing import List
 from ..utils import get_roller_hints_from_func
+from .kernel_utils import gemm_tile_config
+import tilelang.language as T
 
 
 @dataclass
@@ -58,6 +62,85 @@ class ConvTemplate(BaseTemplate):
         roller_hints = get_roller_hints_from_func(self._func, arch=arch, topk=topk, allow_gemv=True)
         return roller_hints
 
+    def get_kernel(self, hint: Hint) -> PrimFunc:
+        """
+        Instantiates the canonical implicit GEMM convolution (NHWC input, HWCF
+        weight) with the tile sizes of the hint: the (N * OH * OW) x F output is
+        tiled by block_M x block_N and the KH * KW * C reduction by block_K.
+
+        Args:
+            hint (Hint): A configuration returned by `recommend_hints`.
+
+        Returns:
+            PrimFunc: The TileLang program, taking (A, B, [Bias,] C).
+        """
+        if is_cpu_arch(self.arch):
+            raise NotImplementedError("ConvTemplate has no CPU kernel generator")
+        N, C, H, W, F, K, S, D, P = self.N, self.C, self.H, self.W, self.F, self.K, self.S, self.D, self.P
+        in_dtype, out_dtype, accum_dtype = self.in_dtype, self.out_dtype, self.accum_dtype
+        KH, KW = K, K
+        OH = (H + 2 * P - D * (KH - 1) - 1) // S + 1
+        OW = (W + 2 * P - D * (KW - 1) - 1) // S + 1
+        config = gemm_tile_config(hint, self.arch)
+        block_M, block_N, block_K = config["block_M"], config["block_N"], config["block_K"]
+        num_stages, threads = config["num_stages"], config["threads"]
+        enable_rasterization = config["enable_rasterization"]
+
+        @T.macro
+        def mainloop(A, B, A_shared, B_shared, C_local, bx, by):
+            B_flat = T.Tensor((KH * KW * C, F), in_dtype, B.data)
+            T.use_swizzle(panel_size=10, enable=enable_rasterization)
+            T.clear(C_local)
+            for k_iter in T.Pipelined(T.ceildiv(KH * KW * C, block_K), num_stages=num_stages):
+                for i, j in T.Parallel(block_M, block_K):
+                    k = k_iter * block_K + j
+                    m = by * block_M + i
+                    access_h = m % (OH * OW) // OW * S + k // (KW * C) * D - P
+                    access_w = m % OW * S + k // C % KW * D - P
+                    in_bound = ((access_h >= 0) and (access_w >= 0) and (access_h < H) and
+                                (access_w < W))
+                    A_shared[i, j] = T.if_then_else(in_bound, A[m // (OH * OW), access_h, access_w,
+                                                               k % C], 0)
+                T.copy(B_flat[k_iter * block_K, bx * block_N], B_shared)
+                T.gemm(A_shared, B_shared, C_local)
+
+        @T.prim_func
+        def main(
+                A: T.Tensor((N, H, W, C), in_dtype),
+                B: T.Tensor((KH, KW, C, F), in_dtype),
+                Out: T.Tensor((N, OH, OW, F), out_dtype),
+        ):
+            with T.Kernel(
+                    T.ceildiv(F, block_N), T.ceildiv(N * OH * OW, block_M),
+                    threads=threads) as (bx, by):
+                A_shared = T.alloc_shared((block_M, block_K), in_dtype)
+                B_shared = T.alloc_shared((block_K, block_N), in_dtype)
+                C_local = T.alloc_fragment((block_M, block_N), accum_dtype)
+                out_flat = T.Tensor((N * OH * OW, F), out_dtype, Out.data)
+                mainloop(A, B, A_shared, B_shared, C_local, bx, by)
+                T.copy(C_local, out_flat[by * block_M, bx * block_N])
+
+        @T.prim_func
+        def main_with_bias(
+                A: T.Tensor((N, H, W, C), in_dtype),
+                B: T.Tensor((KH, KW, C, F), in_dtype),
+                Bias: T.Tensor((F,), accum_dtype),
+                Out: T.Tensor((N, OH, OW, F), out_dtype),
+        ):
+            with T.Kernel(
+                    T.ceildiv(F, block_N), T.ceildiv(N * OH * OW, block_M),
+                    threads=threads) as (bx, by):
+                A_shared = T.alloc_shared((block_M, block_K), in_dtype)
+                B_shared = T.alloc_shared((block_K, block_N), in_dtype)
+                C_local = T.alloc_fragment((block_M, block_N), accum_dtype)
+                out_flat = T.Tensor((N * OH * OW, F), out_dtype, Out.data)
+                mainloop(A, B, A_shared, B_shared, C_local, bx, by)
+                for i, j in T.Parallel(block_M, block_N):
+                    C_local[i, j] += Bias[bx * block_N + j]
+                T.copy(C_local, out_flat[by * block_M, bx * block_N])
+
+        return main_with_bias if self.with_bias else main
+
     def initialize_function(self) -> None:
         """
         Defines and initializes the convolution computation.
@@ -2,10 +2,25 @@
 from dataclasses import dataclass  # Used for defining data classes
 from .base import BaseTemplate  # Importing the base class for templates
 from tvm import te  # Importing TVM's tensor expression module
-from ..arch import TileDevice  # Importing TileDevice for hardware-specific configurations
+from tvm.script.ir_builder import IRBuilder  # Builds kernels with a variable number of inputs
+from tvm.tir import PrimExpr, PrimFunc  # Importing PrimFunc for the generated kernels
+from ..arch import TileDevice, is_cpu_arch  # Importing TileDevice for hardware-specific configurations
 from ..roller import Hint  # Importing Hint for optimization hints
-from typing import List  # Importing List type hint
-from ..utils import get_roller_hints_from_func  # Function to obtain optimization hints
+from typing import Callable, List, Optional  # Importing type hints
+from .kernel_utils import (  # Kernel generator helpers
+    CPU_TILE_CACHE_BYTES, block_threads, dtype_bytes, warp_size_of,
+)
+import tilelang.language as T  # Importing TileLang to build the kernels
+from tilelang.language import ast as tb  # IR builder frames for the generated kernels
+import math
+import string
+
+# Widest vector access of a GPU thread, in bytes
+GPU_VECTOR_BYTES = 16
+# Vector chunk of a CPU worker, in bytes, sized for 512-bit registers
+CPU_VECTOR_BYTES = 64
+# Resident threads per streaming multiprocessor assumed when sizing the grid
+MAX_THREADS_PER_SM = 2048
 
 
 @dataclass
@@ -13,18 +28,86 @@ class ElementwiseTemplate(BaseTemplate):
     """
     A template for element-wise operations using TVM.
 
+    The operation is `compute(*inputs)`, evaluated for every element of the
+    output. Inputs broadcast against the output shape with numpy semantics:
+    shapes are aligned to the right and dimensions of extent 1 are repeated.
+
     Attributes:
-        shape (List[int]): The shape of the tensor.
-        dtype (str): The data type of the tensor (default: "float16").
+        shape (List[int]): The shape of the output tensor.
+        dtype (str): The data type of the inputs (default: "float16").
+        compute (Callable, optional): Maps one value per input to the output
+            value, as PrimExprs. Defaults to `lambda a: a + 1`.
+        input_shapes (List[List[int]], optional): The shapes of the inputs.
+            Defaults to a single input of the output shape.
+        out_dtype (str, optional): The data type of the output. Defaults to `dtype`.
     """
 
     # OP Related Config
     shape: List[int] = None  # Shape of the tensor
     dtype: str = "float16"  # Data type of the tensor
+    compute: Optional[Callable[..., PrimExpr]] = None  # The element-wise expression
+    input_shapes: Optional[List[List[int]]] = None  # Shapes of the inputs
+    out_dtype: Optional[str] = None  # Data type of the output
+
+    def _compute(self) -> Callable[..., PrimExpr]:
+        return self.compute if self.compute is not None else (lambda a: a + 1)
+
+    def _input_shapes(self) -> List[List[int]]:
+        return [list(shape) for shape in self.input_shapes] if self.input_shapes else [
+            list(self.shape)
+        ]
+
+    def _out_dtype(self) -> str:
+        return self.out_dtype or self.dtype
+
+    def _names(self) -> List[str]:
+        """Names of the inputs followed by the name of the output: A, B, ..."""
+        return list(string.ascii_uppercase[:len(self._input_shapes()) + 1])
+
+    def _broadcast_indices(self, in_shape: List[int], indices: List[PrimExpr]) -> List[PrimExpr]:
+        offset = len(self.shape) - len(in_shape)
+        return [
+            0 if int(extent) == 1 and self.shape[offset + i] != 1 else indices[offset + i]
+            for i, extent in enumerate(in_shape)
+        ]
+
+    def vector_width(self) -> int:
+        """
+        Widest power-of-two number of consecutive elements a thread accesses at
+        once, limited by the vector size of the arch and by the innermost
+        dimension, along which every non-broadcast operand is contiguous.
+        """
+        vector_bytes = CPU_VECTOR_BYTES if is_cpu_arch(self.arch) else GPU_VECTOR_BYTES
+        elem_bytes = max(dtype_bytes(self.dtype), dtype_bytes(self._out_dtype()))
+        vec = 1
+        while vec * 2 * elem_bytes <= vector_bytes and self.shape[-1] % (vec * 2) == 0:
+            vec *= 2
+        return vec
+
+    def bytes_moved(self) -> int:
+        """Bytes the operation reads and writes, every operand touched once."""
+        in_bytes = dtype_bytes(self.dtype)
+        return (sum(math.prod(shape) * in_bytes for shape in self._input_shapes()) +
+                math.prod(self.shape) * dtype_bytes(self._out_dtype()))
+
+    def roofline_latency(self, bandwidth: float) -> float:
+        """Lower bound of the latency in ms at `bandwidth` GB/s, e.g. from
+        `kernel_utils.measure_stream_bandwidth`."""
+        return self.bytes_moved() / (bandwidth * 1e9) * 1e3
+
+    def _make_hint(self, block: int, threads: int) -> Hint:
+        hint = Hint()
+        hint.block = [block]
+        hint.thread = [threads]
+        hint.vectorize = {name: self.vector_width() for name in self._names()}
+        hint.arch = self.arch
+        return hint
 
     def get_hardware_aware_configs(self, arch: TileDevice = None, topk: int = 10) -> List[Hint]:
         """
-        Retrieves hardware-aware optimization configurations.
+        Sizes blocks from the GPU model. Each thread handles a few vectors; the
+        grid should fill every streaming multiprocessor and end on as full a
+        last wave as possible.
 
         Args:
             arch (TileDevice, optional): The target hardware architecture.
@@ -33,37 +116,155 @@ class ElementwiseTemplate(BaseTemplate):
         Returns:
             List[Hint]: A list of optimization hints for the given architecture.
         """
-        roller_hints = get_roller_hints_from_func(self._func, arch=arch, topk=topk, allow_gemv=True)
-        return roller_hints
+        arch = arch or self.arch
+        numel, vec = math.prod(self.shape), self.vector_width()
+        warp_size = warp_size_of(arch)
+        scored = []
+        for threads in (128, 256, 512):
+            threads = max(threads, warp_size)
+            for vectors_per_thread in (1, 2, 4, 8):
+                block = threads * vec * vectors_per_thread
+                if block > numel and vectors_per_thread > 1:
+                    continue
+                grid = (numel + block - 1) // block
+                resident = arch.compute_max_core * (MAX_THREADS_PER_SM // threads)
+                waves = (grid + resident - 1) // resident
+                wave_efficiency = grid / (waves * resident)
+                scored.append(((grid < resident, -round(wave_efficiency, 2), vectors_per_thread,
+                                abs(threads - 256)), block, threads))
+        scored.sort(key=lambda item: item[0])
+        return [self._make_hint(block, threads) for _, block, threads in scored[:topk]]
+
+    def get_cpu_configs(self, topk: int = 10) -> List[Hint]:
+        """
+        Sizes blocks for the host cores: every block streams a working set that
+        fits in the data cache, and the grid splits evenly over the cores.
+        """
+        from tilelang.autotuner.tuner import get_available_cpu_count
+        cores = get_available_cpu_count()
+        numel, vec = math.prod(self.shape), self.vector_width()
+        bytes_per_elem = self.bytes_moved() / numel
+        scored = []
+        block = vec
+        while True:
+            grid = (numel + block - 1) // block
+            balance = grid / (((grid + cores - 1) // cores) * cores)
+            fits = block * bytes_per_elem <= CPU_TILE_CACHE_BYTES
+            scored.append(((not fits, grid < cores, -round(balance, 2), -block), block))
+            if block >= numel:
+                break
+            block *= 2
+        scored.sort(key=lambda item: item[0])
+        return [self._make_hint(block, 1) for _, block in scored[:topk]]
+
+    def get_kernel(self, hint: Hint) -> PrimFunc:
+        """
+        Instantiates the element-wise kernel. The output is walked in row-major
+        order in vectors of `vector_width()` elements; consecutive threads (or
+        iterations of a CPU worker) take consecutive vectors so that accesses
+        are contiguous, and every block covers `hint.block` elements.
+
+        Args:
+            hint (Hint): A configuration returned by `recommend_hints`.
+
+        Returns:
+            PrimFunc: The TileLang program, taking the inputs then the output.
+        """
+        shape, out_dtype = list(self.shape), self._out_dtype()
+        input_shapes, names = self._input_shapes(), self._names()
+        fcompute = self._compute()
+        vec = self.vector_width()
+        numel = math.prod(shape)
+        num_vectors = numel // vec
+        on_cpu = is_cpu_arch(self.arch)
+        threads = 1 if on_cpu else block_threads(hint, self.arch)
+        vectors_per_thread = max(1, min(math.prod(hint.block), numel) // (threads * vec))
+        block_vectors = threads * vectors_per_thread
+        grid = (num_vectors + block_vectors - 1) // block_vectors
+
+        def unravel(vector: PrimExpr, v: PrimExpr) -> List[PrimExpr]:
+            # a vector never straddles rows as vec divides the innermost extent
+            flat = vector * vec
+            indices = [flat % shape[-1] + v]
+            rest = flat // shape[-1]
+            for extent in reversed(shape[1:-1]):
+                indices.insert(0, rest % extent)
+                rest = rest // extent
+            if len(shape) > 1:
+                indices.insert(0, rest)
+            return indices
+
+        def emit_vector(buffers, vector: PrimExpr):
+            # CPU loops stay serial, the host compiler vectorises contiguous loops
+            loop = tb.serial(vec) if on_cpu else tb.vectorized(vec)
+            with loop as v:
+                indices = unravel(vector, v)
+                values = [
+                    buffer[self._broadcast_indices(in_shape, indices)]
+                    for buffer, in_shape in zip(buffers[:-1], input_shapes)
+                ]
+                tb.buffer_store(buffers[-1], T.Cast(out_dtype, fcompute(*values)), indices)
+
+        def emit_guarded(buffers, vector: PrimExpr):
+            if num_vectors % block_vectors == 0:
+                emit_vector(buffers, vector)
+                return
+            with tb.If(vector < num_vectors):
+                with tb.Then():
+                    emit_vector(buffers, vector)
+
+        with IRBuilder() as ib:
+            with tb.prim_func():
+                tb.func_name("main")
+                buffers = [
+                    tb.arg(name, tb.buffer(in_shape, self.dtype, name=name))
+                    for name, in_shape in zip(names[:-1], input_shapes)
+                ]
+                buffers.append(tb.arg(names[-1], tb.buffer(shape, out_dtype, name=names[-1])))
+                if on_cpu:
+                    with T.Kernel(grid, is_cpu=True, parallel=True) as bx:
+                        with tb.serial(block_vectors) as i:
+                            emit_guarded(buffers, bx * block_vectors + i)
+                else:
+                    with T.Kernel(grid, threads=threads) as bx:
+                        tx = T.get_thread_binding()
+                        with tb.serial(vectors_per_thread) as i:
+                            emit_guarded(buffers, bx * block_vectors + i * threads + tx)
+        return ib.get()
 
     def initialize_function(self) -> None:
         """
         Initializes the element-wise computation function.
 
-        Defines a simple element-wise computation: B = A + 1, where A is an input tensor.
-        The computation graph is built using TVM's tensor expressions.
+        Defines `out = compute(*inputs)` with the inputs broadcast to the output
+        shape; by default a single input and B = A + 1.
         """
-        shape, dtype = self.shape, self.dtype  # Extract shape and dtype
+        shape, fcompute = self.shape, self._compute()
+        names = self._names()
 
-        # Define a placeholder tensor A
-        A = te.placeholder(shape, name="A", dtype=dtype)
+        # Define a placeholder per input
+        inputs = [
+            te.placeholder(in_shape, name=name, dtype=self.dtype)
+            for name, in_shape in zip(names[:-1], self._input_shapes())
+        ]
 
-        # Define the element-wise computation (adding 1 to each element)
+        # Define the element-wise computation over the broadcast inputs
         def _compute_elementwise(*indices):
-            return A[indices] + 1
+            values = [
+                tensor[tuple(self._broadcast_indices(tensor.shape, list(indices)))]
+                for tensor in inputs
+            ]
+            return fcompute(*values).astype(self._out_dtype())
 
-        # Define the computation for B based on A
-        B = te.compute(
+        # Define the computation of the output based on the inputs
+        out = te.compute(
             shape,
             fcompute=_compute_elementwise,  # Function that defines element-wise computation
-            name="B",
+            name=names[-1],
         )
 
-        # Store input and output tensors as function arguments
-        args = [A, B]
-
         # Create and set the computation function
-        self.set_function(te.create_prim_func(args))
+        self.set_function(te.create_prim_func(inputs + [out]))
 
     def params_as_dict(self):
         """
@@ -72,7 +273,12 @@ class ElementwiseTemplate(BaseTemplate):
         Returns:
             dict: A dictionary containing shape and dtype.
         """
-        return {"shape": self.shape, "dtype": self.dtype}
+        return {
+            "shape": self.shape,
+            "dtype": self.dtype,
+            "input_shapes": self._input_shapes(),
+            "out_dtype": self._out_dtype(),
+        }
 
     @property
     def class_attributes(self):
@@ -1,11 +1,14 @@
 from dataclasses import dataclass
 from .base import BaseTemplate
 from tvm import te
-from ..arch import TileDevice
+from tvm.tir import PrimFunc
+from ..arch import TileDevice, is_cpu_arch
 from ..roller import Hint
 from ..roller import PrimFuncNode, OutputNode, Edge
 from typing import List
 from ..utils import get_roller_hints_from_output_nodes, get_tensorized_func_and_tags
+from .kernel_utils import gemm_tile_config
+import tilelang.language as T
 
 
 @dataclass
@@ -40,6 +43,93 @@ class FlashAttentionTemplate(BaseTemplate):
         roller_hints = get_roller_hints_from_output_nodes(self.output_nodes, arch=arch, topk=topk)
         return roller_hints
 
+    def get_kernel(self, hint: Hint) -> PrimFunc:
+        """
+        Instantiates the canonical flash attention forward kernel (online
+        softmax, BHSD layout) with the tile sizes of the hint: the output tile
+        gives block_M and the reduction step over the KV sequence block_N.
+
+        Args:
+            hint (Hint): A configuration returned by `recommend_hints`.
+
+        Returns:
+            PrimFunc: The TileLang program, taking (Q, K, V, Output).
+        """
+        if is_cpu_arch(self.arch):
+            raise NotImplementedError("FlashAttentionTemplate has no CPU kernel generator")
+        batch, heads, dim = self.batch_size, self.num_heads, self.head_dim
+        seq_q, seq_kv, is_causal = self.seq_length, self.seq_kv_length, self.is_causal
+        dtype, out_dtype = self.in_dtype, self.out_dtype
+        accum_dtype = "float"
+        config = gemm_tile_config(hint, self.arch)
+        block_M, block_N = config["block_M"], config["block_K"]
+        num_stages, threads = config["num_stages"], config["threads"]
+        scale = (1.0 / dim)**0.5 * 1.44269504  # log2(e)
+        q_shape = [batch, heads, seq_q, dim]
+        kv_shape = [batch, heads, seq_kv, dim]
+
+        @T.prim_func
+        def main(
+                Q: T.Tensor(q_shape, dtype),
+                K: T.Tensor(kv_shape, dtype),
+                V: T.Tensor(kv_shape, dtype),
+                Output: T.Tensor(q_shape, out_dtype),
+        ):
+            with T.Kernel(T.ceildiv(seq_q, block_M), heads, batch, threads=threads) as (bx, by, bz):
+                Q_shared = T.alloc_shared([block_M, dim], dtype)
+                K_shared = T.alloc_shared([block_N, dim], dtype)
+                V_shared = T.alloc_shared([block_N, dim], dtype)
+                acc_s = T.alloc_fragment([block_M, block_N], accum_dtype)
+                acc_s_cast = T.alloc_fragment([block_M, block_N], dtype)
+                acc_o = T.alloc_fragment([block_M, dim], accum_dtype)
+                scores_max = T.alloc_fragment([block_M], accum_dtype)
+                scores_max_prev = T.alloc_fragment([block_M], accum_dtype)
+                scores_scale = T.alloc_fragment([block_M], accum_dtype)
+                scores_sum = T.alloc_fragment([block_M], accum_dtype)
+                logsum = T.alloc_fragment([block_M], accum_dtype)
+
+                T.copy(Q[bz, by, bx * block_M:(bx + 1) * block_M, :], Q_shared)
+                T.fill(acc_o, 0)
+                T.fill(logsum, 0)
+                T.fill(scores_max, -T.infinity(accum_dtype))
+
+                loop_range = (
+                    T.min(T.ceildiv(seq_kv, block_N), T.ceildiv(
+                        (bx + 1) * block_M, block_N)) if is_causal else T.ceildiv(seq_kv, block_N))
+
+                for k in T.Pipelined(loop_range, num_stages=num_stages):
+                    T.copy(K[bz, by, k * block_N:(k + 1) * block_N, :], K_shared)
+                    if is_causal:
+                        for i, j in T.Parallel(block_M, block_N):
+                            acc_s[i, j] = T.if_then_else(bx * block_M + i + seq_kv - seq_q
+                                                         >= k * block_N + j, 0,
+                                                         -T.infinity(acc_s.dtype))
+                    else:
+                        T.clear(acc_s)
+                    T.gemm(
+                        Q_shared, K_shared, acc_s, transpose_B=True,
+                        policy=T.GemmWarpPolicy.FullRow)
+                    T.copy(scores_max, scores_max_prev)
+                    T.fill(scores_max, -T.infinity(accum_dtype))
+                    T.reduce_max(acc_s, scores_max, dim=1, clear=False)
+                    for i in T.Parallel(block_M):
+                        scores_scale[i] = T.exp2(scores_max_prev[i] * scale - scores_max[i] * scale)
+                    for i, j in T.Parallel(block_M, block_N):
+                        acc_s[i, j] = T.exp2(acc_s[i, j] * scale - scores_max[i] * scale)
+                    T.reduce_sum(acc_s, scores_sum, dim=1)
+                    for i in T.Parallel(block_M):
+                        logsum[i] = logsum[i] * scores_scale[i] + scores_sum[i]
+                    T.copy(acc_s, acc_s_cast)
+                    for i, j in T.Parallel(block_M, dim):
+                        acc_o[i, j] *= scores_scale[i]
+                    T.copy(V[bz, by, k * block_N:(k + 1) * block_N, :], V_shared)
+                    T.gemm(acc_s_cast, V_shared, acc_o, policy=T.GemmWarpPolicy.FullRow)
+                for i, j in T.Parallel(block_M, dim):
+                    acc_o[i, j] /= logsum[i]
+                T.copy(acc_o, Output[bz, by, bx * block_M:(bx + 1) * block_M, :])
+
+        return main
+
     def initialize_function(self) -> None:
         """
         Defines and initializes the matrix multiplication computation.
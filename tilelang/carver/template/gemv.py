@@ -1,10 +1,13 @@
 from dataclasses import dataclass
 from .base import BaseTemplate
 from tvm import te
-from ..arch import TileDevice
+from tvm.tir import PrimFunc
+from ..arch import TileDevice, is_cpu_arch
 from ..roller import Hint
 from typing import List
 from ..utils import get_roller_hints_from_func
+from .kernel_utils import block_threads, cpu_tile_hints, dtype_bytes
+import tilelang.language as T
 
 
 @dataclass
@@ -39,6 +42,125 @@ class GEMVTemplate(BaseTemplate):
         roller_hints = get_roller_hints_from_func(self._func, arch=arch, topk=topk)
         return roller_hints
 
+    def get_cpu_configs(self, topk: int = 10) -> List[Hint]:
+        """
+        Enumerates CPU tiles block_N x block_K dividing the problem, preferring
+        the largest weight tiles that stay in the data cache.
+        """
+        in_bytes = dtype_bytes(self.in_dtype)
+
+        def footprint(block, rstep):
+            (_, block_N), (block_K,) = block, rstep
+            return (block_N + 1) * block_K * in_bytes
+
+        return cpu_tile_hints([1, self.N], [self.K], footprint, topk)
+
+    def get_kernel(self, hint: Hint) -> PrimFunc:
+        """
+        Instantiates the canonical GEMV with the tile sizes of the hint: every
+        block owns block_N outputs, accumulates block_N x block_K partial
+        products per K step and reduces them at the end.
+
+        Args:
+            hint (Hint): A configuration returned by `recommend_hints`.
+
+        Returns:
+            PrimFunc: The TileLang program, taking (A, B, [Bias,] C).
+        """
+        N, K = self.N, self.K
+        trans_B = self.trans_B
+        in_dtype, out_dtype, accum_dtype = self.in_dtype, self.out_dtype, self.accum_dtype
+        B_shape = (K, N) if not trans_B else (N, K)
+        block_N, block_K = int(hint.block[-1]), int(hint.rstep[-1])
+        B_tile = (block_K, block_N) if not trans_B else (block_N, block_K)
+
+        def b_index(k, n):
+            return (k, n) if not trans_B else (n, k)
+
+        if is_cpu_arch(self.arch):
+
+            @T.macro
+            def cpu_mainloop(A, B, C_local, bx):
+                T.clear(C_local)
+                for ko in T.serial(K // block_K):
+                    for k, j in T.grid(block_K, block_N):
+                        C_local[j] += T.Cast(accum_dtype, A[0, ko * block_K + k]) * T.Cast(
+                            accum_dtype, B[b_index(ko * block_K + k, bx * block_N + j)])
+
+            @T.prim_func
+            def cpu_main(
+                    A: T.Tensor((1, K), in_dtype),
+                    B: T.Tensor(B_shape, in_dtype),
+                    C: T.Tensor((1, N), out_dtype),
+            ):
+                with T.Kernel(N // block_N, is_cpu=True, parallel=True) as bx:
+                    C_local = T.alloc_local((block_N,), accum_dtype)
+                    cpu_mainloop(A, B, C_local, bx)
+                    for j in T.serial(block_N):
+                        C[0, bx * block_N + j] = T.Cast(out_dtype, C_local[j])
+
+            @T.prim_func
+            def cpu_main_with_bias(
+                    A: T.Tensor((1, K), in_dtype),
+                    B: T.Tensor(B_shape, in_dtype),
+                    Bias: T.Tensor((N,), accum_dtype),
+                    C: T.Tensor((1, N), out_dtype),
+            ):
+                with T.Kernel(N // block_N, is_cpu=True, parallel=True) as bx:
+                    C_local = T.alloc_local((block_N,), accum_dtype)
+                    cpu_mainloop(A, B, C_local, bx)
+                    for j in T.serial(block_N):
+                        C[0, bx * block_N + j] = T.Cast(out_dtype,
+                                                        C_local[j] + Bias[bx * block_N + j])
+
+            return cpu_main_with_bias if self.with_bias else cpu_main
+
+        threads = block_threads(hint, self.arch)
+
+        @T.macro
+        def mainloop(A, B, A_shared, B_shared, acc, C_local, bx):
+            T.clear(acc)
+            for ko in T.Pipelined(T.ceildiv(K, block_K), num_stages=0):
+                T.copy(A[0, ko * block_K], A_shared)
+                T.copy(B[b_index(ko * block_K, bx * block_N)], B_shared)
+                for j, k in T.Parallel(block_N, block_K):
+                    acc[j, k] += T.Cast(accum_dtype, A_shared[0, k]) * T.Cast(
+                        accum_dtype, B_shared[b_index(k, j)])
+            T.reduce_sum(acc, C_local, dim=1)
+
+        @T.prim_func
+        def main(
+                A: T.Tensor((1, K), in_dtype),
+                B: T.Tensor(B_shape, in_dtype),
+                C: T.Tensor((1, N), out_dtype),
+        ):
+            with T.Kernel(T.ceildiv(N, block_N), threads=threads) as bx:
+                A_shared = T.alloc_shared((1, block_K), in_dtype)
+                B_shared = T.alloc_shared(B_tile, in_dtype)
+                acc = T.alloc_fragment((block_N, block_K), accum_dtype)
+                C_local = T.alloc_fragment((block_N,), accum_dtype)
+                mainloop(A, B, A_shared, B_shared, acc, C_local, bx)
+                for j in T.Parallel(block_N):
+                    C[0, bx * block_N + j] = T.Cast(out_dtype, C_local[j])
+
+        @T.prim_func
+        def main_with_bias(
+                A: T.Tensor((1, K), in_dtype),
+                B: T.Tensor(B_shape, in_dtype),
+                Bias: T.Tensor((N,), accum_dtype),
+                C: T.Tensor((1, N), out_dtype),
+        ):
+            with T.Kernel(T.ceildiv(N, block_N), threads=threads) as bx:
+                A_shared = T.alloc_shared((1, block_K), in_dtype)
+                B_shared = T.alloc_shared(B_tile, in_dtype)
+                acc = T.alloc_fragment((block_N, block_K), accum_dtype)
+                C_local = T.alloc_fragment((block_N,), accum_dtype)
+                mainloop(A, B, A_shared, B_shared, acc, C_local, bx)
+                for j in T.Parallel(block_N):
+                    C[0, bx * block_N + j] = T.Cast(out_dtype, C_local[j] + Bias[bx * block_N + j])
+
+        return main_with_bias if self.with_bias else main
+
     def initialize_function(self) -> None:
         """
         Defines and initializes the GEMV computation function.
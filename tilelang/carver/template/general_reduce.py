@@ -1,10 +1,15 @@
 from dataclasses import dataclass
 from .base import BaseTemplate
 from tvm import te
-from ..arch import TileDevice
+from tvm.tir import PrimFunc
+from ..arch import TileDevice, is_cpu_arch
 from ..roller import Hint
-from typing import List, Union
+from typing import List, Tuple, Union
 from ..utils import get_roller_hints_from_func
+from .kernel_utils import block_threads, cpu_tile_hints, dtype_bytes
+import tilelang.language as T
+import math
+import re
 
 
 @dataclass
@@ -20,6 +25,122 @@ class GeneralReductionTemplate(BaseTemplate):
             self._func, arch=arch, topk=topk, allow_gemv=False)
         return roller_hints
 
+    def _reduce_view(self) -> Tuple[int, int, int]:
+        """
+        Views the input as (outer, reduce, inner) for structures of the form
+        S*R+S*, the only ones the kernel generators support.
+        """
+        structure = self.structure.upper()
+        match = re.fullmatch(r"(S*)(R+)(S*)", structure)
+        if match is None or "S" not in structure:
+            raise NotImplementedError(
+                f"Kernel generation needs a structure of the form S*R+S*, got {self.structure}")
+        outer_end, inner_begin = match.end(1), match.start(3)
+        return (math.prod(self.shape[:outer_end]), math.prod(self.shape[outer_end:inner_begin]),
+                math.prod(self.shape[inner_begin:]))
+
+    def get_cpu_configs(self, topk: int = 10) -> List[Hint]:
+        """
+        Enumerates CPU tiles of the spatial axes and reduction steps dividing
+        the problem, preferring the largest input tiles that stay in the data cache.
+        """
+        elem_bytes = dtype_bytes(self.dtype)
+        spatial = [e for e, a in zip(self.shape, self.structure.upper()) if a == "S"]
+        reduce = [e for e, a in zip(self.shape, self.structure.upper()) if a == "R"]
+
+        def footprint(block, rstep):
+            return math.prod(block) * (math.prod(rstep) * elem_bytes + 4)
+
+        return cpu_tile_hints(spatial, reduce, footprint, topk)
+
+    def get_kernel(self, hint: Hint) -> PrimFunc:
+        """
+        Instantiates a sum reduction with the tile sizes of the hint. The input
+        is viewed as (outer, reduce, inner): trailing reductions reduce a
+        block_outer x rstep tile across threads, other reductions accumulate
+        rows of block_outer x block_inner elements per step.
+
+        Args:
+            hint (Hint): A configuration returned by `recommend_hints`.
+
+        Returns:
+            PrimFunc: The TileLang program, taking (A, C).
+        """
+        outer, reduce, inner = self._reduce_view()
+        dtype = self.dtype
+        accum_dtype = "float32" if dtype in ("float16", "bfloat16") else dtype
+        spatial_shape = [e for e, a in zip(self.shape, self.structure.upper()) if a == "S"]
+        num_outer = len(re.match(r"S*", self.structure.upper()).group(0))
+        block_outer = min(math.prod(hint.block[:num_outer]), outer)
+        block_inner = min(math.prod(hint.block[num_outer:]), inner)
+        rstep = math.gcd(math.prod(hint.rstep), reduce)
+
+        if is_cpu_arch(self.arch):
+
+            @T.prim_func
+            def cpu_main(
+                    A: T.Tensor(self.shape, dtype),
+                    C: T.Tensor(spatial_shape, dtype),
+            ):
+                with T.Kernel(
+                        inner // block_inner, outer // block_outer, is_cpu=True,
+                        parallel=True) as (bx, by):
+                    A_view = T.Tensor((outer, reduce, inner), dtype, A.data)
+                    C_view = T.Tensor((outer, inner), dtype, C.data)
+                    acc = T.alloc_local((block_outer, block_inner), accum_dtype)
+                    T.clear(acc)
+                    for ko in T.serial(reduce // rstep):
+                        for i, k, j in T.grid(block_outer, rstep, block_inner):
+                            acc[i, j] += T.Cast(
+                                accum_dtype, A_view[by * block_outer + i, ko * rstep + k,
+                                                    bx * block_inner + j])
+                    for i, j in T.grid(block_outer, block_inner):
+                        C_view[by * block_outer + i, bx * block_inner + j] = T.Cast(dtype, acc[i, j])
+
+            return cpu_main
+
+        threads = block_threads(hint, self.arch)
+
+        @T.prim_func
+        def trailing_main(
+                A: T.Tensor(self.shape, dtype),
+                C: T.Tensor(spatial_shape, dtype),
+        ):
+            with T.Kernel(T.ceildiv(outer, block_outer), threads=threads) as bx:
+                A_view = T.Tensor((outer, reduce), dtype, A.data)
+                C_view = T.Tensor((outer,), dtype, C.data)
+                acc = T.alloc_fragment((block_outer, rstep), accum_dtype)
+                C_local = T.alloc_fragment((block_outer,), accum_dtype)
+                T.clear(acc)
+                for ko in T.serial(reduce // rstep):
+                    for i, k in T.Parallel(block_outer, rstep):
+                        acc[i, k] += T.Cast(accum_dtype, A_view[bx * block_outer + i,
+                                                                ko * rstep + k])
+                T.reduce_sum(acc, C_local, dim=1)
+                for i in T.Parallel(block_outer):
+                    C_view[bx * block_outer + i] = T.Cast(dtype, C_local[i])
+
+        @T.prim_func
+        def main(
+                A: T.Tensor(self.shape, dtype),
+                C: T.Tensor(spatial_shape, dtype),
+        ):
+            with T.Kernel(
+                    T.ceildiv(inner, block_inner), T.ceildiv(outer, block_outer),
+                    threads=threads) as (bx, by):
+                A_view = T.Tensor((outer, reduce, inner), dtype, A.data)
+                C_view = T.Tensor((outer, inner), dtype, C.data)
+                acc = T.alloc_fragment((block_outer, block_inner), accum_dtype)
+                T.clear(acc)
+                for k in T.serial(reduce):
+                    for i, j in T.Parallel(block_outer, block_inner):
+                        acc[i, j] += T.Cast(
+                            accum_dtype, A_view[by * block_outer + i, k, bx * block_inner + j])
+                for i, j in T.Parallel(block_outer, block_inner):
+                    C_view[by * block_outer + i, bx * block_inner + j] = T.Cast(dtype, acc[i, j])
+
+        return trailing_main if inner == 1 else main
+
     def initialize_function(self) -> None:
         """
         Parse the structure (e.g., 'SSR'), build the TVM compute definition
@@ -0,0 +1,153 @@
+"""Helpers shared by the template kernel generators.
+
+The roller emits `Hint`s in terms of tiles of the template's compute
+definition. The helpers here translate those hints into the tile parameters
+of the canonical TileLang kernels, produce hints for the CPU target (for which
+the roller has no hardware model), time kernels on the host and measure the
+memory bandwidth kernels are compared against.
+"""
+import math
+import time
+import itertools
+from typing import Callable, Dict, List, Sequence
+
+import torch
+from tvm import DataType
+
+from ..arch import TileDevice, is_cpu_arch
+from ..roller.hint import Hint
+from ..roller.rasterization import NoRasterization
+
+# Data cache budget used to size CPU tiles
+CPU_TILE_CACHE_BYTES = 32 * 1024
+
+
+def dtype_bytes(dtype: str) -> int:
+    return max(DataType(dtype).bits // 8, 1)
+
+
+def warp_size_of(arch: TileDevice) -> int:
+    return arch.warp_size if getattr(arch, "warp_size", 0) else 32
+
+
+def gemm_tile_config(hint: Hint, arch: TileDevice) -> Dict[str, int]:
+    """Map a matmul-like hint onto the tile parameters of a T.gemm kernel.
+
+    Tensor core hints carry a warp tile, other hints a per-thread tile whose
+    product is the number of threads of the block.
+    """
+    warp_size = warp_size_of(arch)
+    block_M, block_N = int(hint.block[-2]), int(hint.block[-1])
+    if hint.use_tc:
+        warp_M, warp_N = int(hint.warp[-2]), int(hint.warp[-1])
+        threads = (block_M // warp_M) * (block_N // warp_N) * warp_size
+    else:
+        threads = int(math.prod(hint.thread))
+        threads = max(warp_size, (threads + warp_size - 1) // warp_size * warp_size)
+    return {
+        "block_M": block_M,
+        "block_N": block_N,
+        "block_K": int(hint.rstep[0]),
+        "num_stages": hint.pipeline_stage if hint.pipeline_stage > 1 else 0,
+        "threads": threads,
+        "enable_rasterization": not isinstance(hint.rasterization_plan, NoRasterization),
+    }
+
+
+def block_threads(hint: Hint, arch: TileDevice) -> int:
+    """Number of threads of a non tensor core hint, a multiple of the warp size."""
+    warp_size = warp_size_of(arch)
+    threads = int(math.prod(hint.thread)) * int(math.prod(hint.reduce_thread or [1]))
+    return max(warp_size, (threads + warp_size - 1) // warp_size * warp_size)
+
+
+def _tile_candidates(extent: int, max_tile: int = 256) -> List[int]:
+    candidates = [t for t in (2**i for i in range(9)) if t <= max_tile and extent % t == 0]
+    if extent <= max_tile and extent not in candidates:
+        candidates.append(extent)
+    return candidates or [1]
+
+
+def cpu_tile_hints(spatial: Sequence[int],
+                   reduce: Sequence[int],
+                   footprint: Callable[[List[int], List[int]], int],
+                   topk: int = 10,
+                   cache_bytes: int = CPU_TILE_CACHE_BYTES) -> List[Hint]:
+    """Enumerate CPU tiles that divide the problem, ranked by cache reuse.
+
+    Tiles whose footprint (in bytes) fits into `cache_bytes` are preferred,
+    larger ones first since they amortise more loads per output; the remaining
+    tiles follow from the smallest footprint up.
+    """
+    spatial_candidates = [_tile_candidates(extent) for extent in spatial]
+    reduce_candidates = [_tile_candidates(extent, 64) for extent in reduce]
+    scored = []
+    for block in itertools.product(*spatial_candidates):
+        for rstep in itertools.product(*reduce_candidates):
+            size = footprint(list(block), list(rstep))
+            fits = size <= cache_bytes
+            scored.append(((0, -size) if fits else (1, size), list(block), list(rstep)))
+    scored.sort(key=lambda item: item[0])
+    hints = []
+    for _, block, rstep in scored[:topk]:
+        hint = Hint()
+        hint.block = block
+        hint.thread = [1 for _ in block]
+        hint.rstep = rstep
+        hints.append(hint)
+    return hints
+
+
+def make_cpu_inputs(params) -> List[torch.Tensor]:
+    tensors = []
+    for param in params:
+        shape = [int(s) for s in param.shape]
+        if param.dtype.is_floating_point:
+            tensors.append(torch.randn(*shape).to(param.dtype))
+        else:
+            tensors.append(torch.randint(-4, 4, shape).to(param.dtype))
+    return tensors
+
+
+def bench_cpu(kernel, warmup: int = 3, rep: int = 10) -> float:
+    """Average wall time of a CPU kernel in milliseconds."""
+    tensors = make_cpu_inputs(kernel.params)
+    for _ in range(warmup):
+        kernel(*tensors)
+    start = time.perf_counter()
+    for _ in range(rep):
+        kernel(*tensors)
+    return (time.perf_counter() - start) * 1e3 / rep
+
+
+def measure_stream_bandwidth(arch: TileDevice, nbytes: int = 1 << 28, rep: int = 10) -> float:
+    """STREAM-style copy bandwidth in GB/s of the memory the arch's kernels run on.
+
+    Both the bytes read and the bytes written count, as in STREAM. The host is
+    measured for the CPU, the current CUDA device otherwise.
+    """
+    numel = nbytes // 4
+    if is_cpu_arch(arch):
+        src, dst = torch.randn(numel), torch.empty(numel)
+        dst.copy_(src)
+        start = time.perf_counter()
+        for _ in range(rep):
+            dst.copy_(src)
+        seconds = (time.perf_counter() - start) / rep
+    else:
+        src = torch.randn(numel, device="cuda")
+        dst = torch.empty_like(src)
+        dst.copy_(src)
+        begin, end = torch.cuda.Event(enable_timing=True), torch.cuda.Event(enable_timing=True)
+        begin.record()
+        for _ in range(rep):
+            dst.copy_(src)
+        end.record()
+        torch.cuda.synchronize()
+        seconds = begin.elapsed_time(end) * 1e-3 / rep
+    return 2 * numel * 4 / seconds * 1e-9
+
+
+def compile_target(arch: TileDevice):
+    """Target handed to tilelang.compile for kernels of the given arch."""
+    return "c" if is_cpu_arch(arch) else arch.target
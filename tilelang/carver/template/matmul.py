@@ -1,10 +1,13 @@
 from dataclasses import dataclass
 from .base import BaseTemplate
 from tvm import te
-from ..arch import TileDevice
+from tvm.tir import PrimFunc
+from ..arch import TileDevice, is_cpu_arch
 from ..roller import Hint
 from typing import List
 from ..utils import get_roller_hints_from_func
+from .kernel_utils import gemm_tile_config, cpu_tile_hints, dtype_bytes
+import tilelang.language as T
 
 
 @dataclass
@@ -52,6 +55,132 @@ class MatmulTemplate(BaseTemplate):
         roller_hints = get_roller_hints_from_func(self._func, arch=arch, topk=topk, allow_gemv=True)
         return roller_hints
 
+    def get_cpu_configs(self, topk: int = 10) -> List[Hint]:
+        """
+        Enumerates CPU tiles (block_M, block_N) x block_K dividing the problem,
+        preferring the largest A, B and C tiles that stay in the data cache.
+        """
+        in_bytes, accum_bytes = dtype_bytes(self.in_dtype), dtype_bytes(self.accum_dtype)
+
+        def footprint(block, rstep):
+            (block_M, block_N), (block_K,) = block, rstep
+            return ((block_M + block_N) * block_K * in_bytes + block_M * block_N * accum_bytes)
+
+        return cpu_tile_hints([self.M, self.N], [self.K], footprint, topk)
+
+    def get_kernel(self, hint: Hint) -> PrimFunc:
+        """
+        Instantiates the canonical tiled GEMM with the tile sizes of the hint:
+        shared memory staging, a pipelined K loop and T.gemm on GPUs, and a
+        local accumulator tile on the CPU.
+
+        Args:
+            hint (Hint): A configuration returned by `recommend_hints`.
+
+        Returns:
+            PrimFunc: The TileLang program, taking (A, B, [Bias,] C).
+        """
+        M, N, K = self.M, self.N, self.K
+        trans_A, trans_B = self.trans_A, self.trans_B
+        in_dtype, out_dtype, accum_dtype = self.in_dtype, self.out_dtype, self.accum_dtype
+        A_shape = (M, K) if not trans_A else (K, M)
+        B_shape = (K, N) if not trans_B else (N, K)
+
+        def a_index(m, k):
+            return (m, k) if not trans_A else (k, m)
+
+        def b_index(k, n):
+            return (k, n) if not trans_B else (n, k)
+
+        if is_cpu_arch(self.arch):
+            (block_M, block_N), (block_K,) = hint.block, hint.rstep
+
+            @T.macro
+            def cpu_mainloop(A, B, C_local, bx, by):
+                T.clear(C_local)
+                for ko in T.serial(K // block_K):
+                    for i, k, j in T.grid(block_M, block_K, block_N):
+                        C_local[i, j] += T.Cast(
+                            accum_dtype, A[a_index(by * block_M + i, ko * block_K + k)]) * T.Cast(
+                                accum_dtype, B[b_index(ko * block_K + k, bx * block_N + j)])
+
+            @T.prim_func
+            def cpu_main(
+                    A: T.Tensor(A_shape, in_dtype),
+                    B: T.Tensor(B_shape, in_dtype),
+                    C: T.Tensor((M, N), out_dtype),
+            ):
+                with T.Kernel(N // block_N, M // block_M, is_cpu=True, parallel=True) as (bx, by):
+                    C_local = T.alloc_local((block_M, block_N), accum_dtype)
+                    cpu_mainloop(A, B, C_local, bx, by)
+                    for i, j in T.grid(block_M, block_N):
+                        C[by * block_M + i, bx * block_N + j] = T.Cast(out_dtype, C_local[i, j])
+
+            @T.prim_func
+            def cpu_main_with_bias(
+                    A: T.Tensor(A_shape, in_dtype),
+                    B: T.Tensor(B_shape, in_dtype),
+                    Bias: T.Tensor((N,), accum_dtype),
+                    C: T.Tensor((M, N), out_dtype),
+            ):
+                with T.Kernel(N // block_N, M // block_M, is_cpu=True, parallel=True) as (bx, by):
+                    C_local = T.alloc_local((block_M, block_N), accum_dtype)
+                    cpu_mainloop(A, B, C_local, bx, by)
+                    for i, j in T.grid(block_M, block_N):
+                        C[by * block_M + i, bx * block_N + j] = T.Cast(
+                            out_dtype, C_local[i, j] + Bias[bx * block_N + j])
+
+            return cpu_main_with_bias if self.with_bias else cpu_main
+
+        config = gemm_tile_config(hint, self.arch)
+        block_M, block_N, block_K = config["block_M"], config["block_N"], config["block_K"]
+        num_stages, threads = config["num_stages"], config["threads"]
+        enable_rasterization = config["enable_rasterization"]
+        A_shared_shape = (block_M, block_K) if not trans_A else (block_K, block_M)
+        B_shared_shape = (block_K, block_N) if not trans_B else (block_N, block_K)
+
+        @T.macro
+        def mainloop(A, B, A_shared, B_shared, C_local, bx, by):
+            T.use_swizzle(panel_size=10, enable=enable_rasterization)
+            T.clear(C_local)
+            for ko in T.Pipelined(T.ceildiv(K, block_K), num_stages=num_stages):
+                T.copy(A[a_index(by * block_M, ko * block_K)], A_shared)
+                T.copy(B[b_index(ko * block_K, bx * block_N)], B_shared)
+                T.gemm(A_shared, B_shared, C_local, trans_A, trans_B)
+
+        @T.prim_func
+        def main(
+                A: T.Tensor(A_shape, in_dtype),
+                B: T.Tensor(B_shape, in_dtype),
+                C: T.Tensor((M, N), out_dtype),
+        ):
+            with T.Kernel(
+                    T.ceildiv(N, block_N), T.ceildiv(M, block_M), threads=threads) as (bx, by):
+                A_shared = T.alloc_shared(A_shared_shape, in_dtype)
+                B_shared = T.alloc_shared(B_shared_shape, in_dtype)
+                C_local = T.alloc_fragment((block_M, block_N), accum_dtype)
+                mainloop(A, B, A_shared, B_shared, C_local, bx, by)
+                T.copy(C_local, C[by * block_M, bx * block_N])
+
+        @T.prim_func
+        def main_with_bias(
+                A: T.Tensor(A_shape, in_dtype),
+                B: T.Tensor(B_shape, in_dtype),
+                Bias: T.Tensor((N,), accum_dtype),
+                C: T.Tensor((M, N), out_dtype),
+        ):
+            with T.Kernel(
+                    T.ceildiv(N, block_N), T.ceildiv(M, block_M), threads=threads) as (bx, by):
+                A_shared = T.alloc_shared(A_shared_shape, in_dtype)
+                B_shared = T.alloc_shared(B_shared_shape, in_dtype)
+                C_local = T.alloc_fragment((block_M, block_N), accum_dtype)
+                mainloop(A, B, A_shared, B_shared, C_local, bx, by)
+                for i, j in T.Parallel(block_M, block_N):
+                    C_local[i, j] += Bias[bx * block_N + j]
+                T.copy(C_local, C[by * block_M, bx * block_N])
+
+        return main_with_bias if self.with_bias else main
+
     def initialize_function(self) -> None:
         """
         Defines and initializes the matrix multiplication computation.
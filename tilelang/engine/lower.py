@@ -172,12 +172,15 @@ def device_codegen_without_compile(device_mod: tvm.IRModule, target: Target) ->
     device_mod = tilelang.transform.LowerDeviceStorageAccessInfo()(device_mod)
     device_mod = tir.transform.LowerIntrin()(device_mod)
     device_mod = tir.transform.Simplify()(device_mod)
-    if target.kind.name == "cuda":
-        device_mod = tvm._ffi.get_global_func("target.build.tilelang_cuda_without_compile")(
-            device_mod, target)
-    elif target.kind.name == "hip":
-        device_mod = tvm._ffi.get_global_func("target.build.tilelang_hip_without_compile")(
-            device_mod, target)
+    if target.kind.name in ("cuda", "hip"):
+        # Builds without the CUDA/ROCm runtime (cross-compilation hosts) only
+        # have the source generators.
+        kind = "cuda" if target.kind.name == "cuda" else "hip"
+        build = tvm._ffi.get_global_func(
+            f"target.build.tilelang_{kind}_without_compile", allow_missing=True)
+        if build is None:
+            build = tvm._ffi.get_global_func(f"target.build.tilelang_{kind}_source")
+        device_mod = build(device_mod, target)
     elif target.kind.name == "c":
         device_mod = tvm._ffi.get_global_func("target.build.tilelang_cpp")(device_mod, target)
     elif target.kind.name == "llvm":
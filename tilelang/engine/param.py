@@ -115,3 +115,25 @@ class CompiledArtifact:
     kernel_source: str  # Raw source code of the generated kernel
     rt_mod: Optional[
         tvm.runtime.Module] = None  # Runtime module for execution, may be lazily initialized
+
+    def check_outputs(self, out_idx: Optional[Union[List[int], int]]) -> None:
+        """
+        Rejects outputs that the kernel reduces into with atomic additions, since the
+        adapters allocate outputs uninitialized (see DecomposeKLoop).
+        """
+        if out_idx is None or self.params is None:
+            return
+        out_idx = [out_idx] if isinstance(out_idx, int) else out_idx
+        outputs = {idx % len(self.params) for idx in out_idx}
+        for mod in (self.host_mod, self.device_mod):
+            if not isinstance(mod, tvm.IRModule):
+                continue
+            for _, func in mod.functions.items():
+                if func.attrs is None or "tl.atomic_outputs" not in func.attrs:
+                    continue
+                for idx in func.attrs["tl.atomic_outputs"]:
+                    if int(idx) in outputs:
+                        raise ValueError(
+                            f"Parameter {int(idx)} is accumulated with atomic additions by "
+                            "split-K or stream-K and must be zero-initialized by the caller; "
+                            "pass it as an input instead of listing it in out_idx.")
@@ -70,10 +70,18 @@ def LowerAndLegalize(mod: IRModule, target: Target) -> IRModule:
     mod = tilelang.transform.FrontendLegalize()(mod)
     # Simplify the IR expressions
     mod = tir.transform.Simplify()(mod)
+    # Distribute the K loop of GEMM kernels (split-K / stream-K) when requested
+    mod = tilelang.transform.DecomposeKLoop()(mod)
+    # Remove shared memory round trips (invariant reloads, opt-in fragment staging)
+    mod = tilelang.transform.ForwardStagingBuffers()(mod)
+    # Drop tile writes that are overwritten before being read
+    mod = tilelang.transform.EliminateDeadTileWrites()(mod)
     # Infer memory layouts for fragments and shared memory
     mod = tilelang.transform.LayoutInference()(mod)
     # Lower high-level tile operations to low-level operations
     mod = tilelang.transform.LowerTileOp()(mod)
+    # Reorder and register tile serial loop nests of CPU kernels
+    mod = tilelang.transform.OptimizeCPULoopNest()(mod)
     # Lower l2 persistent map
     mod = tilelang.transform.LowerL2Persistent()(mod)
     # Legalize vectorized loops to ensure they are valid
@@ -126,6 +134,10 @@ def OptimizeForTarget(mod: IRModule, target: Target) -> IRModule:
             mod = tilelang.transform.InjectFenceProxy()(mod)
 
     mod = tir.transform.LowerOpaqueBlock()(mod)
+    # Hoist invariant loads and predicates out of pipelined and inner loops
+    mod = tilelang.transform.LoopInvariantCodeMotion()(mod)
+    # Keep accumulators of reduction loops in registers
+    mod = tilelang.transform.RegisterPromotion()(mod)
     mod = tir.transform.NarrowDataType(32)(mod)
     mod = tilelang.transform.ConfigIndexBitwidth()(mod)
     mod = tilelang.transform.FlattenBuffer()(mod)
@@ -133,7 +145,11 @@ def OptimizeForTarget(mod: IRModule, target: Target) -> IRModule:
 
     mod = tilelang.transform.VectorizeLoop(enable_vectorize=allow_vectorize(pass_ctx=pass_ctx))(mod)
     mod = tir.transform.StorageRewrite()(mod)
+    # Unroll small per-thread loops explicitly so their indices fold
+    mod = tilelang.transform.CostBasedUnroll()(mod)
     mod = tir.transform.UnrollLoop()(mod)
+    # Pack the straight-line code of unrolled fragment loops into vectors
+    mod = tilelang.transform.SLPVectorize()(mod)
     mod = tir.transform.RenormalizeSplitPattern()(mod)
     mod = tir.transform.Simplify()(mod)
     mod = tir.transform.RemoveNoOp()(mod)
@@ -178,6 +194,8 @@ def OptimizeForTarget(mod: IRModule, target: Target) -> IRModule:
     # Inject PTX async copy must behind the thread sync pass
     # as ptx async copy won't be recognized as a valid buffer load
     mod = tilelang.transform.InjectPTXAsyncCopy()(mod)
+    # Hoist the loop invariant part of buffer indices out of loops
+    mod = tilelang.transform.StrengthReduceIndex()(mod)
 
     mod = tilelang.transform.MakePackedAPI()(mod)
     mod = tir.transform.LowerDeviceKernelLaunch()(mod)
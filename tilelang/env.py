@@ -77,6 +77,14 @@ TILELANG_CACHE_DIR: str = os.environ.get("TILELANG_CACHE_DIR",
 # Auto-clear cache if environment variable is set
 TILELANG_CLEAR_CACHE = os.environ.get("TILELANG_CLEAR_CACHE", "0")
 
+# Route cache misses to a node-local compile daemon (see tilelang.cache.compile_daemon),
+# falling back to in-process compilation when no daemon is listening
+TILELANG_COMPILE_DAEMON: str = os.environ.get("TILELANG_COMPILE_DAEMON", "0")
+
+# Unix socket of the compile daemon, default is <TILELANG_CACHE_DIR>/compile_daemon.sock
+TILELANG_COMPILE_DAEMON_SOCKET: str = os.environ.get(
+    "TILELANG_COMPILE_DAEMON_SOCKET", os.path.join(TILELANG_CACHE_DIR, "compile_daemon.sock"))
+
 # CPU Utilizations for Auto-Tuning, default is 0.9
 TILELANG_AUTO_TUNING_CPU_UTILITIES: str = os.environ.get("TILELANG_AUTO_TUNING_CPU_UTILITIES",
                                                          "0.9")
@@ -25,6 +25,7 @@ from os import path, makedirs
 from logging import getLogger
 import functools
 from tilelang.jit.param import Kernel, _P, _RProg
+from tilelang.jit.symbolic import SymbolicProgramCache
 
 logger = getLogger(__name__)
 
@@ -145,6 +146,8 @@ class _JitImplementation:
                 self.debug_root_path = path.abspath(self.debug_root_path)
 
         self._kernel_cache: Dict[tuple, Kernel] = {}
+        # symbolic parameter names -> programs parsed once for a tuning sweep
+        self._program_caches: Dict[Tuple[str, ...], SymbolicProgramCache] = {}
 
     # This tells the type checker what the *wrapper* function will return.
     # this is for linting, please do not remove it.
@@ -166,6 +169,8 @@ class _JitImplementation:
         def wrapper(*args: _P.args, **kwargs: _P.kwargs) -> Any:
             # Separate out the tuning parameters from the user's kwargs
             tune_params = kwargs.pop('__tune_params', {})
+            # Tuning parameters the autotuner asks to parse as symbolic placeholders
+            symbolic_params = tuple(kwargs.pop('__symbolic_params', None) or ())
             # Whether to return the compile arguments (out_idx, target, target_host, etc.) for autotuner cache
             return_compile_arguments = kwargs.pop('__return_compile_arguments', False)
             if return_compile_arguments:
@@ -189,6 +194,14 @@ class _JitImplementation:
                 program_result_source = func
                 if isinstance(program_result_source, PrimFunc):
                     program_result = program_result_source
+                elif callable(program_result_source) and symbolic_params:
+                    # autotuner compiles configurations from several threads
+                    program_cache = self._program_caches.get(symbolic_params)
+                    if program_cache is None:
+                        program_cache = self._program_caches.setdefault(
+                            symbolic_params,
+                            SymbolicProgramCache(program_result_source, symbolic_params))
+                    program_result = program_cache(*args, **kwargs, **tune_params)
                 elif callable(program_result_source):
                     program_result = program_result_source(*args, **kwargs, **tune_params)
                 else:
@@ -113,7 +113,12 @@ class LibraryGenerator(object):
             src = tempfile.NamedTemporaryFile(mode="w", suffix=".cpp", delete=False)
             libpath = src.name.replace(".cpp", ".so")
 
-            command = [get_cplus_compiler(), "-std=c++17", "-fPIC", "-shared", src.name]
+            # -pthread: parallel grids run their workers on tl::cpu::parallel_for
+            # -O3: the tile loops and gemm templates rely on the host compiler to vectorize
+            command = [
+                get_cplus_compiler(), "-std=c++17", "-O3", "-fPIC", "-shared", "-pthread",
+                src.name
+            ]
             command += [
                 "-I" + TILELANG_TEMPLATE_PATH,
             ]
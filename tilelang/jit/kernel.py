@@ -9,7 +9,7 @@ from tilelang.engine.param import CompiledArtifact, KernelParam
 from tilelang.jit.adapter import (BaseKernelAdapter, CtypesKernelAdapter, CythonKernelAdapter,
                                   NVRTCKernelAdapter, TorchDLPackKernelAdapter)
 from tilelang.profiler import Profiler, TensorSupplyType
-from tilelang.utils.target import AVALIABLE_TARGETS, determine_target
+from tilelang.utils.target import determine_target
 
 
 class JITKernel(object):
@@ -85,7 +85,6 @@ class JITKernel(object):
 
         # If the target is specified as a string, validate it and convert it to a TVM Target.
         if isinstance(target, str):
-            assert target in AVALIABLE_TARGETS, f"Invalid target: {target}"
             target = determine_target(target)
 
         # Ensure the target is always a TVM Target object.
@@ -203,6 +202,7 @@ class JITKernel(object):
                 target_host=target_host,
                 enable_host_codegen=enable_host_codegen,
                 enable_device_compile=enable_device_compile)
+        artifact.check_outputs(out_idx)
 
         self.artifact = artifact
 
@@ -0,0 +1,102 @@
+"""Parse-once program cache for tuning sweeps.
+
+Autotuning calls the user's program factory once per configuration, and every
+call runs the TVMScript parser over the whole kernel. When the tuned values
+are only used as TIR values (tile sizes in buffer shapes, loop extents and
+index arithmetic), the factory can instead be called once with symbolic
+placeholders and each configuration derived from that parse by binding the
+placeholders to constants.
+
+Parameters that the program inspects at Python level (``if block_M > 64:``
+in the factory, ``num_stages`` of ``T.Pipelined``, ``threads`` of
+``T.Kernel``) cannot be placeholders: the symbolic parse fails and the cache
+falls back to parsing every configuration, so listing them is safe but gains
+nothing.
+"""
+
+import threading
+from logging import getLogger
+from typing import Any, Callable, Dict, Optional, Sequence, Tuple
+
+from tilelang import tvm as tvm
+from tvm import tir
+from tvm.tir import PrimFunc
+from tilelang.transform import BindSymbolicParams
+
+logger = getLogger(__name__)
+
+# Parsed program and its placeholder variables, or None if the factory
+# cannot be parsed symbolically.
+_Template = Optional[Tuple[PrimFunc, Dict[str, tir.Var]]]
+
+
+def _is_int(value: Any) -> bool:
+    return isinstance(value, int) and not isinstance(value, bool)
+
+
+class SymbolicProgramCache:
+    """Produce the programs of a factory, parsing once per non-symbolic key.
+
+    Parameters
+    ----------
+    program_factory : Callable[..., PrimFunc]
+        The function returning the TileLang program.
+    symbolic_params : Sequence[str]
+        Keyword arguments of the factory that are parsed as placeholders.
+        Only integer values are bound; any other value is passed through
+        and becomes part of the cache key.
+    """
+
+    def __init__(self, program_factory: Callable[..., PrimFunc], symbolic_params: Sequence[str]):
+        self.program_factory = program_factory
+        self.symbolic_params = tuple(symbolic_params)
+        self.num_parses = 0
+        self._templates: Dict[tuple, _Template] = {}
+        self._lock = threading.Lock()
+
+    def __call__(self, *args, **kwargs) -> PrimFunc:
+        symbolic = {
+            name: kwargs.pop(name)
+            for name in self.symbolic_params
+            if name in kwargs and _is_int(kwargs[name])
+        }
+        if not symbolic:
+            return self._parse(*args, **kwargs)
+
+        key = (args, tuple(sorted(kwargs.items())), tuple(sorted(symbolic)))
+        try:
+            hash(key)
+        except TypeError:
+            # Unhashable arguments (lists, tensors...) cannot key a template
+            return self._parse(*args, **kwargs, **symbolic)
+        with self._lock:
+            if key not in self._templates:
+                self._templates[key] = self._parse_template(args, kwargs, symbolic)
+            template = self._templates[key]
+
+        if template is None:
+            return self._parse(*args, **kwargs, **symbolic)
+
+        func, placeholders = template
+        values = {
+            placeholders[name]: tir.IntImm(placeholders[name].dtype, value)
+            for name, value in symbolic.items()
+        }
+        mod = BindSymbolicParams(values)(tvm.IRModule({"main": func}))
+        return mod["main"]
+
+    def _parse(self, *args, **kwargs) -> PrimFunc:
+        self.num_parses += 1
+        return self.program_factory(*args, **kwargs)
+
+    def _parse_template(self, args, kwargs, symbolic: Dict[str, int]) -> _Template:
+        placeholders = {name: tir.Var(name, "int32") for name in symbolic}
+        try:
+            func = self._parse(*args, **kwargs, **placeholders)
+        except Exception as e:  # noqa: BLE001
+            logger.debug(f"Symbolic parse of {list(symbolic)} failed, "
+                         f"parsing every configuration instead: {e}")
+            return None
+        if not isinstance(func, PrimFunc):
+            return None
+        return func, placeholders
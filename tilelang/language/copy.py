@@ -115,9 +115,14 @@ def copy(
     src_extent = get_extent(src)
     dst_extent = get_extent(dst)
     assert src_extent or dst_extent, "Can't deduce copy extents from args"
-    src_extent = list(src_extent) if src_extent else [1] * len(dst_extent)
-    dst_extent = list(dst_extent) if dst_extent else [1] * len(src_extent)
-    extent = max(src_extent, dst_extent)
+    # Take the side whose extent is known without ordering the extents, which
+    # may be symbolic
+    if not src_extent:
+        extent = list(dst_extent)
+    elif not dst_extent:
+        extent = list(src_extent)
+    else:
+        extent = max(list(src_extent), list(dst_extent))
 
     def _to_region(data, access_type):
         if isinstance(data, tir.Var) and T.has_let_value(data):
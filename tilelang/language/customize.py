@@ -47,6 +47,9 @@ def atomic_addx4(dst: Buffer, value: PrimExpr) -> PrimExpr:
 def dp4a(A: Buffer, B: Buffer, C: Buffer) -> PrimExpr:
     """Perform a 4-element dot product with accumulation (DP4A).
 
+    Lowers to `__dp4a` on CUDA and to the widening 8-bit dot product shared
+    with the int8 CPU gemm kernels on CPU.
+
     Args:
         A (Buffer): First input buffer
         B (Buffer): Second input buffer
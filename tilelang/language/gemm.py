@@ -6,6 +6,62 @@ from tvm import tir
 from typing import Union, List
 
 
+def legalize_arguments(arg: Union[tir.Buffer, tir.Var]):
+    """Convert let-bound variables to their corresponding buffers.
+
+    Args:
+        arg (Union[tir.Buffer, tir.Var]): Input argument to legalize
+
+    Returns:
+        Union[tir.Buffer, tir.Var]: The legalized argument
+    """
+    if isinstance(arg, tir.Var) and T.has_let_value(arg):
+        return T.get_let_value(arg).buffer
+    return arg
+
+
+def retrieve_shape(object: Union[tir.Buffer, tir.BufferRegion]) -> List[int]:
+    if isinstance(object, tir.Buffer):
+        return object.shape
+    elif isinstance(object, tir.BufferRegion):
+        region = object.region
+        shape = []
+        for r in region:
+            shape.append(r.extent)
+        return shape
+    else:
+        raise ValueError(f"Unsupported argument type: {type(object)} for buffer {object}")
+
+
+def retrieve_ptr(object: Union[tir.Buffer, tir.BufferRegion, tir.BufferLoad],
+                 access_type: str = "r") -> tir.PrimExpr:
+    if isinstance(object, tir.Buffer):
+        return object.access_ptr(access_type)
+    elif isinstance(object, tir.BufferRegion):
+        buffer, region = object.buffer, object.region
+        indices = []
+        for r in region:
+            indices.append(r.min)
+        strides = []
+        stride = 1
+        for s in reversed(buffer.shape):
+            strides.insert(0, stride)
+            stride *= s
+        offset = 0
+        for i in range(len(indices)):
+            offset += indices[i] * strides[i]
+        return buffer.access_ptr(access_mask=access_type, offset=offset)
+    elif isinstance(object, tir.BufferLoad):
+        return T.address_of(object)
+    else:
+        raise ValueError(f"Unsupported argument type: {type(object)} for buffer {object}")
+
+
+def retrieve_stride(object: Union[tir.Buffer, tir.BufferRegion, tir.BufferLoad]) -> int:
+    buffer = object if isinstance(object, tir.Buffer) else object.buffer
+    return int(buffer.shape[-1])
+
+
 def gemm(
     A: Union[tir.Buffer, tir.Var],
     B: Union[tir.Buffer, tir.Var],
@@ -40,35 +96,10 @@ def gemm(
         AssertionError: If the K dimensions of matrices A and B don't match
     """
 
-    def legalize_arguments(arg: Union[tir.Buffer, tir.Var]):
-        """Convert let-bound variables to their corresponding buffers.
-
-        Args:
-            arg (Union[tir.Buffer, tir.Var]): Input argument to legalize
-
-        Returns:
-            Union[tir.Buffer, tir.Var]: The legalized argument
-        """
-        if isinstance(arg, tir.Var) and T.has_let_value(arg):
-            return T.get_let_value(arg).buffer
-        return arg
-
     A = legalize_arguments(A)
     B = legalize_arguments(B)
     C = legalize_arguments(C)
 
-    def retrieve_shape(object: Union[tir.Buffer, tir.BufferRegion]) -> List[int]:
-        if isinstance(object, tir.Buffer):
-            return object.shape
-        elif isinstance(object, tir.BufferRegion):
-            region = object.region
-            shape = []
-            for r in region:
-                shape.append(r.extent)
-            return shape
-        else:
-            raise ValueError(f"Unsupported argument type: {type(object)} for buffer {object}")
-
     A_shape = retrieve_shape(A)
     B_shape = retrieve_shape(B)
     C_shape = retrieve_shape(C)
@@ -90,27 +121,6 @@ def gemm(
     K_B = B_shape[-1] if transpose_B else B_shape[-2]
     assert K == K_B, f"T.gemm K shape check failed: K_A = {K}, K_B = {K_B}"
 
-    def retrieve_ptr(object: Union[tir.Buffer, tir.BufferRegion],
-                     access_type: str = "r") -> tir.PrimExpr:
-        if isinstance(object, tir.Buffer):
-            return object.access_ptr(access_type)
-        elif isinstance(object, tir.BufferRegion):
-            buffer, region = object.buffer, object.region
-            indices = []
-            for r in region:
-                indices.append(r.min)
-            strides = []
-            stride = 1
-            for s in reversed(buffer.shape):
-                strides.insert(0, stride)
-                stride *= s
-            offset = 0
-            for i in range(len(indices)):
-                offset += indices[i] * strides[i]
-            return buffer.access_ptr(access_mask=access_type, offset=offset)
-        else:
-            raise ValueError(f"Unsupported argument type: {type(object)} for buffer {object}")
-
     Aptr = retrieve_ptr(A, "r")
     Bptr = retrieve_ptr(B, "r")
     Cptr = retrieve_ptr(C, "rw")
@@ -130,3 +140,67 @@ def gemm(
         k_pack,
         wg_wait,
     )
+
+
+def gemm_dequant(
+    A: Union[tir.Buffer, tir.Var],
+    B: Union[tir.Buffer, tir.BufferRegion, tir.BufferLoad],
+    C: Union[tir.Buffer, tir.Var],
+    decoder,
+    scale: Union[tir.Buffer, tir.BufferRegion, tir.BufferLoad, None] = None,
+    zeros: Union[tir.Buffer, tir.BufferRegion, tir.BufferLoad, None] = None,
+    transpose_A: bool = False,
+    clear_accum: bool = False,
+):
+    """Weight-only quantised GEMM on CPU, C = A @ dequant(B)^T.
+
+    B points at the first row and byte of an N x K tile of weights compressed
+    by `tilelang.quantize.general_compress`, which are decoded by `decoder`
+    while the B panel is packed instead of through a separate float tile.
+    Scales and zeros of shape [N, K / group_size] point at the group of the
+    first row and k of the tile, so group_size and the K tile must divide one
+    another. int8 activations with an int32 accumulator run on the int8
+    dot-product kernels and take unscaled integer weights. A table lookup
+    decoder (`ternary_decoder(lut=True)`) takes weights packed by
+    `compress_ternary_lut` instead, with B at the tile's first block of rows.
+
+    Args:
+        A (Union[tir.Buffer, tir.Var]): Activation tile
+        B (Union[tir.Buffer, tir.BufferRegion, tir.BufferLoad]): Compressed weight tile
+        C (Union[tir.Buffer, tir.Var]): Output tile
+        decoder (tilelang.quantize.Decoder): Decoder of the weight fields
+        scale (optional): Per-group scales. Defaults to None.
+        zeros (optional): Per-group zeros, requires scales. Defaults to None.
+        transpose_A (bool, optional): Whether to transpose A. Defaults to False.
+        clear_accum (bool, optional): Whether to clear C before accumulating. Defaults to False.
+
+    Returns:
+        tir.Call: A handle to the GEMM operation
+    """
+    A = legalize_arguments(A)
+    C = legalize_arguments(C)
+    assert (scale is not None) == decoder.with_scaling, "scales must match the decoder"
+    assert (zeros is not None) == decoder.with_zeros, "zeros must match the decoder"
+
+    A_shape = retrieve_shape(A)
+    M, N = (int(extent) for extent in retrieve_shape(C))
+    K = int(A_shape[-2] if transpose_A else A_shape[-1])
+    group_size = decoder.group_size if decoder.group_size > 0 else K
+    assert K % group_size == 0 or group_size % K == 0, \
+        f"T.gemm_dequant needs group_size {group_size} and K tile {K} to divide one another"
+    lds = retrieve_stride(scale) if scale is not None else 0
+    ldb = retrieve_stride(B)
+    if decoder.lut:
+        # [N / 32, K / 2, 16] blocks of index pairs, B addresses the first one.
+        assert N % 32 == 0 and not transpose_A, \
+            "table lookup GEMV needs 32-row tiles and a row-major A"
+        B_buffer = B if isinstance(B, tir.Buffer) else B.buffer
+        ldb = int(B_buffer.shape[-2]) * ldb
+
+    template = (f"tl::gemm_cpu_dequant<{M}, {N}, {K}, {str(transpose_A).lower()}, "
+                f"{str(clear_accum).lower()}, {retrieve_stride(A)}, {ldb}, "
+                f"{retrieve_stride(C)}, {decoder.cpp_functor}, {group_size}, {lds}>")
+    args = [retrieve_ptr(A, "r"), retrieve_ptr(B, "r")]
+    args += [retrieve_ptr(buffer, "r") for buffer in (scale, zeros) if buffer is not None]
+    args.append(retrieve_ptr(C, "rw"))
+    return T.call_extern("handle", template, *args)
@@ -94,8 +94,10 @@ class KernelLaunchFrame(TIRFrame):
         maybe_cpu = last_block_frame.annotations.get("tilelang.is_cpu_kernel_frame", False)
 
         if maybe_cpu:
-            # CPU kernel frame, return a list of for frame items.
-            return [frame.vars[0] for frame in self.frames[0:-1]]
+            # CPU kernel frame, return a list of for frame items,
+            # or the single loop var for a one dimensional grid.
+            loop_vars = [frame.vars[0] for frame in self.frames[0:-1]]
+            return loop_vars[0] if len(loop_vars) == 1 else loop_vars
         else:
             # Otherwise, return a list of iter_var.var objects (excluding the last 4 frames).
             # As 4 frames for threadIdx.x, threadIdx.y, threadIdx.z and block frame with attributes
@@ -211,6 +213,7 @@ def Kernel(
     threads: Optional[Union[int, List[int], Tuple]] = None,
     is_cpu: bool = False,
     prelude: Optional[str] = None,
+    parallel: bool = False,
 ):
     """Tools to quickly construct a GPU kernel launch frame.
 
@@ -229,6 +232,10 @@ def Kernel(
     prelude : str
         The import c code of the kernel,
         will be injected before the generated kernel code.
+    parallel : bool
+        Only valid for CPU kernels. Run the iterations of the first grid
+        dimension as workers on the host thread pool instead of a serial loop,
+        the number of host threads can be set with TL_NUM_THREADS.
 
     Returns
     -------
@@ -251,6 +258,10 @@ def Kernel(
 
     if is_cpu:
         attrs["tilelang.is_cpu_kernel_frame"] = True
+        if parallel:
+            attrs["tilelang.cpu_worker_loop"] = True
+    else:
+        assert not parallel, "parallel is only supported for CPU kernels"
 
     if prelude is not None:
         attrs["pragma_import_c"] = prelude
@@ -1,27 +1,101 @@
 """The language interface for tl programs."""
 
-from typing import List, Optional
+from typing import List, Optional, Union
 from tvm import tir
 from tilelang import _ffi_api
 
+_TILE_ORDERS = ("row", "column", "swizzle")
+
+
+def _counter_ptr(counter: Optional[Union[tir.Buffer, tir.PrimExpr]]) -> Optional[tir.PrimExpr]:
+    if counter is None:
+        return None
+    if isinstance(counter, tir.Buffer):
+        assert counter.dtype == "int32", "the tile counter must be an int32 buffer"
+        return tir.call_intrin("handle", "tir.address_of", counter[0])
+    return counter
+
 
 def Persistent(
     domain: List[tir.PrimExpr],
     wave_size: tir.PrimExpr,
     index: tir.PrimExpr,
     group_size: Optional[tir.PrimExpr] = 8,
+    order: str = "swizzle",
+    counter: Optional[Union[tir.Buffer, tir.PrimExpr]] = None,
 ):
     """Tools to construct persistent for loop.
 
+    Every worker (a thread block on GPU, a host thread on CPU) walks the tiles
+    of ``domain`` and binds the coordinates of the current tile to the loop
+    variables.
+
+    Parameters
+    ----------
+    domain : List[tir.PrimExpr]
+        The list of dominators.
+    wave_size : int
+        The wave size, i.e. the number of workers.
+    index : int
+        The tile index in one wave, i.e. the id of the worker.
+    group_size : tir.PrimExpr
+        The group size of the "swizzle" order.
+    order : str
+        The tile order, one of "row" (last dimension fastest), "column"
+        (first dimension fastest) and "swizzle" (last dimension walked in
+        panels of ``group_size`` tiles for L2 locality).
+    counter : Optional[Union[tir.Buffer, tir.PrimExpr]]
+        A zero-initialized int32 buffer (or a pointer to one element of it)
+        used as a global work counter. When given, workers pull tile ids
+        dynamically instead of using the static ``index + k * wave_size``
+        schedule, which balances irregular workloads. The counter has to be
+        reset before every launch.
+    """
+    assert order in _TILE_ORDERS, f"order must be one of {_TILE_ORDERS}, got {order}"
+    return _ffi_api.Persistent(domain, wave_size, index, group_size, order,
+                               _counter_ptr(counter))
+
+
+def StreamK(
+    domain: List[tir.PrimExpr],
+    iters_per_tile: tir.PrimExpr,
+    wave_size: tir.PrimExpr,
+    index: tir.PrimExpr,
+    group_size: Optional[tir.PrimExpr] = 8,
+    order: str = "row",
+):
+    """Tools to construct a stream-K persistent for loop.
+
+    The flattened (tile, reduction iteration) space is split evenly among the
+    ``wave_size`` workers. The loop yields the tile coordinates followed by the
+    ``[k_begin, k_end)`` slice of the tile's reduction iterations handled by the
+    worker, tiles that are only partially covered (``k_begin != 0`` or
+    ``k_end != iters_per_tile``) have to be combined by the caller, e.g. with
+    ``T.atomic_add``.
+
+    Example
+    -------
+    .. code-block:: python
+
+        for bx, by, k_begin, k_end in T.StreamK([m_blocks, n_blocks], k_iters, num_sms, pid):
+            T.clear(C_local)
+            for k in T.Pipelined(k_end - k_begin, num_stages=2):
+                ...
+
     Parameters
     ----------
     domain : List[tir.PrimExpr]
         The list of dominators.
+    iters_per_tile : tir.PrimExpr
+        The number of reduction iterations of every tile.
     wave_size : int
-        The wave size.
+        The number of workers.
     index : int
-        The tile index in one wave.
+        The id of the worker.
     group_size : tir.PrimExpr
-        The group size.
+        The group size of the "swizzle" order.
+    order : str
+        The tile order, see :func:`Persistent`.
     """
-    return _ffi_api.Persistent(domain, wave_size, index, group_size)
+    assert order in _TILE_ORDERS, f"order must be one of {_TILE_ORDERS}, got {order}"
+    return _ffi_api.StreamK(domain, iters_per_tile, wave_size, index, group_size, order)
@@ -10,7 +10,16 @@ from .quantization import (
 from .utils import (
     gen_quant4,  # noqa: F401
     general_compress,  # noqa: F401
+    compress_ternary_lut,  # noqa: F401
     interleave_weight,  # noqa: F401
 )
 
 from .lop3 import get_lop3_intrin_group  # noqa: F401
+
+from .decoder import (
+    Decoder,  # noqa: F401
+    uint_decoder,  # noqa: F401
+    int_decoder,  # noqa: F401
+    ternary_decoder,  # noqa: F401
+    fp4_decoder,  # noqa: F401
+)
@@ -0,0 +1,112 @@
+"""Weight decoders for quantised gemm on CPU.
+
+A decoder describes how one low-bit field of weights compressed by
+`general_compress` turns into its value, and names the functor of
+tl_templates/cpp/gemm_dequant.h that `T.gemm_dequant` decodes with while
+packing the B panel.
+"""
+
+from dataclasses import dataclass
+
+
+@dataclass(frozen=True)
+class Decoder:
+    kind: str  # uint, int, offset, ternary, ternary_lut or fp4
+    num_bits: int
+    with_scaling: bool = False
+    with_zeros: bool = False
+    group_size: int = -1
+
+    def __post_init__(self):
+        assert 8 % self.num_bits == 0, "fields may not straddle bytes"
+        assert self.kind != "ternary_lut" or not self.with_scaling, \
+            "table lookup GEMV takes unscaled weights"
+        assert not self.with_zeros or self.with_scaling, "zeros come with scales"
+        assert self.group_size == -1 or self.group_size > 0
+
+    @property
+    def elems_per_byte(self) -> int:
+        return 8 // self.num_bits
+
+    @property
+    def integral(self) -> bool:
+        return self.kind != "fp4"
+
+    @property
+    def lut(self) -> bool:
+        """Whether weights are looked up in activation tables, packed by
+        `compress_ternary_lut` rather than `general_compress`."""
+        return self.kind == "ternary_lut"
+
+    @property
+    def cpp_functor(self) -> str:
+        if self.kind == "ternary_lut":
+            return "tl::cpu::decode::TernaryLUT"
+        if self.kind == "ternary":
+            return "tl::cpu::decode::Ternary"
+        if self.kind == "fp4":
+            return "tl::cpu::decode::FP4"
+        name = {"uint": "UInt", "int": "Int", "offset": "Offset"}[self.kind]
+        return f"tl::cpu::decode::{name}<{self.num_bits}>"
+
+    def compress(self, weight):
+        """Pack the field values (the ternary weights for the table lookup
+        GEMV) of a torch tensor [N, K] as the CPU kernels read them."""
+        from .utils import compress_ternary_lut, general_compress
+        if self.lut:
+            return compress_ternary_lut(weight)
+        return general_compress(weight, source_bits=self.num_bits)
+
+    def unpack(self, packed):
+        """Reference decode of a compressed torch tensor [..., K / elems_per_byte]
+        into the float32 field values [..., K], before scales and zeros."""
+        import torch
+        if self.lut:
+            index = packed.view(torch.uint8).to(torch.int32).permute(0, 2, 1)
+            index = torch.stack([index & 15, index >> 4], dim=1).flatten(0, 2)
+            return torch.stack([index // 3 - 1, index % 3 - 1], dim=-1).flatten(-2).float()
+        shifts = torch.arange(self.elems_per_byte, device=packed.device) * self.num_bits
+        q = (packed.to(torch.int32).unsqueeze(-1) & 0xFF) >> shifts
+        q = (q & ((1 << self.num_bits) - 1)).flatten(-2)
+        if self.kind == "int":
+            q = q - ((q >> (self.num_bits - 1)) << self.num_bits)
+        elif self.kind == "offset":
+            q = q - (1 << (self.num_bits - 1))
+        elif self.kind == "ternary":
+            q = q - 1
+        elif self.kind == "fp4":
+            e = q & 7
+            magnitude = torch.where(e == 0, torch.zeros_like(e, dtype=torch.float32),
+                                    torch.exp2(e.float() - 7))
+            return torch.where(q >= 8, -magnitude, magnitude)
+        return q.float()
+
+
+def uint_decoder(num_bits: int, with_scaling=False, with_zeros=False, group_size=-1) -> Decoder:
+    """Unsigned fields, w = (q - zero) * scale."""
+    return Decoder("uint", num_bits, with_scaling, with_zeros, group_size)
+
+
+def int_decoder(num_bits: int,
+                offset: bool = False,
+                with_scaling=False,
+                with_zeros=False,
+                group_size=-1) -> Decoder:
+    """Signed fields in two's complement, or unsigned fields biased by
+    2^(num_bits - 1) as `_tir_packed_to_signed_convert` reads them."""
+    return Decoder("offset" if offset else "int", num_bits, with_scaling, with_zeros, group_size)
+
+
+def ternary_decoder(with_scaling=False, group_size=-1, lut=False) -> Decoder:
+    """BitNet 1.58 weights {-1, 0, 1} stored as 2-bit {0, 1, 2}.
+
+    With `lut`, int8 activations x ternary weights run as a table lookup GEMV
+    instead: sums of activation pairs are tabulated and indexed by the packed
+    weight pairs with byte shuffles, see tl_templates/cpp/gemv_lut.h.
+    """
+    return Decoder("ternary_lut" if lut else "ternary", 2, with_scaling, False, group_size)
+
+
+def fp4_decoder(with_scaling=False, group_size=-1) -> Decoder:
+    """s1e3 fields as `_tir_packed_to_fp4_to_f16` reads them."""
+    return Decoder("fp4", 4, with_scaling, False, group_size)
@@ -65,6 +65,23 @@ def general_compress(lowprecision_weight, source_bits=4, storage_dtype=None):
     return int8_weight.to(storage_dtype)
 
 
+def compress_ternary_lut(ternary_weight):
+    """Pack ternary weights [N, K] in {-1, 0, 1} for the table lookup GEMV.
+
+    Pairs of weights become the 4-bit index (w0 + 1) * 3 + (w1 + 1). Rows are
+    grouped in blocks of 32, stored as [N / 32, K / 2, 16] bytes whose byte b
+    holds the index of row b in the low and of row b + 16 in the high nibble.
+    """
+    import torch
+    N, K = ternary_weight.shape
+    assert N % 32 == 0 and K % 2 == 0
+    w = ternary_weight.to(torch.int32)
+    index = (w[:, 0::2] + 1) * 3 + (w[:, 1::2] + 1)
+    index = index.reshape(N // 32, 2, 16, K // 2)
+    packed = index[:, 0] | (index[:, 1] << 4)
+    return packed.permute(0, 2, 1).contiguous().to(torch.uint8).view(torch.int8)
+
+
 # interleave weight numpy implementation
 def interleave_weight(qweight, nbits=4, target_dtype="float16"):
     """Interleave the weight to the target data type.
@@ -4,6 +4,7 @@ import pytest
 import random
 import torch
 import numpy as np
+from tilelang import tvm
 from tilelang.contrib import nvcc
 from tvm.testing.utils import *
 from tvm.testing.utils import _compose
@@ -102,3 +103,34 @@ def requires_cuda_compute_version_gt(major_version, minor_version=0):
 
 def requires_cuda_compute_version_eq(major_version, minor_version=0):
     return requires_cuda_compute_version(major_version, minor_version, mode="eq")
+
+
+def run_transform(func, transform, target=None, config=None, prepare=()):
+    """Run `transform` on `func` as the main function of a module.
+
+    The `prepare` passes run first, outside of the PassContext holding `config`.
+    Returns the main function before and after `transform`.
+    """
+    func = func.with_attr("global_symbol", "main")
+    if target is not None:
+        func = func.with_attr("target", tvm.target.Target(target))
+    mod = tvm.IRModule.from_expr(func)
+    for prepare_pass in prepare:
+        mod = prepare_pass(mod)
+    with tvm.transform.PassContext(config=config or {}):
+        transformed = transform(mod)
+    return mod["main"], transformed["main"]
+
+
+def assert_transform_untouched(func, transform, **kwargs):
+    """Assert that `transform` leaves the body of `func` as is, see `run_transform`."""
+    before, after = run_transform(func, transform, **kwargs)
+    tvm.ir.assert_structural_equal(after.body, before.body)
+
+
+def collect(node, cls):
+    """The nodes of type `cls` under `node`, in post order."""
+    nodes = []
+    tvm.tir.stmt_functor.post_order_visit(
+        node, lambda n: nodes.append(n) if isinstance(n, cls) else None)
+    return nodes
@@ -79,6 +79,149 @@ def FrontendLegalize():
     return _ffi_api.FrontendLegalize()  # type: ignore
 
 
+def ForwardStagingBuffers():
+    """Hoist loop invariant global to shared copies out of serial loops and,
+    with tl.enable_fragment_forwarding, feed fragments staged through shared
+    memory directly to the gemm that reads them (lowering it to gemm_rs).
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.ForwardStagingBuffers()  # type: ignore
+
+
+def BindSymbolicParams(values):
+    """Bind symbolic tile parameters of a parsed program to constants.
+
+    Buffer shapes, regions and expressions that depend on the parameters are
+    rewritten and folded, as if the program had been parsed with the values.
+
+    Parameters
+    ----------
+    values : Dict[tvm.tir.Var, tvm.tir.PrimExpr]
+        The value bound to each parameter.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.BindSymbolicParams(values)  # type: ignore
+
+
+def DecomposeKLoop():
+    """Split the K loop of GEMM kernels across blocks (split-K) or stream-K
+    workers, as configured by ``tl.split_k`` / ``tl.stream_k_workers``.
+
+    Partial results are reduced with atomics, so the output of a rewritten
+    kernel must be zero-initialized. Kernels whose epilogue is not a plain
+    store of the accumulator are left untouched.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.DecomposeKLoop()  # type: ignore
+
+
+def OptimizeCPULoopNest():
+    """Interchange the perfectly nested serial loops of CPU kernels so the
+    innermost loop walks memory with unit stride, and unroll-and-jam
+    reductions into register blocks sized to the target's vector registers.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.OptimizeCPULoopNest()  # type: ignore
+
+
+def RegisterPromotion():
+    """Promote the elements, or small boxes of elements, of local buffers that
+    a serial loop reads and writes at loop invariant offsets to a private
+    register buffer, loaded before the loop and stored back after it.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.RegisterPromotion()  # type: ignore
+
+
+def StrengthReduceIndex():
+    """Split the affine indices of flattened buffer accesses into the loop
+    variable times its stride and an invariant base bound before the loop,
+    sharing bases between accesses that differ by a constant. Applies to the
+    cuda, hip and c targets.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.StrengthReduceIndex()  # type: ignore
+
+
+def SLPVectorize():
+    """Pack runs of adjacent scalar stores to consecutive elements, left by
+    loop unrolling, whose values have the same shape into vector loads,
+    arithmetic and stores of up to 128 bits. Applies to the cuda, hip and c
+    targets.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.SLPVectorize()  # type: ignore
+
+
+def LoopInvariantCodeMotion():
+    """Hoist the loads and predicates that every iteration of a serial loop
+    evaluates to the same value out of the loop. A load is hoisted when its
+    buffer is neither written nor passed by address in the loop, and, for
+    shared memory, when the loop has no barriers or opaque calls.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.LoopInvariantCodeMotion()  # type: ignore
+
+
+def CostBasedUnroll():
+    """Unroll the per-thread loops of parallel loops fully, partially (CPU
+    targets only) or not at all, by estimating the instructions and registers
+    of an iteration against the budget of the target. The decisions are
+    recorded in the tl.unroll_decisions attribute of the function.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.CostBasedUnroll()  # type: ignore
+
+
+def EliminateDeadTileWrites():
+    """Drop fills and copies into shared and fragment buffers that a later
+    tile op overwrites before anything reads them, and fold a clear ahead of
+    an accumulating gemm into the gemm's clear_accum flag.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.EliminateDeadTileWrites()  # type: ignore
+
+
 def LowerHopperIntrin():
     """LowerHopperIntrin
 
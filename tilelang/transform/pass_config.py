@@ -15,6 +15,42 @@ class PassConfigKey(str, Enum):
     TL_DISABLE_DYNAMIC_TAIL_SPLIT = "tl.disable_dynamic_tail_split"
     """Disable dynamic tail splitting optimization. Default: False"""
 
+    TL_DISABLE_MASKED_VECTORIZE = "tl.disable_masked_vectorize"
+    """Scalarize vectorized statements guarded by lane dependent conditions
+    instead of running them as full vectors with a masked (LLVM) or lane by
+    lane tail. Default: False"""
+
+    TL_DISABLE_LOOP_NEST_OPTIMIZE = "tl.disable_loop_nest_optimize"
+    """Keep the serial loop nests of CPU kernels in source order instead of
+    interchanging them for unit-stride access and register tiling reductions.
+    Default: False"""
+
+    TL_DISABLE_REGISTER_PROMOTION = "tl.disable_register_promotion"
+    """Keep loop invariant elements of local buffers in memory instead of
+    promoting them to registers across the loops that accumulate into them.
+    Default: False"""
+
+    TL_DISABLE_STRENGTH_REDUCTION = "tl.disable_strength_reduction"
+    """Recompute flattened buffer indices in every loop iteration instead of
+    hoisting their loop invariant part into shared bases. Default: False"""
+
+    TL_DISABLE_SLP_VECTORIZE = "tl.disable_slp_vectorize"
+    """Keep the runs of isomorphic scalar statements left by loop unrolling
+    scalar instead of packing them into vector loads, arithmetic and stores.
+    Default: False"""
+
+    TL_DISABLE_LOOP_INVARIANT_CODE_MOTION = "tl.disable_loop_invariant_code_motion"
+    """Keep loop invariant loads and predicates inside pipelined and inner
+    loops instead of hoisting them before the loop. Default: False"""
+
+    TL_DISABLE_DEAD_TILE_WRITE_ELIMINATION = "tl.disable_dead_tile_write_elimination"
+    """Keep fills and copies of shared and fragment buffers that are overwritten
+    before being read, and clears ahead of accumulating gemms. Default: False"""
+
+    TL_DISABLE_COST_BASED_UNROLL = "tl.disable_cost_based_unroll"
+    """Leave the per-thread loops of parallel loops to the unroll pragma of the
+    device compiler instead of unrolling them by cost. Default: False"""
+
     TL_DISABLE_WARP_SPECIALIZED = "tl.disable_warp_specialized"
     """Disable warp specialization optimization. Default: False"""
 
@@ -39,6 +75,27 @@ class PassConfigKey(str, Enum):
     TL_ENABLE_AGGRESSIVE_SHARED_MEMORY_MERGE = "tl.enable_aggressive_shared_memory_merge"
     """Enable aggressive merge of shared memory allocations. Default: False"""
 
+    TL_DISABLE_STAGING_FORWARDING = "tl.disable_staging_forwarding"
+    """Keep fragment -> shared copies feeding a gemm and loop invariant global
+    -> shared copies as written. Default: False"""
+
+    TL_ENABLE_FRAGMENT_FORWARDING = "tl.enable_fragment_forwarding"
+    """Feed a fragment staged through shared memory directly to the gemm that
+    reads it as its A operand (gemm_rs). The fragment must already have a
+    layout compatible with the gemm operand. Default: False"""
+
+    TL_SPLIT_K = "tl.split_k"
+    """Split the K loop of GEMM kernels across this many blocks, reducing
+    partial results with atomics into a zero-initialized output. Default: 1"""
+
+    TL_STREAM_K_WORKERS = "tl.stream_k_workers"
+    """Run GEMM kernels as this many stream-K workers, reducing partial tiles
+    with atomics into a zero-initialized output. Default: 0 (disabled)"""
+
+    TL_REGISTER_BUDGET = "tl.register_budget"
+    """Registers per thread layout inference may spend on fragments before it
+    falls back to less replicated layouts. Default: derived from the target"""
+
     # TIR related configs
     TIR_ENABLE_EQUIV_TERMS_IN_CSE = "tir.enable_equiv_terms_in_cse_tir"
     """Enable equivalent terms in TIR Common Subexpression Elimination. Default: True"""
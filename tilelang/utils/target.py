@@ -48,7 +48,8 @@ def determine_target(target: Union[str, Target, Literal["auto"]] = "auto",
     Args:
         target (Union[str, Target, Literal["auto"]]): User-specified target.
             - If "auto", the system will automatically detect whether CUDA or HIP is available.
-            - If a string or Target, it is directly validated.
+            - If a string or Target, it is directly validated. Strings may carry target
+              options, e.g. "cuda -arch=sm_90".
 
     Returns:
         Union[str, Target]: The selected target ("cuda", "hip", or a valid Target object).
@@ -72,6 +73,11 @@ def determine_target(target: Union[str, Target, Literal["auto"]] = "auto",
             return_var = "hip"
         else:
             raise ValueError("No CUDA or HIP available on this system.")
+    elif isinstance(target, str) and target not in AVALIABLE_TARGETS:
+        # A target string with options such as "cuda -arch=sm_90" names the device
+        # explicitly, so no GPU is needed (see tilelang.cache.cross_compile)
+        assert Target(target).kind.name in AVALIABLE_TARGETS, f"Target {target} is not supported"
+        return_var = target
     else:
         # Validate the target if it's not "auto"
         assert isinstance(